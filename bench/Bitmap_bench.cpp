@@ -0,0 +1,99 @@
+// Bitmap_bench.cpp
+// 对比 Bitmap::findFirstFree 的字级 / SIMD 扫描与原先逐字节 + 逐位的扫描。
+// 位图规模取 32B size-class 子池的块数（约 65000 位），按不同填充率测量单次查找的平均耗时。
+
+#include "gc_malloc/ThreadHeap/Bitmap.hpp"
+#include "gc_malloc/ThreadHeap/MemSubPool.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kCapacity = MemSubPool::kPoolTotalSize / MemSubPool::kMinBlockSize;
+
+// 原实现：先逐字节跳过 0xFF，再逐位检查
+std::size_t legacyFindFirstFree(const unsigned char* buf, std::size_t capacity, std::size_t start_bit) {
+    const auto is_used = [&](std::size_t bit) {
+        return bit >= capacity || (buf[bit / 8] & (1u << (bit % 8))) != 0;
+    };
+
+    std::size_t current_bit = start_bit;
+    const std::size_t required_bytes = (capacity + 7) / 8;
+
+    std::size_t byte_index = current_bit / 8;
+    if (byte_index < required_bytes && current_bit % 8 != 0) {
+        for (std::size_t bit = current_bit % 8; bit < 8; ++bit) {
+            if (current_bit >= capacity) return Bitmap::k_not_found;
+            if (!is_used(current_bit)) return current_bit;
+            current_bit++;
+        }
+        byte_index++;
+    }
+
+    while (byte_index < required_bytes && buf[byte_index] == 0xFF) {
+        byte_index++;
+    }
+
+    if (byte_index < required_bytes) {
+        current_bit = byte_index * 8;
+        for (std::size_t bit = 0; bit < 8; ++bit) {
+            if (current_bit >= capacity) return Bitmap::k_not_found;
+            if (!is_used(current_bit)) return current_bit;
+            current_bit++;
+        }
+    }
+    return Bitmap::k_not_found;
+}
+
+template <typename F>
+double nsPerCall(std::size_t iterations, F&& f) {
+    std::size_t sink = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) sink += f(i);
+    const auto t1 = std::chrono::steady_clock::now();
+
+    // 防止整个循环被优化掉
+    if (sink == 42) std::puts("");
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(iterations);
+}
+
+// 填充方式：前缀填满（子池按顺序分配、从 0 开始扫描的最坏情况）或随机填充
+void runCase(const char* pattern, double fill, bool random_fill) {
+    std::vector<unsigned char> buffer(MemSubPool::kBitMapLength);
+    Bitmap bitmap(kCapacity, buffer.data(), buffer.size());
+
+    const auto used = static_cast<std::size_t>(fill * static_cast<double>(kCapacity));
+    if (random_fill) {
+        std::mt19937_64 rng(12345);
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        for (std::size_t i = 0; i < kCapacity; ++i) {
+            if (dist(rng) < fill) bitmap.markAsUsed(i);
+        }
+    } else {
+        for (std::size_t i = 0; i < used; ++i) bitmap.markAsUsed(i);
+    }
+
+    const std::size_t iterations = 20000;
+    const double legacy = nsPerCall(iterations, [&](std::size_t) {
+        return legacyFindFirstFree(buffer.data(), kCapacity, 0);
+    });
+    const double word = nsPerCall(iterations, [&](std::size_t) {
+        return bitmap.findFirstFree(0);
+    });
+
+    std::printf("%-7s fill=%6.2f%%  legacy=%10.1f ns  word/simd=%8.1f ns  speedup=%6.1fx\n",
+                pattern, fill * 100.0, legacy, word, legacy / word);
+}
+
+} // namespace
+
+int main() {
+    std::printf("bitmap capacity: %zu bits\n", kCapacity);
+    for (double fill : {0.0, 0.5, 0.9, 0.99, 0.9999}) runCase("prefix", fill, false);
+    for (double fill : {0.5, 0.9, 0.99, 0.9999}) runCase("random", fill, true);
+    return 0;
+}
@@ -0,0 +1,70 @@
+// ParallelSweep_bench.cpp
+// 对比单线程清扫（garbageCollect）与并行清扫（garbageCollectParallel）在不同堆规模、线程数下的耗时。
+// 每个中等对象在 ManagedList 中占一个节点，用它把表长精确地撑到目标规模；
+// 只释放 1% 的对象，耗时主要落在判定阶段（逐个读取散布在堆中的节点状态）。
+// 用法：./bench/parallel_sweep_bench [最大节点数，默认 65536]
+
+#include "gc_malloc/ThreadHeap/ThreadHeap.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kObjectSize = 65 * 1024;   // 刚好超过子池上限，走页段路径
+constexpr std::size_t kFreeStride = 100;         // 每 100 个对象释放一个
+constexpr int         kRepeats    = 3;
+
+// threads 为 1 时测单线程清扫；返回 kRepeats 次中最快的一次（毫秒）
+double sweepMillis(std::size_t nodes, std::size_t threads) {
+    double best = 1e30;
+    std::vector<void*> objs(nodes);
+
+    for (int rep = 0; rep < kRepeats; ++rep) {
+        for (auto& p : objs) p = ThreadHeap::allocate(kObjectSize);
+        for (std::size_t i = 0; i < nodes; i += kFreeStride) ThreadHeap::deallocate(objs[i]);
+
+        const auto t0 = std::chrono::steady_clock::now();
+        const std::size_t reclaimed = (threads == 1) ? ThreadHeap::garbageCollect()
+                                                     : ThreadHeap::garbageCollectParallel(threads);
+        const auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+
+        if (reclaimed != (nodes + kFreeStride - 1) / kFreeStride) {
+            std::fprintf(stderr, "unexpected reclaim count %zu\n", reclaimed);
+            std::exit(1);
+        }
+
+        // 清空，准备下一次
+        for (std::size_t i = 0; i < nodes; ++i) {
+            if (i % kFreeStride != 0) ThreadHeap::deallocate(objs[i]);
+        }
+        ThreadHeap::garbageCollect();
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t max_nodes = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 65536;
+
+    // 关闭自动 GC，只测显式清扫
+    ThreadHeap::setGcDebtThreshold(0, 0);
+
+    const std::size_t thread_counts[] = {1, 2, 4, 8, 16};
+    std::printf("%10s", "nodes");
+    for (std::size_t t : thread_counts) std::printf("  %7zu thr", t);
+    std::printf("   (ms, best of %d)\n", kRepeats);
+
+    for (std::size_t nodes = 4096; nodes <= max_nodes; nodes *= 4) {
+        std::printf("%10zu", nodes);
+        for (std::size_t t : thread_counts) std::printf("  %11.3f", sweepMillis(nodes, t));
+        std::printf("\n");
+    }
+    return 0;
+}
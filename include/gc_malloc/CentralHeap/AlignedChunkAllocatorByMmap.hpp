@@ -9,6 +9,9 @@ public:
     void* allocate(size_t size) override;
     void deallocate(void* ptr, size_t size) override;
 
+    // 整批只做一次 mmap（count * chunk_size + 2MB）和至多两次裁剪，再把中间对齐的部分切成 chunk
+    size_t allocateBatch(size_t chunk_size, size_t count, void** out) override;
+
     AlignedChunkAllocatorByMmap() = default;
     ~AlignedChunkAllocatorByMmap() override = default;
 
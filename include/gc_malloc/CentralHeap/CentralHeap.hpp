@@ -1,17 +1,108 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <mutex>
 
+#include "gc_malloc/CentralHeap/ChunkDecay.hpp"
+
+class BlockHeader;
 class ChunkAllocatorFromKernel;
+class FormattedPoolCache;
 class FreeChunkCache;
+class LargeChunkCache;
+class PageRunAllocator;
+class ReservedArenaChunkAllocator;
+class RetainedChunkCache;
+class TransferCache;
+
+// chunk 缓存的实现选择
+enum class ChunkCacheKind {
+    kLocked,     // FreeChunkListCache：互斥锁保护的链表
+    kLockFree,   // LockFreeChunkCache：带版本号的 Treiber 栈
+};
+
+// chunk 来源的选择
+enum class ChunkSourceKind {
+    kMmap,            // AlignedChunkAllocatorByMmap：每次分配单独 mmap 并裁剪对齐
+    kReservedArena,   // ReservedArenaChunkAllocator：从启动时保留的大区间中按需提交
+};
 
 class CentralHeap {
 public:
     static CentralHeap& GetInstance();
 
+    // size 必须是 kChunkSize 的正整数倍；大于一个 chunk 时返回一段连续的大块映射
     void* acquireChunk(size_t size);
     void releaseChunk(void* chunk, size_t size);
 
+    // 中等对象：从共享 chunk 中切出 pages 个连续 4KB 页，返回页对齐的段起始地址
+    void* acquirePageRun(size_t pages);
+    void releasePageRun(void* run);
+
+    // ---- 孤儿队列：退出线程留下的子池与仍在跟踪的块，由存活线程认领 ----
+    // 子池以其 managed_node 入队；子池节点与块节点都经 BlockHeader::next 串成侵入式链表，不额外分配。
+    // 子池按 size-class 分队（后进先出），块不分类，一次整链取走。
+    void         publishOrphanPool(size_t size_class, BlockHeader* pool_node);
+    BlockHeader* adoptOrphanPool(size_t size_class);             // 无孤儿时返回 nullptr
+    void         publishOrphanBlocks(BlockHeader* first, BlockHeader* last);
+    BlockHeader* adoptOrphanBlocks();                            // 取走整条链，末尾 next 为 nullptr
+    bool hasOrphanPools(size_t size_class) const noexcept {
+        return orphan_pools_[size_class].load(std::memory_order_relaxed) != nullptr;
+    }
+    bool hasOrphanBlocks() const noexcept {
+        return orphan_blocks_.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    // ---- 已格式化子池：空子池交还时保持构造状态与 PageMap 登记，同 size-class 补充子池时直接取回 ----
+    // 子池的析构由 ThreadHeap 负责：存入时挤出的子池（可能就是 pool 本身）返回给调用方
+    void* acquireFormattedPool(size_t size_class);               // 没有时返回 nullptr
+    // purge_offset 之前是常驻的子池头部，之后的数据区在暂存期间按时间衰减
+    void* depositFormattedPool(void* pool, size_t size_class, size_t purge_offset);   // 返回被挤出的子池，没有时返回 nullptr
+
+    // ---- 传输缓存：线程缓存溢出的小对象块按 size-class 暂存，其他线程补货时先从这里整批取走 ----
+    // 块仍归原子池（及其所属线程）管理，这里只是换手；容量按块大小折算，见 kTransferBytesPerClass
+    size_t insertTransferBlocks(size_t size_class, void* const* blocks, size_t n);   // 返回接收的块数
+    size_t removeTransferBlocks(size_t size_class, void** out, size_t n);            // 返回取到的块数
+    size_t transferBlockCount(size_t size_class) const noexcept;
+    size_t transferCapacity(size_t size_class) const noexcept;
+
+    // ---- 衰减回收（仿 jemalloc 的 dirty / muzzy 衰减），缓存的 chunk 保持映射、逐步交还物理页 ----
+    // 热缓存中闲置满一个 dirty 衰减时间的 chunk、以及超出热缓存水位的 chunk 转入保留缓存；
+    // 保留缓存中的 chunk 与已格式化子池的数据区按停留时间先 MADV_FREE（muzzy），再 MADV_DONTNEED（clean）。
+    // 由分配路径上的节拍（decayTick）或可选的后台线程驱动
+    struct DecayStats {
+        size_t hot_chunks;       // 热缓存中的 chunk，都是 dirty
+        size_t retained_dirty;   // 保留缓存中各阶段的 chunk 数
+        size_t retained_muzzy;
+        size_t retained_clean;
+        size_t pools_dirty;      // 已格式化子池各阶段的个数
+        size_t pools_muzzy;
+        size_t pools_clean;
+    };
+    static constexpr std::chrono::milliseconds kDefaultDirtyDecay{1000};
+    static constexpr std::chrono::milliseconds kDefaultMuzzyDecay{10000};
+    static constexpr std::chrono::milliseconds kDecayTickInterval{50};   // 节拍推进衰减的最小间隔
+
+    // 衰减时间对所有缓存生效；dirty 为 0 表示下一轮即交还，muzzy 为 0 表示跳过 MADV_FREE 直接 MADV_DONTNEED
+    void   setDecayTimes(std::chrono::milliseconds dirty, std::chrono::milliseconds muzzy);
+    uint64_t getDirtyDecayNs() const noexcept { return dirty_decay_ns_.load(std::memory_order_relaxed); }
+    // 立即推进一轮衰减，返回转入保留缓存或降级的 chunk / 子池数；另一轮正在进行时直接返回 0
+    size_t purgeDecayed();
+    // 距上一轮已超过 kDecayTickInterval 时推进一轮，否则只读一次时钟
+    void   decayTick() noexcept;
+    // 后台线程每隔 interval 推进一轮；已在运行时只更新间隔。创建线程失败时返回 false
+    bool   startBackgroundPurge(std::chrono::milliseconds interval);
+    void   stopBackgroundPurge();   // 等后台线程退出后返回
+    DecayStats getDecayStats() const;
+
+    // 指针是否落在本分配器当前持有的 chunk 内。保留区模式下是 O(1) 的区间比较；
+    // 保留失败、使用 mmap 来源或保留区已溢出到 mmap 时无法判断，总是返回 true。
+    bool owns(const void* ptr) const noexcept;
+
     CentralHeap(const CentralHeap&) = delete;
     CentralHeap& operator=(const CentralHeap&) = delete;
     CentralHeap(CentralHeap&&) = delete;
@@ -19,15 +110,69 @@ public:
 
 public:
     static constexpr size_t kChunkSize = 2 * 1024 *1024;
+    static constexpr size_t kOrphanClassSlots = 64;   // 不少于 size-class 数
+    static constexpr size_t kTransferClassSlots = 64;              // 不少于 size-class 数
+    static constexpr size_t kTransferBytesPerClass = 256 * 1024;   // 每个 size-class 传输缓存的目标字节数
+
+#ifdef GC_MALLOC_LOCKED_CHUNK_CACHE
+    static constexpr ChunkCacheKind kDefaultChunkCacheKind = ChunkCacheKind::kLocked;
+#else
+    static constexpr ChunkCacheKind kDefaultChunkCacheKind = ChunkCacheKind::kLockFree;
+#endif
+
+#ifdef GC_MALLOC_NO_RESERVED_ARENA
+    static constexpr ChunkSourceKind kDefaultChunkSourceKind = ChunkSourceKind::kMmap;
+#else
+    static constexpr ChunkSourceKind kDefaultChunkSourceKind = ChunkSourceKind::kReservedArena;
+#endif
 
 private:
-    CentralHeap();
+    CentralHeap(ChunkCacheKind cache_kind, ChunkSourceKind source_kind);
     virtual ~CentralHeap(); 
 
     bool refillCache(); 
 
+    void* acquireLargeSpan(size_t size);
+    void releaseLargeSpan(void* span, size_t size);
+
+    static void* pageRunRefill_cb(void* ctx) noexcept;
+    static void pageRunReturn_cb(void* ctx, void* chunk) noexcept;
+
+    // ---- 衰减回收 ----
+    static bool  adviseChunk_cb(void* ctx, void* base, size_t offset, ChunkDecayStage to) noexcept;
+    static void* backgroundPurgeMain(void* self) noexcept;
+    void   retainOrRelease(void* chunk, ChunkDecayStage stage, uint64_t since_ns);   // 保留缓存已满时交还内核
+    size_t decayHotCache(uint64_t now_ns, uint64_t dirty_ns);   // 把闲置满一个窗口的热缓存 chunk 转入保留缓存
+    void   noteHotCount(size_t count) noexcept;                 // 热缓存出栈后更新本窗口的最低数量
+
     ChunkAllocatorFromKernel* ChunkAllocatorFromKernel_ptr = nullptr;
     FreeChunkCache* FreeChunkCache_ptr = nullptr;
+    LargeChunkCache* LargeChunkCache_ptr = nullptr;
+    FormattedPoolCache* FormattedPoolCache_ptr = nullptr;
+    RetainedChunkCache* RetainedChunkCache_ptr = nullptr;
+    PageRunAllocator* PageRunAllocator_ptr = nullptr;
+    ReservedArenaChunkAllocator* ReservedArena_ptr = nullptr;   // 仅保留区模式下非空
+    TransferCache* TransferCache_ptr = nullptr;                   // kTransferClassSlots 个，按 size-class 下标
+
+    // 孤儿队列：头指针可无锁读取（判空），入队与出队在 orphan_mutex_ 下进行
+    std::mutex                orphan_mutex_;
+    std::atomic<BlockHeader*> orphan_pools_[kOrphanClassSlots] = {};
+    std::atomic<BlockHeader*> orphan_blocks_{nullptr};
+
+    // 衰减：一次只进行一轮；热缓存以“窗口内的最低数量”判断闲置，窗口长度为 dirty 衰减时间
+    std::mutex            purge_mutex_;
+    std::atomic<uint64_t> dirty_decay_ns_;
+    std::atomic<uint64_t> muzzy_decay_ns_;
+    std::atomic<uint64_t> next_tick_ns_{0};
+    std::atomic<size_t>   hot_low_water_{0};
+    uint64_t              hot_window_start_ns_ = 0;   // purge_mutex_ 保护
+
+    // 后台衰减线程
+    enum class PurgeThreadState { kStopped, kRunning, kStopping };
+    std::mutex                purge_thread_mutex_;
+    std::condition_variable   purge_thread_cv_;
+    PurgeThreadState          purge_thread_state_ = PurgeThreadState::kStopped;
+    std::chrono::milliseconds purge_interval_{0};
 
     static constexpr size_t kMaxWatermarkInChunks = 16;
     static constexpr size_t kTargetWatermarkInChunks = 8;
@@ -7,6 +7,17 @@ public:
     virtual void* allocate(size_t size) = 0;
     virtual void deallocate(void* ptr,size_t size) = 0;
 
+    // 一次申请 count 个 chunk_size 大小的 chunk，写入 out[0..count)，返回实际得到的个数。
+    // 得到的每个 chunk 都可以单独 deallocate。默认实现逐个调用 allocate。
+    virtual size_t allocateBatch(size_t chunk_size, size_t count, void** out) {
+        size_t n = 0;
+        for (; n < count; ++n) {
+            out[n] = allocate(chunk_size);
+            if (out[n] == nullptr) break;
+        }
+        return n;
+    }
+
     virtual ~ChunkAllocatorFromKernel() = default;
 
     ChunkAllocatorFromKernel(const ChunkAllocatorFromKernel&) = delete;
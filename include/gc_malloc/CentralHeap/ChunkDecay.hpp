@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// 缓存中 chunk 的衰减阶段（仿 jemalloc 的 dirty / muzzy 衰减）：保持映射，只逐步交还物理页
+enum class ChunkDecayStage : uint8_t {
+    kDirty,   // 物理页驻留
+    kMuzzy,   // 已 MADV_FREE：内核在内存紧张时才回收，回收前复用不必缺页
+    kClean,   // 已 MADV_DONTNEED：物理页已交还，复用时逐页缺页并读到零
+};
+
+// 把 [base + offset, chunk 末尾) 降到 to 阶段（由 CentralHeap 发起 madvise）；失败时返回 false，保持原阶段
+using ChunkAdviseCallback = bool (*)(void* ctx, void* base, size_t offset, ChunkDecayStage to) noexcept;
+
+// 在当前阶段已停留 age_ns 的 chunk 应降到的阶段：dirty 停留满 dirty_ns 转 muzzy，muzzy 停留满 muzzy_ns 转 clean。
+// muzzy_ns 为 0 表示跳过 muzzy，dirty 到期直接转 clean。不需要降级时返回 stage 本身
+constexpr ChunkDecayStage decayTarget(ChunkDecayStage stage, uint64_t age_ns,
+                                      uint64_t dirty_ns, uint64_t muzzy_ns) noexcept {
+    switch (stage) {
+    case ChunkDecayStage::kDirty:
+        if (age_ns < dirty_ns) return stage;
+        return muzzy_ns == 0 ? ChunkDecayStage::kClean : ChunkDecayStage::kMuzzy;
+    case ChunkDecayStage::kMuzzy:
+        return age_ns < muzzy_ns ? stage : ChunkDecayStage::kClean;
+    case ChunkDecayStage::kClean:
+        break;
+    }
+    return stage;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "gc_malloc/CentralHeap/ChunkDecay.hpp"
+
+// 已格式化子池的缓存：ThreadHeap 交还的空子池保持构造状态与 PageMap 登记暂存于此，
+// 同一 size-class 下次补充子池时直接取回，省去析构、重新构造与 PageMap 改写。
+// 只负责记账，不解释子池内容；被挤出的子池交还调用方，由调用方析构并归还 chunk。
+// 暂存期间同样按时间衰减：子池头部常驻，purge_offset 之后的数据区逐步交还物理页（空子池处于 bump 模式，内容无意义）。
+class FormattedPoolCache
+{
+public:
+    static constexpr size_t kMaxEntries  = 8;
+    static constexpr size_t kMaxPerClass = 2;   // 同一 size-class 至多缓存的子池数
+
+    // 取出该 size-class 最近存入的子池；没有则返回 nullptr
+    void*  acquire(size_t size_class);
+    // 存入一个子池。同类已有 kMaxPerClass 个时挤出同类中最早存入的，总数已满时挤出全体中最早存入的；
+    // 返回被挤出的子池，没有挤出时返回 nullptr
+    void*  deposit(void* pool, size_t size_class, size_t purge_offset = 0, uint64_t now_ns = 0);
+
+    // 与 RetainedChunkCache::advance 相同：持锁对到期子池的 [purge_offset, 末尾) 调用 cb，返回降级的子池数
+    size_t advance(uint64_t now_ns, uint64_t dirty_ns, uint64_t muzzy_ns, ChunkAdviseCallback cb, void* ctx);
+
+    size_t getCacheCount() const;
+    size_t getClassCount(size_t size_class) const;
+    size_t getCount(ChunkDecayStage stage) const;
+
+    FormattedPoolCache() = default;
+    ~FormattedPoolCache() = default;
+
+    FormattedPoolCache(const FormattedPoolCache&) = delete;
+    FormattedPoolCache& operator=(const FormattedPoolCache&) = delete;
+    FormattedPoolCache(FormattedPoolCache&&) = delete;
+    FormattedPoolCache& operator=(FormattedPoolCache&&) = delete;
+private:
+    struct Entry {
+        void*           pool;
+        size_t          size_class;
+        size_t          purge_offset;   // 之前是常驻的子池头部
+        uint64_t        since_ns;       // 进入当前阶段的时间
+        ChunkDecayStage stage;
+    };
+
+    void* removeAt(size_t index);   // 调用方持锁；后面的条目前移，保持按存入先后排列
+
+    Entry  entries_[kMaxEntries] = {};   // 按存入先后排列，下标 0 最早
+    size_t entry_count_ = 0;
+    mutable std::mutex mutex_;
+};
@@ -9,6 +9,9 @@ public:
     virtual void deposit(void* chunk) = 0;
     virtual size_t getCacheCount() const = 0;
 
+    // 在把曾经进入过缓存的 chunk 交还内核之前调用；只有无锁实现需要等待
+    virtual void waitForReaders() const {}
+
     virtual ~FreeChunkCache() = default;
 
     FreeChunkCache(const FreeChunkCache&) = delete;
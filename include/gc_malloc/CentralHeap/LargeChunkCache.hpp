@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+
+// 多 chunk 大块映射的缓存：大对象释放后暂存其整段映射，供后续大对象请求复用，
+// 省去 mmap + 两次裁剪 munmap 以及重新缺页的开销。
+// 只负责记账，不做任何系统调用；放不下时由调用方归还内核。
+class LargeChunkCache
+{
+public:
+    static constexpr size_t kMaxEntries     = 8;
+    static constexpr size_t kMaxCachedBytes = 64 * 1024 * 1024;   // 64MB
+
+    // 取出能容纳 size 的最小缓存段（best-fit），实际长度写入 *span_size；没有则返回 nullptr
+    void* acquire(size_t size, size_t* span_size);
+    // 存入一段映射；超出条目数或总字节上限时返回 false
+    bool  deposit(void* span, size_t size);
+
+    size_t getCacheCount() const;
+    size_t getCachedBytes() const;
+
+    LargeChunkCache() = default;
+    ~LargeChunkCache() = default;
+
+    LargeChunkCache(const LargeChunkCache&) = delete;
+    LargeChunkCache& operator=(const LargeChunkCache&) = delete;
+    LargeChunkCache(LargeChunkCache&&) = delete;
+    LargeChunkCache& operator=(LargeChunkCache&&) = delete;
+private:
+    struct Entry {
+        void*  span;
+        size_t size;
+    };
+
+    Entry  entries_[kMaxEntries] = {};
+    size_t entry_count_  = 0;
+    size_t cached_bytes_ = 0;
+    mutable std::mutex mutex_;
+};
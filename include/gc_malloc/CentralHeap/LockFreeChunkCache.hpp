@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "FreeChunkCache.hpp"
+
+// 无锁 chunk 缓存：Treiber 栈，栈顶指针与版本号打包在同一个 64 位字里做 CAS。
+// x86-64 / AArch64 用户态地址只用低 48 位，高 16 位存放版本号，每次出栈递增，
+// 以此避免 ABA（同一 chunk 被取走又放回时旧的 CAS 不会误成功）。
+// 计数只是近似值，供 CentralHeap 的水位判断使用。
+class LockFreeChunkCache : public FreeChunkCache
+{
+public:
+    void* acquire() override;
+    void deposit(void* chunk) override;
+
+    size_t getCacheCount() const override;
+
+    // 等待所有进行中的 acquire 结束。出栈时会读取栈顶 chunk 内的 next 字段，
+    // 该 chunk 可能刚被其他线程取走；在把 chunk 交还内核（解除映射）之前必须调用，
+    // 保证不会有线程再读取它。
+    void waitForReaders() const override;
+
+    LockFreeChunkCache() = default;
+    ~LockFreeChunkCache() override = default;
+
+    LockFreeChunkCache(const LockFreeChunkCache&) = delete;
+    LockFreeChunkCache& operator=(const LockFreeChunkCache&) = delete;
+    LockFreeChunkCache(LockFreeChunkCache&&) = delete;
+    LockFreeChunkCache& operator=(LockFreeChunkCache&&) = delete;
+
+private:
+    struct Node {
+        std::atomic<Node*> next;
+    };
+
+    static constexpr unsigned  kTagShift   = 48;
+    static constexpr uint64_t  kPointerMask = (uint64_t{1} << kTagShift) - 1;
+
+    static Node*    unpackNode(uint64_t word) noexcept { return reinterpret_cast<Node*>(word & kPointerMask); }
+    static uint64_t unpackTag(uint64_t word) noexcept  { return word >> kTagShift; }
+    static uint64_t pack(Node* node, uint64_t tag) noexcept {
+        return (reinterpret_cast<uint64_t>(node) & kPointerMask) | (tag << kTagShift);
+    }
+
+    std::atomic<uint64_t> head_{0};
+    std::atomic<size_t>   chunk_count_{0};
+    std::atomic<size_t>   readers_{0};
+};
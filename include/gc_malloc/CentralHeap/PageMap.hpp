@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+class ThreadHeap;
+
+// chunk 的用途
+enum class ChunkKind : uint8_t {
+    kNone = 0,      // 未登记：不是本分配器当前在用的 chunk（外来指针、缓存中的 chunk 等）
+    kSmallPool,     // MemSubPool：base 指向子池头部
+    kMediumRun,     // PageRunChunk：base 指向页段 chunk 头部，由所有线程共享
+    kLargeObject,   // LargeObject：base 指向大对象头部（跨多个 chunk 时每个 chunk 都登记同一 base）
+};
+
+// 一个 chunk 的元数据
+struct PageMapEntry {
+    ChunkKind   kind       = ChunkKind::kNone;
+    uint8_t     size_class = 0;         // 仅 kSmallPool 有意义
+    void*       base       = nullptr;   // 该 chunk 所属对象的头部地址
+    ThreadHeap* owner      = nullptr;   // 所属 ThreadHeap；共享 chunk 为 nullptr
+};
+
+// 全局两级基数树：chunk 编号（地址 >> 21）-> PageMapEntry，类似 tcmalloc 的 pagemap。
+// 48 位用户地址空间共 2^27 个 chunk：根表 2^13 项常驻静态存储，叶子 2^14 项按需 mmap。
+// 查询只需两次加载（根表项、叶子项），不触碰被查询的内存本身，外来指针可以安全拒绝。
+// 叶子一经建立永不释放；表项只在 chunk 被分配为某种用途或交还时改写。
+class PageMap {
+public:
+    static constexpr size_t kAddressBits = 48;
+    static constexpr size_t kChunkShift  = 21;
+    static constexpr size_t kKeyBits     = kAddressBits - kChunkShift;   // 27
+    static constexpr size_t kRootBits    = 13;
+    static constexpr size_t kLeafBits    = kKeyBits - kRootBits;         // 14
+    static constexpr size_t kRootLength  = size_t{1} << kRootBits;
+    static constexpr size_t kLeafLength  = size_t{1} << kLeafBits;
+
+public:
+    static PageMap& GetInstance();
+
+    // 为从 chunk 开始的 nchunks 个 chunk 登记同一条元数据；叶子分配失败时返回 false
+    bool set(const void* chunk, size_t nchunks, const PageMapEntry& entry) noexcept;
+    void clear(const void* chunk, size_t nchunks) noexcept;
+
+    // 任意指针（可为内部指针或外来指针）-> 所在 chunk 的元数据；未登记返回 kind == kNone
+    PageMapEntry lookup(const void* ptr) const noexcept {
+        const uintptr_t key = reinterpret_cast<uintptr_t>(ptr) >> kChunkShift;
+        if (key >> kKeyBits) return PageMapEntry{};
+
+        const Leaf* leaf = root_[key >> kLeafBits].load(std::memory_order_acquire);
+        if (leaf == nullptr) return PageMapEntry{};
+
+        const Slot& slot = leaf->slots[key & (kLeafLength - 1)];
+        const uint64_t word = slot.tagged_base.load(std::memory_order_acquire);
+
+        PageMapEntry e;
+        e.kind       = static_cast<ChunkKind>(word >> kKindShift);
+        e.size_class = static_cast<uint8_t>(word >> kClassShift);
+        e.base       = reinterpret_cast<void*>(word & kBaseMask);
+        e.owner      = slot.owner.load(std::memory_order_relaxed);
+        return e;
+    }
+
+    PageMap(const PageMap&)            = delete;
+    PageMap& operator=(const PageMap&) = delete;
+    PageMap(PageMap&&)                 = delete;
+    PageMap& operator=(PageMap&&)      = delete;
+
+private:
+    PageMap() noexcept;
+    ~PageMap() = default;
+
+    // base 只用低 48 位，高 16 位放 kind 与 size_class，使 kind/base 一次加载即可得到
+    static constexpr unsigned kClassShift = 48;
+    static constexpr unsigned kKindShift  = 56;
+    static constexpr uint64_t kBaseMask   = (uint64_t{1} << kClassShift) - 1;
+
+    struct Slot {
+        std::atomic<uint64_t>    tagged_base;
+        std::atomic<ThreadHeap*> owner;
+    };
+
+    struct Leaf {
+        Slot slots[kLeafLength];
+    };
+
+    Slot* slotFor(uintptr_t key, bool create) noexcept;
+
+    std::atomic<Leaf*> root_[kRootLength];
+};
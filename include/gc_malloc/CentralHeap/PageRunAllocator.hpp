@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// 页段 chunk 的头部：占据 2MB chunk 的第 0 页，其余 511 页按 4KB 粒度切成若干段（run）。
+// 每个段在首页/尾页记录边界标签（长度 + 空闲位），释放时据此与相邻空闲段合并；
+// 已分配段内的每一页记录段首页号，便于由内部指针找回段起始。
+class PageRunChunk {
+public:
+    static constexpr size_t   kChunkSize       = 2 * 1024 * 1024;  // 与 CentralHeap 保持一致
+    static constexpr size_t   kPageSize        = 4096;
+    static constexpr size_t   kPageCount       = kChunkSize / kPageSize;   // 512
+    static constexpr size_t   kFirstUsablePage = 1;                        // 第 0 页存放本头部
+    static constexpr size_t   kUsablePages     = kPageCount - kFirstUsablePage;
+    static constexpr uint64_t kChunkMagic      = 0x314E555245474150ull; // "PAGERUN1"
+
+public:
+    PageRunChunk() noexcept;   // 初始时整块是一个空闲段
+    ~PageRunChunk();
+
+    PageRunChunk(const PageRunChunk&)            = delete;
+    PageRunChunk& operator=(const PageRunChunk&) = delete;
+    PageRunChunk(PageRunChunk&&)                 = delete;
+    PageRunChunk& operator=(PageRunChunk&&)      = delete;
+
+    // 判断 2MB 对齐的基址处是否是一个存活的页段 chunk（依据魔数）
+    static bool isPageRunChunkHeader(const void* base) noexcept;
+
+    // 内部指针 -> 所在已分配段的起始地址；落在空闲页或头部页返回 nullptr
+    void*  runOf(const void* ptr) const noexcept;
+    // 已分配段的字节数（run 必须是段起始地址）
+    size_t runBytes(const void* run) const noexcept;
+
+private:
+    friend class PageRunAllocator;
+
+    static constexpr uint16_t kFreeBit = 0x8000;
+    static constexpr uint16_t kNoOwner = 0xFFFF;
+
+    size_t pageIndexOf(const void* p) const noexcept;
+    void*  pageAddress(size_t page) noexcept;
+
+    void setRun(size_t first, size_t len, bool free) noexcept;
+
+    uint64_t magic_;
+    uint16_t start_tag_[kPageCount];   // 段首页：长度 | kFreeBit
+    uint16_t end_tag_[kPageCount];     // 段尾页：长度 | kFreeBit
+    uint16_t owner_[kPageCount];       // 已分配段内每页 -> 段首页号
+};
+
+// 页段分配器：在多个共享 chunk 上按页数分配连续段，best-fit 选段，释放时合并相邻空闲段。
+// 空闲段按长度分桶（侵入式双向链表，节点放在空闲段首页内），配合非空位图 O(1) 找到 best-fit 桶。
+// chunk 的获取/归还经由回调完成，本类不直接与内核或 CentralHeap 打交道；回调总在锁外调用。线程安全。
+class PageRunAllocator {
+public:
+    static constexpr size_t kPageSize       = PageRunChunk::kPageSize;
+    static constexpr size_t kMaxRunPages    = PageRunChunk::kUsablePages;
+    static constexpr size_t kMaxEmptyChunks = 1;   // 保留的完全空闲 chunk 数，避免边界抖动
+
+    using RefillCallback = void* (*)(void* ctx) noexcept;              // 提供一个 2MB 对齐的 chunk
+    using ReturnCallback = void  (*)(void* ctx, void* chunk) noexcept; // 交还完全空闲的 chunk
+
+public:
+    PageRunAllocator() noexcept;
+    ~PageRunAllocator() = default;
+
+    PageRunAllocator(const PageRunAllocator&)            = delete;
+    PageRunAllocator& operator=(const PageRunAllocator&) = delete;
+    PageRunAllocator(PageRunAllocator&&)                 = delete;
+    PageRunAllocator& operator=(PageRunAllocator&&)      = delete;
+
+    void setRefillCallback(RefillCallback cb, void* ctx) noexcept;
+    void setReturnCallback(ReturnCallback cb, void* ctx) noexcept;
+
+    // 分配 pages 页的连续段（1 <= pages <= kMaxRunPages），返回页对齐的段起始地址
+    void* allocate(size_t pages) noexcept;
+    void  release(void* run) noexcept;
+
+    // 便捷查询：指针不在页段 chunk 内时返回 nullptr / 0
+    static void*  runOf(const void* ptr) noexcept;
+    static size_t runBytes(const void* run) noexcept;
+
+    size_t getChunkCount() const noexcept;
+    size_t getFreePages()  const noexcept;
+
+private:
+    struct FreeRun {
+        FreeRun* prev;
+        FreeRun* next;
+    };
+
+    static constexpr size_t kBucketCount = PageRunChunk::kPageCount;   // 下标即段长
+    static constexpr size_t kBucketWords = kBucketCount / 64;
+
+    void   insertFree(PageRunChunk* chunk, size_t first, size_t len) noexcept;
+    void   removeFree(PageRunChunk* chunk, size_t first, size_t len) noexcept;
+    size_t findBucket(size_t min_len) const noexcept;
+
+    PageRunChunk* fetchChunk() noexcept;                 // 不持锁调用：经回调取 chunk 并构造头部
+    void          adoptChunk(PageRunChunk* chunk) noexcept;   // 持锁调用：整块挂入空闲桶
+
+    mutable std::mutex mutex_;
+
+    FreeRun* buckets_[kBucketCount];
+    uint64_t nonempty_[kBucketWords];
+
+    size_t chunk_count_  = 0;
+    size_t free_pages_   = 0;
+    size_t empty_chunks_ = 0;
+
+    RefillCallback refill_cb_  = nullptr;
+    ReturnCallback return_cb_  = nullptr;
+    void*          refill_ctx_ = nullptr;
+    void*          return_ctx_ = nullptr;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "AlignedChunkAllocatorByMmap.hpp"
+#include "ChunkAllocatorFromKernel.hpp"
+
+// 预留地址空间的 chunk 来源：启动时一次性保留一大段 PROT_NONE 的虚拟地址（不占物理内存），
+// 之后按需把其中的 2MB chunk 提交为可读写，归还时再解除提交。
+// 所有 chunk 都落在同一区间内，于是：
+//   - “指针是否属于本分配器”是一次区间比较加一次位图查询；
+//   - chunk 编号就是 (ptr - base) >> 21，可直接作为旁路表的下标；
+//   - 区间本身按 2MB 对齐，分配不再需要多映射再裁剪。
+// 保留区耗尽（或找不到足够长的连续空闲段）时退回普通的对齐 mmap，分配不会因保留区大小而失败；
+// 这些溢出 chunk 不在区间内，owns() 对它们返回 false，归属判断应以 PageMap 为准。
+class ReservedArenaChunkAllocator : public ChunkAllocatorFromKernel {
+public:
+    static constexpr size_t kChunkShift          = 21;
+    static constexpr size_t kChunkSize           = size_t{1} << kChunkShift;   // 2MB
+    static constexpr size_t kMaxReserveBytes     = size_t{64} << 30;           // 64GB
+    static constexpr size_t kDefaultReserveBytes = kMaxReserveBytes;
+
+public:
+    // reserve_bytes 会被截断到 kMaxReserveBytes 并向下取整到 chunk；保留失败时 isReserved() 为 false
+    explicit ReservedArenaChunkAllocator(size_t reserve_bytes = kDefaultReserveBytes);
+    ~ReservedArenaChunkAllocator() override;
+
+    void* allocate(size_t size) override;
+    void deallocate(void* ptr, size_t size) override;
+
+    // 整批只加一次锁、扫一遍位图：取首个足够长的连续空闲段（没有就取最长的一段，少给几个），
+    // 一次 mprotect 提交后切成 chunk；保留区内一个空闲 chunk 都没有时整批退回 mmap
+    size_t allocateBatch(size_t chunk_size, size_t count, void** out) override;
+
+    bool isReserved() const noexcept { return base_ != 0; }
+
+    // 指针是否落在保留区内一个当前已提交的 chunk 内（无锁，O(1)）；溢出 chunk 不计入
+    bool owns(const void* ptr) const noexcept {
+        const uintptr_t off = reinterpret_cast<uintptr_t>(ptr) - base_;
+        if (off >= reserved_bytes_) return false;
+        const size_t idx = off >> kChunkShift;
+        return (used_[idx / 64].load(std::memory_order_relaxed) >> (idx % 64)) & 1u;
+    }
+
+    // 区间内指针 -> chunk 编号（调用方保证 ptr 在区间内）
+    size_t chunkIndexOf(const void* ptr) const noexcept {
+        return (reinterpret_cast<uintptr_t>(ptr) - base_) >> kChunkShift;
+    }
+
+    size_t getChunkCapacity() const noexcept { return chunk_capacity_; }
+    size_t getCommittedChunks() const;   // 只计保留区内的 chunk
+    // 是否曾有分配落到保留区之外
+    bool   hasOverflowed() const noexcept { return overflowed_.load(std::memory_order_relaxed); }
+
+    ReservedArenaChunkAllocator(const ReservedArenaChunkAllocator&) = delete;
+    ReservedArenaChunkAllocator& operator=(const ReservedArenaChunkAllocator&) = delete;
+    ReservedArenaChunkAllocator(ReservedArenaChunkAllocator&&) = delete;
+    ReservedArenaChunkAllocator& operator=(ReservedArenaChunkAllocator&&) = delete;
+
+private:
+    static constexpr size_t kMaxChunks   = kMaxReserveBytes / kChunkSize;
+    static constexpr size_t kBitmapWords = kMaxChunks / 64;
+
+    bool isUsed(size_t idx) const noexcept {
+        return (used_[idx / 64].load(std::memory_order_relaxed) >> (idx % 64)) & 1u;
+    }
+    void   markRange(size_t first, size_t count, bool used) noexcept;
+    size_t findFreeRange(size_t count) const noexcept;   // 首次适配；找不到返回 chunk_capacity_
+    // 首个长度达到 count 的空闲段；没有则为最长的空闲段。*len 为可用长度（不超过 count，可能为 0）
+    size_t findLongestFreeRange(size_t count, size_t* len) const noexcept;
+
+    uintptr_t base_           = 0;
+    size_t    reserved_bytes_ = 0;
+    size_t    chunk_capacity_ = 0;
+    size_t    committed_      = 0;
+
+    mutable std::mutex mutex_;   // 串行化提交/解除提交；owns() 只读位图，不加锁
+
+    AlignedChunkAllocatorByMmap overflow_;   // 保留区耗尽后的来源；自身无状态，不需要加锁
+    std::atomic<bool> overflowed_{false};
+
+    std::atomic<uint64_t> used_[kBitmapWords];
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "gc_malloc/CentralHeap/ChunkDecay.hpp"
+
+// 保留 chunk 缓存：热缓存放不下、或在热缓存中闲置满一个衰减周期的 chunk 保持映射暂存于此，
+// 随时间依次降为 muzzy、clean，直到被复用或被挤出。复用只需重新缺页，省去 munmap + mmap + 裁剪。
+// 只负责记账，不做系统调用：降级经 advance 的回调完成。
+class RetainedChunkCache
+{
+public:
+    static constexpr size_t kMaxEntries = 64;   // 至多保留 128MB 地址空间
+
+    // 取一个 chunk：阶段越“热”越优先（dirty > muzzy > clean），同阶段取最近进入的；没有则返回 nullptr
+    void*  acquire();
+    // 存入一个处于 stage 阶段、自 since_ns 起停留在该阶段的 chunk；已满时返回 false，由调用方交还内核
+    bool   deposit(void* chunk, ChunkDecayStage stage, uint64_t since_ns);
+
+    // 按 decayTarget 把到期的 chunk 降级：持锁调用 cb 完成 madvise，成功后记为新阶段、从 now_ns 起计时。
+    // 返回降级的 chunk 数
+    size_t advance(uint64_t now_ns, uint64_t dirty_ns, uint64_t muzzy_ns, ChunkAdviseCallback cb, void* ctx);
+
+    size_t getCacheCount() const;
+    size_t getCount(ChunkDecayStage stage) const;
+
+    RetainedChunkCache() = default;
+    ~RetainedChunkCache() = default;
+
+    RetainedChunkCache(const RetainedChunkCache&) = delete;
+    RetainedChunkCache& operator=(const RetainedChunkCache&) = delete;
+    RetainedChunkCache(RetainedChunkCache&&) = delete;
+    RetainedChunkCache& operator=(RetainedChunkCache&&) = delete;
+private:
+    struct Entry {
+        void*           chunk;
+        uint64_t        since_ns;
+        ChunkDecayStage stage;
+    };
+
+    Entry  entries_[kMaxEntries] = {};   // 无序；取出时用末尾条目填补空位
+    size_t entry_count_ = 0;
+    mutable std::mutex mutex_;
+};
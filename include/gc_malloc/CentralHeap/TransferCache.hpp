@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+// 单个 size-class 的传输缓存：线程缓存溢出的块按批暂存于此，供其他线程补货时整批取走，
+// 省去“回吐到子池 -> 子池变空交还 -> 重新格式化”的往返。
+// 块在子池位图里始终记为“占用”，子池仍归原线程所有；本类只保存指针，不写块内容。
+// 存取在互斥锁下成批进行，计数可无锁读取，空 / 满时不必加锁。
+class TransferCache
+{
+public:
+    static constexpr size_t kMaxBlocks = 512;
+
+    // 存入至多 n 个块，返回实际接收的个数（容量不足时少于 n，接收的是 blocks 的前缀）
+    size_t insert(void* const* blocks, size_t n);
+    // 取出至多 n 个块写入 out，后进先出；返回实际个数
+    size_t remove(void** out, size_t n);
+
+    // 只在投入使用前调用（CentralHeap 构造时按块大小设定）；超过 kMaxBlocks 的部分被截断
+    void   setCapacity(size_t capacity);
+    size_t getCapacity() const { return capacity_; }
+    size_t getCount() const { return count_.load(std::memory_order_relaxed); }
+
+    TransferCache() = default;
+    ~TransferCache() = default;
+
+    TransferCache(const TransferCache&) = delete;
+    TransferCache& operator=(const TransferCache&) = delete;
+    TransferCache(TransferCache&&) = delete;
+    TransferCache& operator=(TransferCache&&) = delete;
+private:
+    std::atomic<size_t> count_{0};
+    size_t              capacity_ = 0;
+    std::mutex          mutex_;
+    void*               slots_[kMaxBlocks] = {};
+};
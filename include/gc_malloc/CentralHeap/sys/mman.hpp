@@ -16,11 +16,16 @@ extern "C" {
 #define PROT_NONE       0x0
 #define MAP_SHARED      0x01
 #define MAP_PRIVATE     0x02
+#define MAP_FIXED       0x10
 #define MAP_ANONYMOUS   0x20
+#define MAP_NORESERVE   0x4000
 #define MAP_HUGETLB		0x040000
 #define MAP_ANON        MAP_ANONYMOUS
 #define MAP_FAILED      (reinterpret_cast<void*>(-1))
 
+#define MADV_DONTNEED   4
+#define MADV_FREE       8
+
 
 static inline void* mmap(void* addr, size_t length, int prot, int flags, int fd, off_t offset) {
     long ret = SYSCALL6(__NR_mmap, addr, length, prot, flags, fd, offset);
@@ -31,6 +36,15 @@ static inline int munmap(void* addr, size_t length) {
     return static_cast<int>(SYSCALL2(__NR_munmap, addr, length));
 }
 
+static inline int mprotect(void* addr, size_t length, int prot) {
+    return static_cast<int>(SYSCALL3(__NR_mprotect, addr, length, prot));
+}
+
+// 与上面的包装一致：失败时返回 -1 并设置 errno（如不支持 MADV_FREE 时为 EINVAL）
+static inline int madvise(void* addr, size_t length, int advice) {
+    return static_cast<int>(SYSCALL3(__NR_madvise, addr, length, advice));
+}
+
 
 #ifdef __cplusplus
 } // extern "C"
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+// gc_malloc 的 C 接口：语义与 libc 的 malloc 族保持一致。
+// 静态库中以 gc_ 前缀提供；共享库 libgc_malloc.so 再以标准名字导出（见 MallocOverride.cpp），
+// 可通过 LD_PRELOAD 直接替换系统分配器。
+extern "C" {
+
+void*       gc_malloc(std::size_t size) noexcept;
+void        gc_free(void* ptr) noexcept;
+void*       gc_calloc(std::size_t count, std::size_t size) noexcept;
+void*       gc_realloc(void* ptr, std::size_t size) noexcept;
+void*       gc_reallocarray(void* ptr, std::size_t count, std::size_t size) noexcept;
+
+int         gc_posix_memalign(void** memptr, std::size_t alignment, std::size_t size) noexcept;
+void*       gc_aligned_alloc(std::size_t alignment, std::size_t size) noexcept;
+void*       gc_memalign(std::size_t alignment, std::size_t size) noexcept;
+void*       gc_valloc(std::size_t size) noexcept;
+void*       gc_pvalloc(std::size_t size) noexcept;
+
+std::size_t gc_malloc_usable_size(void* ptr) noexcept;
+
+} // extern "C"
@@ -6,20 +6,36 @@
 // 简单位图：管理外部提供的缓冲区
 class Bitmap {
 public:
+    // zero_fill = false 时不初始化缓冲区：调用方保证只读取自己写过的位（如 MemSubPool 的 bump 模式）
     explicit Bitmap(std::size_t capacity_in_bits,
                     unsigned char* buffer,
-                    std::size_t buffer_size_in_bytes);
+                    std::size_t buffer_size_in_bytes,
+                    bool zero_fill = true);
     
     virtual ~Bitmap() = default;
 
     void   markAsUsed(std::size_t bit_index);
     void   markAsFree(std::size_t bit_index);
     bool   isUsed(std::size_t bit_index) const;
+    // 从 start_bit 起查找第一个空闲位：按 64 位字扫描（ctz），成段的全满字由 SIMD 跳过
     std::size_t findFirstFree(std::size_t start_bit = 0) const;
+    // 从 start_bit 起查找连续 n 个空闲位的起点，供批量分配使用
+    std::size_t findFirstFreeRun(std::size_t n, std::size_t start_bit = 0) const;
+
+    // 按 64 位字批量清位：清除第 word_index 个字中 mask 置位的位，返回实际由 1 变 0 的位数
+    std::size_t clearMask(std::size_t word_index, std::uint64_t mask);
+    // 按 64 位字批量置位，返回实际由 0 变 1 的位数（超出容量的位被忽略）
+    std::size_t setMask(std::size_t word_index, std::uint64_t mask);
+
+    // 字级访问：第 word_index 个 64 位字（超出有效字节的部分按“占用”补齐）与字数
+    std::uint64_t loadWord(std::size_t word_index) const;
+    std::size_t   wordCount() const { return ((capacity_in_bits_ + 7) / 8 + 7) / 8; }
 
     static constexpr std::size_t k_not_found = static_cast<std::size_t>(-1);
 
 private:
+    std::size_t findFirstUsed(std::size_t start_bit) const;   // 找不到返回 capacity_in_bits_
+
     unsigned char* buffer_;          // 外部位图缓冲区
     const std::size_t capacity_in_bits_; // 管理的有效位数
 };
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// 单个 size-class 的线程本地空闲块缓存（tcache）：
+// 缓存中的块在子池位图里仍记为“占用”，由本缓存独占；空闲块的前 8 字节用作单链表指针。
+// push/pop 是几条普通读写，没有原子操作与锁；补货与回吐都由 ThreadHeap 按批进行。
+class BlockCache {
+public:
+    static constexpr std::size_t kBytesPerClass = 32 * 1024;   // 每个 size-class 缓存的目标字节数
+    static constexpr std::size_t kMinCapacity   = 2;
+    static constexpr std::size_t kMaxCapacity   = 128;
+
+public:
+    explicit BlockCache(std::size_t block_size) noexcept;
+    ~BlockCache() = default;
+
+    BlockCache(const BlockCache&)            = delete;
+    BlockCache& operator=(const BlockCache&) = delete;
+
+    void* pop() noexcept {
+        FreeNode* node = head_;
+        if (!node) return nullptr;
+        head_ = node->next;
+        --count_;
+        return node;
+    }
+
+    void push(void* block) noexcept {
+        auto* node = static_cast<FreeNode*>(block);
+        node->next = head_;
+        head_ = node;
+        ++count_;
+    }
+
+    // 超出容量后应回吐到半满，由调用方批量处理
+    bool overflowed() const noexcept { return count_ > capacity_; }
+
+    // 弹出至多 n 个块写入 out，返回实际个数
+    std::size_t popBatch(void** out, std::size_t n) noexcept;
+    bool        contains(const void* block) const noexcept;   // 线性查找，仅供诊断
+
+    std::size_t count()       const noexcept { return count_; }
+    std::size_t capacity()    const noexcept { return capacity_; }
+    std::size_t refillCount() const noexcept { return (capacity_ + 1) / 2; }   // 一次补货的块数
+
+private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    FreeNode*   head_  = nullptr;
+    std::size_t count_ = 0;
+    std::size_t capacity_;
+};
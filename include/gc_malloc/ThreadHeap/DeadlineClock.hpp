@@ -0,0 +1,27 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// 有界 GC 用的廉价截止时间检查。
+// x86-64 且 TSC 不变（invariant TSC）时直接读 TSC：换算系数在进程内第一次使用后
+// 不阻塞地标定（记下一对 TSC / steady_clock 读数，间隔足够长后再求比值），标定完成前退回 steady_clock。
+// 其他平台一律使用 steady_clock。
+class DeadlineClock {
+public:
+    explicit DeadlineClock(std::chrono::nanoseconds budget) noexcept;
+
+    bool expired() const noexcept;
+    std::chrono::nanoseconds elapsed() const noexcept;
+
+    bool usesTsc() const noexcept { return use_tsc_; }
+
+private:
+    static std::uint64_t readTsc() noexcept;
+    static std::int64_t  steadyNs() noexcept;
+
+    bool          use_tsc_;
+    std::uint64_t start_;      // TSC 读数或 steady_clock 纳秒
+    std::uint64_t deadline_;   // 同上
+    std::uint64_t ticks_per_kns_;   // 每 1024ns 的 TSC 周期数（仅 use_tsc_ 时有效）
+};
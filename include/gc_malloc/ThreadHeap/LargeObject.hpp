@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gc_malloc/ThreadHeap/BlockHeader.hpp"
+
+// 大对象：超过 SizeClassConfig::kMaxMediumAlloc 的请求独占一段 2MB 对齐、
+// 由若干 chunk 组成的映射（其下的中等请求由 PageRunAllocator 的页段满足）。与 MemSubPool 类似，元数据直接放在映射起始处：
+//   [LargeObject 头部 64B（含 ManagedList 节点）][用户数据 ...]
+class LargeObject {
+public:
+    static constexpr std::size_t   kChunkSize  = 2 * 1024 * 1024;  // 与 CentralHeap 保持一致
+    static constexpr std::size_t   kHeaderSize = 64;               // 头部占满一个缓存行
+    static constexpr std::uint64_t kLargeMagic = 0x4C4152474F424A31ull; // "LARGOBJ1"
+
+public:
+    explicit LargeObject(std::size_t mapped_bytes) noexcept;
+    ~LargeObject();
+
+    LargeObject(const LargeObject&)            = delete;
+    LargeObject& operator=(const LargeObject&) = delete;
+    LargeObject(LargeObject&&)                 = delete;
+    LargeObject& operator=(LargeObject&&)      = delete;
+
+    void*       block() noexcept;            // 交给用户的块起始地址
+    BlockHeader* managedNode() noexcept { return &managed_node_; }   // 带外的状态与链表节点
+    std::size_t blockSize() const noexcept;  // 块可用的总字节数
+    std::size_t mappedBytes() const noexcept;
+
+    // 容纳 nbytes 所需的映射长度（chunk 整数倍）；溢出时返回 0
+    static std::size_t mappingSizeFor(std::size_t nbytes) noexcept;
+
+    // 判断 2MB 对齐的基址处是否是一个存活的大对象头部（依据魔数）
+    static bool isLargeObjectHeader(const void* base) noexcept;
+
+private:
+    std::uint64_t magic_;
+    std::size_t   mapped_bytes_;
+    BlockHeader   managed_node_;
+};
@@ -1,12 +1,15 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include "BlockHeader.hpp"
 
-// 单链表：管理已分配的块
+// 单链表：管理已分配的块（节点是带外的 BlockHeader：中等/大对象的头部，或子池头部里的 managed_node）
 // 特性：单线程遍历回收，无需加锁
 class ManagedList {
 public:
+    using VisitCallback = void (*)(void* ctx, BlockHeader* blk) noexcept;
+
     ManagedList() noexcept;
     virtual ~ManagedList() = default;
 
@@ -15,8 +18,10 @@ public:
     ManagedList(ManagedList&&) = delete;
     ManagedList& operator=(ManagedList&&) = delete;
 
-    // 尾插块
-    void appendUsed(BlockHeader* blk) noexcept;
+    // 尾插块；blk 为空时返回 false（与 SegmentedManagedList 接口一致）
+    bool appendUsed(BlockHeader* blk) noexcept;
+    // 尾插但不改状态：清扫后重新挂回的子池节点可能已被其他线程再次置为 Free
+    bool append(BlockHeader* blk) noexcept;
 
     // 从游标位置开始，摘除并返回下一个空闲块
     BlockHeader* reclaimNextFree() noexcept;
@@ -24,14 +29,39 @@ public:
     // 重置游标到链表头
     void resetCursor() noexcept;
 
+    // ---- 增量清扫：游标跨调用保留，一轮清扫可以拆成任意多次小步 ----
+    // 从游标处继续，至多访问 max_visit 个节点，遇到空闲节点即摘除并返回。
+    // 走到本轮开始时的表尾后本轮结束（epoch 加一）并返回 nullptr，下一次调用从表头开始新一轮；
+    // 本轮开始后尾插的节点（包括清扫中重新挂回的）留给下一轮，一轮访问的节点数不超过开始时的表长。
+    // visited 非空时累加访问的节点数（含被摘除的）。
+    BlockHeader* sweepNextFree(std::size_t max_visit, std::size_t* visited = nullptr) noexcept;
+    bool        passInProgress() const noexcept { return in_pass_; }
+    uint64_t    epoch() const noexcept { return epoch_; }               // 已完成的完整轮数
+    std::size_t passVisited() const noexcept { return pass_visited_; } // 本轮（或刚完成的一轮）已访问的节点数
+    std::size_t passSize() const noexcept { return pass_size_; }       // 本轮开始时的节点数
+
+    // 按顺序把每个节点交给 cb 并清空整张表（线程退出时交出节点）；cb 可以改写节点的 next
+    void drain(VisitCallback cb, void* ctx) noexcept;
+
     // 状态查询
     bool empty() const noexcept;
+    std::size_t size() const noexcept { return size_; }
     BlockHeader* head() const noexcept;
     BlockHeader* tail() const noexcept;
 
 private:
+    BlockHeader* unlinkAtCursor() noexcept;   // 摘除游标所指节点，游标前驱不变
+
     BlockHeader* head_ = nullptr;
     BlockHeader* tail_ = nullptr;
     BlockHeader* cursor_prev_ = nullptr;
     BlockHeader* cursor_cur_  = nullptr;
+    std::size_t  size_ = 0;
+
+    bool         in_pass_      = false;
+    uint64_t     epoch_        = 0;
+    std::size_t  pass_visited_ = 0;
+    std::size_t  pass_size_    = 0;
+    BlockHeader* pass_end_     = nullptr;   // 本轮开始时的表尾：访问过它即本轮结束
+    bool         pass_end_seen_ = false;
 };
@@ -3,54 +3,131 @@
 #include <cstddef>
 #include <cstdint>
 #include <atomic>
-#include <mutex>
 #include <new>
+#include <thread>
 
 #include "gc_malloc/ThreadHeap/Bitmap.hpp"
+#include "gc_malloc/ThreadHeap/BlockHeader.hpp"
+#include "gc_malloc/ThreadHeap/SummaryBitmap.hpp"
 
 constexpr size_t CACHE_LINE_SIZE = 64;
 
+// 所有权模型：子池由构造它的线程独占，分配、释放与清扫都不加锁；
+// 其他线程只能经由带外释放请求（requestFree / requestFreeBatch）这条原子通道交还块。
 class alignas(CACHE_LINE_SIZE) MemSubPool {
 public:
     static constexpr size_t kPoolTotalSize = 2 * 1024 * 1024; // 2MB
     static constexpr size_t kPoolAlignment = kPoolTotalSize;
     static constexpr size_t kMinBlockSize = 32; 
     static constexpr size_t kBitMapLength = (kPoolTotalSize / kMinBlockSize + 7) / 8;
+    static constexpr size_t kBitMapWords = (kBitMapLength + 7) / 8;
     static constexpr uint32_t kPoolMagic = 0xDEADBEEF;
+    static constexpr uint32_t kNoSizeClass = UINT32_MAX;
 
 public:
-    explicit MemSubPool(size_t block_size);
+    explicit MemSubPool(size_t block_size, uint32_t size_class = kNoSizeClass);
     virtual ~MemSubPool();
 
+    // 仅所属线程：其他线程调用时返回 nullptr / 0
     void* allocate();
+    // 一次取出至多 max_count 个块（按地址升序写入 out），返回实际个数
+    size_t allocateBatch(void** out, size_t max_count);
+    // 所属线程直接释放；其他线程的调用转为释放请求，等所属线程清扫时回收
     void release(void* block_ptr);
+    void releaseBatch(void* const* blocks, size_t count);
+
+    // ---- 带外释放请求：块的释放状态记录在头部的位图中，不写入块本身 ----
+    // 任意线程：在 free-requested 位图中置位，并把 managed_node 标记为待清扫；
+    // 某个字的第一个请求还会把该字下标压入远程释放栈（一次 CAS）。
+    // 越界、未对齐或重复请求时返回 false
+    bool requestFree(const void* block_ptr);
+    bool isFreeRequested(const void* block_ptr) const;
+    // 批量请求释放本池的块：落在同一个 64 位字上的请求合并为一次原子或；返回成功登记的块数
+    size_t requestFreeBatch(void* const* blocks, size_t count);
+    // 所属线程：一次交换取走远程释放栈，只对栈中的字做 used &= ~free_requested，
+    // 返回回收的块数；其他线程调用时返回 0
+    size_t sweepFreeRequested();
+    // 是否有尚未清扫的远程释放（任意线程可调用，结果只是快照）
+    bool hasRemoteFrees() const { return remote_head_.load(std::memory_order_acquire) != 0; }
+    // 所属线程：登记远程释放通知。远程释放栈由空变为非空时，释放方在 *word 上置 bit；
+    // word 为 nullptr 时取消。通知只是提示，可能多报（位已复用）或晚到，使用方需自行核实
+    void setRemoteNotice(std::atomic<uint64_t>* word, uint64_t bit);
+    uint64_t getRemoteNoticeBit() const { return remote_notice_bit_.load(std::memory_order_relaxed); }
+
+    bool isOwnedByCurrentThread() const {
+        return owner_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+    }
+    // 把所有权移交给当前线程（原所属线程已不再访问本池时才可调用）
+    void adoptByCurrentThread();
 
     bool isFull() const;
     bool isEmpty() const;
     size_t getBlockSize() const;
+    // bump 模式的分配边界：下标 >= bump 的块从未分配过，位图与释放请求位图中对应的位无意义
+    size_t getBumpIndex() const { return bump_index_.load(std::memory_order_acquire); }
+    uint32_t getSizeClass() const { return size_class_; }   // 所属 size-class 下标，供回收时直接分派
+    size_t getDataOffset() const { return data_offset_; }   // 数据区相对子池基址的偏移；之前是头部与位图
+
+    // 返回包含 ptr 的块起始地址（ptr 可以是块内部指针）；不在数据区内返回 nullptr
+    void* blockOf(const void* ptr) const;
+
+    // 判断 2MB 对齐的基址处是否是一个存活的 MemSubPool（依据魔数）
+    static bool isPoolHeader(const void* base);
 
 public:
     MemSubPool* list_prev = nullptr;
     MemSubPool* list_next = nullptr;
 
+    // ManagedList 中代表整个子池的节点：状态为 Free 表示有待清扫的释放请求
+    BlockHeader managed_node{BlockState::Used};
+    bool in_managed_list = false;
+
 private:
     static size_t calculateDataOffset();
     static size_t calculateTotalBlockCount(size_t block_size, size_t data_offset);
 
+    void releaseOwned(void* block_ptr);
+    size_t allocateOwned(void** out, size_t max_count);
+    size_t takeFreedBlocks(void** out, size_t max_count, size_t bump);   // 复用 bump 之下已释放的块
+    void resetIfEmpty();                           // 全部空闲时回到 bump 模式
+    void pushRemoteWord(size_t word);              // 释放方：把刚变为非零的字压入远程释放栈
+    void notifyRemoteFrees();                      // 释放方：远程释放栈由空变为非空时置通知位
+    size_t drainRemoteFrees();                     // 所属线程：取走整个远程释放栈并回收
+    size_t indexOf(const void* block_ptr) const;   // 块首 -> 下标；非法指针或从未分配过的块返回 SIZE_MAX
+
     MemSubPool(const MemSubPool&) = delete;
     MemSubPool& operator=(const MemSubPool&) = delete;
     MemSubPool(MemSubPool&&) = delete;
     MemSubPool& operator=(MemSubPool&&) = delete;
 
 private:
-    const uint32_t magic_;
-    std::mutex lock_;
+    uint32_t magic_;
+    const uint32_t size_class_;
+    std::atomic<std::thread::id> owner_;
 
     const size_t block_size_;
     const size_t data_offset_;
     const size_t total_block_count_;
     std::atomic<size_t> used_block_count_;
-    size_t next_free_block_hint_;
+    // 新子池从 bump_index_ 顺序切块；之下被释放的块经摘要位图复用。
+    // 只由所属线程推进，其他线程读取它来校验释放请求
+    std::atomic<size_t> bump_index_;
+
+    // 与 bitmap_ 逐位对应；只由释放方置位、由所属线程清扫时整字交换清零。
+    // 与 bitmap_ 一样不在构造时清零：bump 进入某个字时才把该字清零
+    std::atomic<uint64_t> free_requested_[kBitMapWords];
+
+    // 远程释放栈（多生产者、单消费者）：节点是 free_requested_ 的字下标，链接放在 remote_next_ 中，
+    // 值为“下标 + 1”，0 表示栈底。字只在从 0 变为非零时入栈，所属线程整栈交换后逐字清零，
+    // 因此同一个字不会同时出现在栈中两次，回收代价只与被释放过的字数有关。
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> remote_head_;
+    std::atomic<uint16_t> remote_next_[kBitMapWords];
+    // 远程释放通知（见 setRemoteNotice）：释放方只在栈由空变为非空时读取
+    std::atomic<std::atomic<uint64_t>*> remote_notice_word_;
+    std::atomic<uint64_t>               remote_notice_bit_;
+
+    // bitmap_ 各 64 位字的两级摘要：分配时两次 ctz 定位含空闲位的字，不随占用率退化
+    SummaryBitmap summary_;
 
     unsigned char bitmap_buffer_[kBitMapLength];
     Bitmap bitmap_;
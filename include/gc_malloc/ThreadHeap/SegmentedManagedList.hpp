@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "BlockHeader.hpp"
+
+// 分段数组形式的 ManagedList：节点指针按插入顺序存放在一串定长段里（每段一页），
+// 清扫时顺序读段内数组，并提前 kPrefetchDistance 个条目预取节点的状态字，
+// 不再沿着散布在整个堆里的 next 指针逐个跳转。
+// 存活的条目在清扫过程中向前压实，一轮结束后释放尾部多出的空段。
+// 增量清扫接口与 ManagedList 相同（持久游标、回绕、epoch）；段内存经由回调获取与归还。
+// 特性：单线程使用，无需加锁；并行清扫的判定阶段（scanShared）可以在多个线程上同时执行
+class SegmentedManagedList {
+public:
+    static constexpr std::size_t kSegmentBytes     = 4096;
+    static constexpr std::size_t kPrefetchDistance = 8;
+
+    using SegmentAllocCallback = void* (*)(void* ctx) noexcept;            // 返回 kSegmentBytes 字节、8 字节对齐的内存
+    using SegmentFreeCallback  = void  (*)(void* ctx, void* seg) noexcept;
+    using ReclaimCallback      = bool  (*)(void* ctx, BlockHeader* blk) noexcept;   // 返回 true 表示节点留在表中
+    using VisitCallback        = void  (*)(void* ctx, BlockHeader* blk) noexcept;
+
+public:
+    SegmentedManagedList(SegmentAllocCallback alloc_cb, SegmentFreeCallback free_cb, void* ctx) noexcept;
+    virtual ~SegmentedManagedList();
+
+    SegmentedManagedList(const SegmentedManagedList&) = delete;
+    SegmentedManagedList& operator=(const SegmentedManagedList&) = delete;
+    SegmentedManagedList(SegmentedManagedList&&) = delete;
+    SegmentedManagedList& operator=(SegmentedManagedList&&) = delete;
+
+    // 尾插；段内存申请失败时返回 false（节点不会被跟踪）
+    bool appendUsed(BlockHeader* blk) noexcept;
+    bool append(BlockHeader* blk) noexcept;
+
+    // 从游标处继续，至多访问 max_visit 个条目，遇到空闲节点即移出并返回；
+    // 走到本轮开始时的末尾时本轮结束（epoch 加一、压实并释放多余的段）并返回 nullptr，下一次调用从头开始新一轮。
+    // 本轮开始后追加的条目（包括清扫中重新挂回的）留给下一轮
+    BlockHeader* sweepNextFree(std::size_t max_visit, std::size_t* visited = nullptr) noexcept;
+    bool        passInProgress() const noexcept { return in_pass_; }
+    uint64_t    epoch() const noexcept { return epoch_; }
+    std::size_t passVisited() const noexcept { return pass_visited_; }
+    std::size_t passSize() const noexcept { return pass_size_; }
+
+    // ---- 并行清扫：整表按段切分给多个线程判定，再由所属线程一次性应用结果 ----
+    // 所属线程先调用 beginParallelScan()（放弃进行中的增量轮次，表恢复紧凑）；
+    // 各参与线程（含所属线程）随后调用 scanShared()，领取尚未判定的段，把空闲条目划分到段尾；
+    // 全部返回后所属线程调用 finishParallelScan()：对每个空闲条目调用 cb，压实存活条目并释放多余的段，
+    // 算作完成一轮（epoch 加一），返回移出的节点数。从 begin 到 finish 期间不得追加或增量清扫。
+    void        beginParallelScan() noexcept;
+    std::size_t scanShared() noexcept;   // 返回本线程判定的条目数
+    std::size_t finishParallelScan(ReclaimCallback cb, void* ctx) noexcept;
+
+    // 按顺序把每个条目交给 cb 并清空整张表，段全部归还（线程退出时交出节点）
+    void        drain(VisitCallback cb, void* ctx) noexcept;
+
+    bool        empty() const noexcept { return size_ == 0; }
+    std::size_t size() const noexcept { return size_; }
+    std::size_t segmentCount() const noexcept { return segment_count_; }
+
+private:
+    struct Segment {
+        Segment*     next;
+        std::size_t  count;   // 有效条目数；清扫中途只对读游标之后的段有意义
+        std::size_t  freed;   // 并行判定后位于段尾的空闲条目数
+        BlockHeader* entries[1];
+    };
+    static constexpr std::size_t kSegmentEntries =
+        (kSegmentBytes - offsetof(Segment, entries)) / sizeof(BlockHeader*);
+
+    Segment* newSegment() noexcept;
+    void     beginPass() noexcept;
+    void     finishPass() noexcept;
+    void     trimAfterWrite() noexcept;   // 把写游标处定为新的表尾，释放其后的段
+    void     abandonPass() noexcept;      // 放弃进行中的一轮，表恢复紧凑（不计入 epoch）
+    void     keepUnread() noexcept;       // 读游标之后的条目原样搬到写游标处（只拷贝指针，不访问节点）
+    std::size_t partitionSegment(Segment* seg) noexcept;   // 存活条目保序前移，空闲条目放到段尾
+    void     keep(BlockHeader* blk) noexcept;   // 存活条目写到写游标处
+
+    SegmentAllocCallback alloc_cb_;
+    SegmentFreeCallback  free_cb_;
+    void*                ctx_;
+
+    Segment*    head_ = nullptr;
+    Segment*    tail_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t segment_count_ = 0;
+
+    // 清扫游标：读位置之前的存活条目已压实到写位置之前
+    Segment*    read_seg_   = nullptr;
+    std::size_t read_idx_   = 0;
+    Segment*    write_seg_  = nullptr;
+    Segment*    write_prev_ = nullptr;   // 写段的前一段，用于一轮结束时释放空的写段
+    std::size_t write_idx_  = 0;
+    Segment*    end_seg_    = nullptr;   // 本轮开始时的表尾段与其条目数：读到这里本轮结束
+    std::size_t end_idx_    = 0;
+
+    bool         in_pass_      = false;
+    uint64_t     epoch_        = 0;
+    std::size_t  pass_visited_ = 0;
+    std::size_t  pass_size_    = 0;
+
+    std::atomic<Segment*> scan_next_{nullptr};   // 并行判定：下一个待领取的段
+};
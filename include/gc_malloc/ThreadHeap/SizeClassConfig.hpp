@@ -9,9 +9,17 @@ public:
     // ---- 编译期常量（策略相关）----
     static constexpr std::size_t kMinAlloc       = 32;                   // 最小请求按 32B 处理
     static constexpr std::size_t kAlignment      = 16;                   // 基本对齐
-    static constexpr std::size_t kMaxSmallAlloc  = 1u * 1024u * 1024u;   // 小对象上限（> 则走大对象路径）
+    static constexpr std::size_t kMaxSmallAlloc  = 1u * 1024u * 1024u;   // size-class 表上限
     static constexpr std::size_t kChunkSizeBytes = 2u * 1024u * 1024u;   // 与 CentralHeap 保持一致
 
+    // ---- 分配路径划分 ----
+    // (0, kMaxPooledAlloc]              : size-class 子池（MemSubPool）
+    // (kMaxPooledAlloc, kMaxMediumAlloc] : 共享 chunk 上的 4KB 页段（PageRunAllocator）
+    // (kMaxMediumAlloc, ...)             : 独占的多 chunk 映射（LargeObject）
+    static constexpr std::size_t kPageSize       = 4096;
+    static constexpr std::size_t kMaxPooledAlloc = 64u * 1024u;
+    static constexpr std::size_t kMaxMediumAlloc = kChunkSizeBytes - kPageSize;   // chunk 首页存放页段头部
+
     static constexpr std::size_t kClassCount = 59;
 
     static constexpr std::size_t ClassCount() noexcept { return kClassCount; }
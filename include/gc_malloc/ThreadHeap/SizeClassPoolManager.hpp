@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 
@@ -29,7 +30,28 @@ public:
     void setReturnCallback(ReturnCallback cb, void* ctx) noexcept;
 
     void* allocateBlock() noexcept;
+    // 批量分配至多 count 个块（供线程缓存补货）：每个子池只查找一次空闲位，返回实际个数
+    std::size_t allocateBlocks(void** out, std::size_t count) noexcept;
     bool  releaseBlock(void* ptr) noexcept;
+    // 批量释放同一子池内的 count 个块：链表迁移只做一次
+    bool  releaseBlocks(MemSubPool* pool, void* const* blocks, std::size_t count) noexcept;
+    // 清扫子池中带外记录的释放请求并迁移链表，返回回收的块数；
+    // pool_emptied 非空时写入子池是否已全部空闲（此时子池可能已被交还，调用方不能再访问）
+    std::size_t reclaimFreeRequested(MemSubPool* pool, bool* pool_emptied = nullptr) noexcept;
+
+    // ---- 线程退出与认领 ----
+    // 交出全部子池：空子池经归还回调交还，仍有在用块的子池逐个交给 orphan_cb
+    void        abandonPools(ReturnCallback orphan_cb, void* ctx) noexcept;
+    // 认领其他线程留下的子池：转为当前线程所有，清扫其释放请求后按状态挂链，返回回收的块数；
+    // pool_emptied 的含义同 reclaimFreeRequested
+    std::size_t adoptPool(MemSubPool* pool, bool* pool_emptied = nullptr) noexcept;
+    // 整个管理器被新线程接管（ThreadHeap 实例回收）：所有子池转为当前线程所有
+    void        adoptAllByCurrentThread() noexcept;
+
+    // ---- 空子池衰减（由所属线程按 dirty 衰减时间周期性调用）----
+    // 上次调用以来 empty_ 从未低于 low 个：把这 low 个整段时间都没被取用的空子池经归还回调交出，
+    // 在 CentralHeap 的已格式化子池缓存里按时间交还物理页。返回交出的子池数
+    std::size_t releaseIdleEmptyPools() noexcept;
 
     std::size_t getBlockSize()        const noexcept;
     std::size_t getPoolCountEmpty()   const noexcept;
@@ -37,6 +59,8 @@ public:
     std::size_t getPoolCountFull()    const noexcept;
 
     bool ownsPointer(const void* ptr) const noexcept;
+    // 下一次分配是否要经由回调补充新子池（partial 与 empty 都已空）
+    bool needsRefill() const noexcept { return partial_.empty() && empty_.empty(); }
 
 private:
     static inline bool poolIsEmpty(const MemSubPool* p) noexcept;
@@ -44,10 +68,18 @@ private:
 
     static MemSubPool* ptrToOwnerPool(const void* block_ptr) noexcept;
 
+    void relinkAfterRelease(MemSubPool* pool, bool was_full) noexcept;
+
     void refillEmptyPools() noexcept; // empty 为空则补齐到 kTargetEmptyWatermark
+    void noteEmptyLow() noexcept;     // empty_ 缩小后更新低水位
     void trimEmptyPools() noexcept;   // empty 超过最高水位则回落到目标水位
 
     MemSubPool* acquireUsablePool() noexcept;
+    MemSubPool* takeFullPoolWithRemoteFrees() noexcept;   // 摘下一个有远程释放的满子池并清扫
+
+    // full_ 的进出都经由这两个函数：入链时分配通知槽，出链时归还
+    void pushFull(MemSubPool* pool) noexcept;
+    void removeFull(MemSubPool* pool) noexcept;
 
 private:
     const std::size_t block_size_;
@@ -55,6 +87,15 @@ private:
     MemSubPoolList empty_;
     MemSubPoolList partial_;
     MemSubPoolList full_;
+    std::size_t    empty_low_water_ = 0;   // 上次 releaseIdleEmptyPools 以来 empty_ 的最小长度
+
+    // 满子池的远程释放通知：每个槽对应 full_ 中的一个子池，远程释放栈由空变为非空时
+    // 释放方在 notice_pending_ 上置位，补货时只看置位的槽，不必遍历 full_。
+    // 槽用完后入链的子池不登记，它们的远程释放留给 GC 清扫回收
+    static constexpr std::size_t kNoticeSlots = 64;
+    MemSubPool*           notice_slots_[kNoticeSlots] = {};
+    std::uint64_t         notice_used_ = 0;          // 仅所属线程读写
+    std::atomic<uint64_t> notice_pending_{0};
 
     RefillCallback refill_cb_  = nullptr;
     ReturnCallback return_cb_  = nullptr;
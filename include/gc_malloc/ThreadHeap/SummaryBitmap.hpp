@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// 分层摘要位图：为一个 Bitmap 的 64 位字建立两级索引，
+//   level1_[i] 的第 j 位 = 第 i*64+j 个叶字中还有空闲位
+//   root_      的第 i 位 = level1_[i] 不为 0
+// 查找第一个含空闲位的叶字只需两次 ctz；叶字变化时由调用方通过 update() 同步。
+// 不加锁，只由持有者（MemSubPool）的所属线程维护。
+class SummaryBitmap {
+public:
+    static constexpr std::size_t kMaxLeafWords = 64 * 64;
+    static constexpr std::size_t k_not_found   = static_cast<std::size_t>(-1);
+
+public:
+    // 初始状态下所有叶字都视为“已满”，由调用方按叶字实际内容 update()
+    explicit SummaryBitmap(std::size_t leaf_words) noexcept;
+    ~SummaryBitmap() = default;
+
+    SummaryBitmap(const SummaryBitmap&)            = delete;
+    SummaryBitmap& operator=(const SummaryBitmap&) = delete;
+
+    void reset() noexcept;   // 回到“全部已满”
+    void markHasFree(std::size_t leaf_index) noexcept;
+    void markFull(std::size_t leaf_index) noexcept;
+    // 按叶字的当前值（1 = 占用）更新摘要
+    void update(std::size_t leaf_index, std::uint64_t leaf_word) noexcept {
+        if (~leaf_word != 0) markHasFree(leaf_index);
+        else                 markFull(leaf_index);
+    }
+
+    bool        hasFree(std::size_t leaf_index) const noexcept;
+    std::size_t findFirstWithFree() const noexcept;   // 第一个含空闲位的叶字下标
+    std::size_t leafWords() const noexcept { return leaf_words_; }
+
+private:
+    std::size_t   leaf_words_;
+    std::uint64_t root_;
+    std::uint64_t level1_[kMaxLeafWords / 64];
+};
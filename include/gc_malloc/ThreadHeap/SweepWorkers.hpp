@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// 并行清扫的常驻工作线程组（进程内唯一，永不销毁）。
+// 工作线程只执行调用方交来的判定任务，自身从不经过分配器；
+// 线程按需创建，创建时 pthread 可能经由 malloc 回到分配器，因此由 prepare() 在清扫开始前完成。
+// 一次只服务一个调用方：其他线程正在使用时，run() 退化为只在调用线程上执行。
+class SweepWorkers {
+public:
+    static constexpr std::size_t kMaxHelpers = 15;
+
+    using Task = void (*)(void* ctx) noexcept;
+
+    static SweepWorkers& GetInstance() noexcept;
+
+    // 确保至多 helpers 个工作线程已启动；返回就绪的线程数（线程创建失败时可能少于请求数）
+    std::size_t prepare(std::size_t helpers) noexcept;
+
+    // 在调用线程与至多 helpers 个已就绪的工作线程上各执行一次 task(ctx)，全部返回后才返回；
+    // 任务需自行领取工作（调用线程先做完时，尚未醒来的工作线程不再参与）。返回参与的工作线程数
+    std::size_t run(std::size_t helpers, Task task, void* ctx) noexcept;
+
+    SweepWorkers(const SweepWorkers&)            = delete;
+    SweepWorkers& operator=(const SweepWorkers&) = delete;
+
+private:
+    SweepWorkers() noexcept = default;
+
+    static void* workerMain(void* self) noexcept;
+
+    std::mutex  run_mutex_;   // 串行化 prepare / run
+    std::size_t started_ = 0; // 受 run_mutex_ 保护
+
+    // 以下受 mutex_ 保护
+    std::mutex              mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable done_cv_;
+    std::uint64_t generation_ = 0;   // 每发布一个任务加一
+    std::size_t   slots_      = 0;   // 本任务还可加入的工作线程数
+    std::size_t   running_    = 0;   // 正在执行本任务的工作线程数
+    Task          task_       = nullptr;
+    void*         ctx_        = nullptr;
+};
@@ -1,16 +1,21 @@
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <new>
 #include <type_traits>
 
 #include "gc_malloc/ThreadHeap/SizeClassPoolManager.hpp"
+#include "gc_malloc/ThreadHeap/BlockCache.hpp"
 #include "gc_malloc/ThreadHeap/ManagedList.hpp"
+#include "gc_malloc/ThreadHeap/SegmentedManagedList.hpp"
 #include "gc_malloc/ThreadHeap/BlockHeader.hpp"
 #include "gc_malloc/ThreadHeap/SizeClassConfig.hpp"
 
 class MemSubPool;
+class LargeObject;
+class DeadlineClock;
 
 /**
  * ThreadHeap
@@ -21,16 +26,79 @@ class ThreadHeap {
 public:
     // --------------------- 对外公共接口 ---------------------
     static void*        allocate(std::size_t nbytes) noexcept;
-    static void         deallocate(void* ptr) noexcept;
+    static void         deallocate(void* ptr) noexcept;           // ptr 可以是块内部指针
+    // 清扫 ManagedList，回收跨线程释放与线程缓存回吐的块；留在线程缓存中的块不计入。
+    // 游标跨调用保留：至多访问 max_scan 个节点，一轮走到表尾即返回，下次调用回绕到表头。
+    // 不限预算时保证覆盖整张表（游标在中途时先走完本轮，再完整走一轮）。
+    // 与自动 GC 一样，顺带把闲置满一个 dirty 衰减时间的空子池交给 CentralHeap 衰减
     static std::size_t  garbageCollect(std::size_t max_scan = SIZE_MAX) noexcept;
 
+    // 限时清扫：同样从持久游标继续，每访问 kDeadlineCheckInterval 个节点、以及每回收一个节点后
+    // 读一次廉价时钟（TSC），超时即返回部分结果；max_visit 另外限制访问的节点数。
+    // 单个节点的回收（子池清扫、交还映射）不可中断，超时至多超出一次回收的耗时。
+    struct GcSlice {
+        std::size_t visited;          // 本次访问的节点数
+        std::size_t reclaimed;        // 本次回收的块数
+        bool        pass_completed;   // 本次是否走完了一轮
+    };
+    static constexpr std::size_t kDeadlineCheckInterval = 256;
+    static GcSlice      garbageCollectFor(std::chrono::nanoseconds budget,
+                                          std::size_t max_visit = SIZE_MAX) noexcept;
+
+    // 当前线程增量清扫的进度（本轮，或刚完成的一轮）
+    struct SweepProgress {
+        std::uint64_t epoch;       // 已完成的完整轮数
+        std::size_t   visited;     // 本轮已访问的节点数
+        std::size_t   reclaimed;   // 本轮已回收的块数
+        std::size_t   list_size;   // ManagedList 当前的节点数
+        double        percent;     // 本轮覆盖的比例（0~100），一轮完成时为 100
+    };
+    static SweepProgress sweepProgress() noexcept;
+
+    // 并行清扫：ManagedList 按段切分给调用线程与至多 threads-1 个常驻工作线程，并行找出空闲节点；
+    // 回收（子池释放请求的应用、页段与映射的归还）仍由调用线程一次完成。
+    // 完成一整轮（进行中的增量轮次并入本轮），返回回收的块数。threads 为 0 时取在线 CPU 数；
+    // 节点数少于 kParallelSweepMinNodes、只有一个线程或使用链表实现时退化为 garbageCollect()
+    static constexpr std::size_t kParallelSweepMinNodes = 1024;
+    static std::size_t  garbageCollectParallel(std::size_t threads = 0) noexcept;
+
+    // ---- 自动 GC：慢路径上累计“分配债务”，达到阈值或即将向 CentralHeap 补充子池时，
+    //      在 allocate 内做一次有界的增量清扫；应用无需自己调用 garbageCollect ----
+    static constexpr std::size_t kDefaultGcDebtBytes  = 8 * 1024 * 1024;   // 上次清扫后新分配的字节数
+    static constexpr std::size_t kDefaultGcDebtBlocks = 4096;              // 已释放、尚未回收的块数
+    static constexpr std::size_t kAutoGcScanBudget    = 256;               // 每次自动清扫至多回收的节点数
+    // 设置全局触发阈值（对所有线程生效）；某项为 0 表示不按该项触发，补充子池前的清扫不受影响
+    static void         setGcDebtThreshold(std::size_t bytes, std::size_t blocks) noexcept;
+
+    // ---- 实例回收：退出线程的 ThreadHeap 连同子池、线程缓存与跟踪表原样挂入全局空闲表，
+    //      新线程创建实例时直接接管，不必逐个 size-class 向 CentralHeap 补充子池；
+    //      空闲表已满时才析构实例，把子池与块交给孤儿队列 ----
+    static constexpr std::size_t kDefaultRetiredHeapLimit = 8;
+    // 空闲表容量（对所有线程生效）；0 表示不回收实例。调小时多出的实例立即析构
+    static void         setRetiredHeapLimit(std::size_t n) noexcept;
+
+    // ---- 指针查询（供 malloc 替换层使用；ptr 可以是块内部指针）----
+    static void*        blockStart(const void* ptr) noexcept;   // 所在块起始地址
+    static BlockState   blockState(const void* ptr) noexcept;   // 带外记录的块状态（诊断/测试用）
+    static std::size_t  usableSize(const void* ptr) noexcept;   // ptr 到块末尾的可用字节数
+
     ThreadHeap(const ThreadHeap&)            = delete;
     ThreadHeap& operator=(const ThreadHeap&) = delete;
     ThreadHeap(ThreadHeap&&)                 = delete;
     ThreadHeap& operator=(ThreadHeap&&)      = delete;
 
 private:
-    static ThreadHeap& local() noexcept;
+    // 当前线程的实例；首次调用时惰性创建，创建失败（内存耗尽）返回 nullptr
+    static ThreadHeap* local() noexcept;
+    static ThreadHeap* createForCurrentThread() noexcept;
+    static void        destroyAtThreadExit(void* heap) noexcept;   // pthread key 析构回调
+    static ThreadHeap* takeRetired() noexcept;                    // 从空闲表取一个实例，空时返回 nullptr
+    static void        destroyRetired(ThreadHeap* th) noexcept;     // 由当前线程接管后析构并归还槽位
+    void               adoptByCurrentThread() noexcept;             // 接管退役实例：子池转为当前线程所有
+    // 退役前的收尾：线程缓存里的块存入传输缓存或交回子池，再做一次有界清扫，
+    // 空闲表里的实例只保留热的子池，不扣住已释放、尚未回收的内存
+    static constexpr std::size_t kRetireScanBudget = 4096;   // 退役清扫至多访问的节点数
+    void               prepareForRetirement() noexcept;
 
     ThreadHeap() noexcept;
     virtual ~ThreadHeap();
@@ -41,9 +109,45 @@ private:
     static MemSubPool* refillFromCentral_cb(void* ctx) noexcept;                 // 获取新子池
     static void        returnToCentral_cb(void* ctx, MemSubPool* p) noexcept; // 归还空子池
 
+    // ---- 与 SegmentedManagedList 的回调桥：段内存取自 CentralHeap 的单页页段 ----
+    static void*       listSegmentAlloc_cb(void* ctx) noexcept;
+    static void        listSegmentFree_cb(void* ctx, void* seg) noexcept;
+    static bool        reclaimNode_cb(void* ctx, BlockHeader* node) noexcept;   // 并行清扫的应用阶段
+
+    // ---- 中等对象路径（SizeClassConfig::kMaxPooledAlloc, kMaxMediumAlloc]）----
+    void*       allocateMedium(std::size_t nbytes) noexcept;
+
+    // ---- 大对象路径（> SizeClassConfig::kMaxMediumAlloc）----
+    void*       allocateLarge(std::size_t nbytes) noexcept;
+    static void releaseLarge(LargeObject* obj) noexcept;
+
+    // ---- 线程缓存（tcache）：小对象分配与同线程释放的快速路径 ----
+    void*       refillCache(std::size_t class_idx) noexcept;             // 缓存为空：按批补货并返回一块
+    void        cacheFree(std::size_t class_idx, void* blk) noexcept;    // 同线程释放：压入缓存，溢出时回吐
+    std::size_t spillToTransfer(std::size_t class_idx, std::size_t n) noexcept;   // 至多 n 块存入传输缓存，返回存入个数
+    void        flushCache(std::size_t class_idx, std::size_t n) noexcept;
+    void        flushAllCaches() noexcept;
+
     // ---- 小工具 ----
-    void        attachUsed(BlockHeader* blk) noexcept;
-    std::size_t reclaimBatch(std::size_t max_scan) noexcept;
+    void        trackPoolOf(void* blk) noexcept;   // 子池首次有块被取出时挂入 ManagedList
+    bool        attachUsed(BlockHeader* blk) noexcept;   // 段内存耗尽时返回 false
+    std::size_t reclaimBatch(std::size_t max_scan, const DeadlineClock* deadline = nullptr,
+                             std::size_t* visited_out = nullptr) noexcept;
+    // 回收一个空闲节点，返回回收的块数；子池清扫后仍有在用块时经 still_used 返回该子池，节点应留在表中
+    std::size_t reclaimNode(BlockHeader* node, MemSubPool** still_used) noexcept;
+    std::size_t reclaimPool(MemSubPool* pool, bool* emptied) noexcept;   // 清扫单个子池的释放请求
+
+    // ---- 自动 GC ----
+    void        chargeDebt(std::size_t bytes, std::size_t blocks) noexcept;   // 累计债务，超过阈值即清扫
+    void        autoCollect() noexcept;                                     // 有界增量清扫并清零债务
+    // 每过一个 dirty 衰减时间，把各 size-class 整段时间都没被取用的空子池交给 CentralHeap 衰减
+    void        decayEmptyPools() noexcept;
+
+    // ---- 孤儿：线程退出时交出，存活线程在补充子池 / 自动 GC 时认领 ----
+    static constexpr std::size_t kOrphanAdoptBatch = 4;   // 每次补充至多认领的孤儿子池数
+    void        orphanAll() noexcept;                              // 交出仍有在用块的子池与跟踪中的块
+    void        adoptOrphanPools(std::size_t class_idx) noexcept;  // 认领同 size-class 的孤儿子池，直到有可用子池
+    void        adoptOrphanBlocks() noexcept;                      // 认领孤儿块：已释放的立即回收，其余挂入本线程的表
 
 private:
     // 编译期常量（来自 SizeClassConfig.hpp，必须是 constexpr）
@@ -54,6 +158,10 @@ private:
         std::aligned_storage_t<sizeof(SizeClassPoolManager), alignof(SizeClassPoolManager)>;
     ManagerStorage managers_storage_[k_class_count];
 
+    using CacheStorage =
+        std::aligned_storage_t<sizeof(BlockCache), alignof(BlockCache)>;
+    CacheStorage caches_storage_[k_class_count];
+
     // 便捷访问封装
     static SizeClassPoolManager& at(ManagerStorage& s) noexcept {
         return *reinterpret_cast<SizeClassPoolManager*>(&s);
@@ -61,6 +169,25 @@ private:
     static const SizeClassPoolManager& at(const ManagerStorage& s) noexcept {
         return *reinterpret_cast<const SizeClassPoolManager*>(&s);
     }
+    static BlockCache& at(CacheStorage& s) noexcept {
+        return *reinterpret_cast<BlockCache*>(&s);
+    }
+
+#ifdef GC_MALLOC_LINKED_MANAGED_LIST
+    using TrackingList = ManagedList;
+    TrackingList managed_list_;
+#else
+    using TrackingList = SegmentedManagedList;
+    TrackingList managed_list_{&ThreadHeap::listSegmentAlloc_cb, &ThreadHeap::listSegmentFree_cb, nullptr};
+#endif
+
+    // 上次清扫以来的分配字节数 / 已释放未回收的块数（只统计本线程可见的部分）
+    std::size_t debt_bytes_  = 0;
+    std::size_t debt_blocks_ = 0;
+
+    std::size_t pass_reclaimed_ = 0;   // 当前（或刚完成的）一轮清扫回收的块数
+
+    std::uint64_t empty_decay_start_ns_ = 0;   // 空子池衰减的当前窗口起点（steady_clock 纳秒）
 
-    ManagedList managed_list_;
+    ThreadHeap* retired_next_ = nullptr;   // 挂在退役空闲表中时的链接
 };
@@ -3,6 +3,7 @@
 #include <gc_malloc/CentralHeap/sys/mman.hpp> 
 #include <cassert>
 #include <cerrno>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 
@@ -51,6 +52,29 @@ void* AlignedChunkAllocatorByMmap::allocate(size_t size) {
     return reinterpret_cast<void*>(aligned_addr);
 }
 
+size_t AlignedChunkAllocatorByMmap::allocateBatch(size_t chunk_size, size_t count, void** out) {
+    assert(chunk_size > 0 && chunk_size % kAlignmentSize == 0 &&
+            "Allocation size must be a positive multiple of kAlignmentSize (2MB)");
+
+    if (count == 0 || out == nullptr) {
+        return 0;
+    }
+    if (count > SIZE_MAX / chunk_size - 1) {
+        return 0;
+    }
+
+    // 复用单次分配的“多映射再裁剪”逻辑：整批只有一次 mmap 和两次 munmap
+    char* base = static_cast<char*>(allocate(chunk_size * count));
+    if (base == nullptr) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = base + i * chunk_size;
+    }
+    return count;
+}
+
 void AlignedChunkAllocatorByMmap::deallocate(void* ptr,size_t size) {
     assert(ptr != nullptr && "Cannot deallocate a null pointer.");
     assert(size > 0 && "Deallocation size must be positive.");
@@ -1,41 +1,132 @@
 #include "gc_malloc/CentralHeap/CentralHeap.hpp"
 
 #include "gc_malloc/CentralHeap/AlignedChunkAllocatorByMmap.hpp"
+#include "gc_malloc/CentralHeap/FormattedPoolCache.hpp"
 #include "gc_malloc/CentralHeap/FreeChunkListCache.hpp"
+#include "gc_malloc/CentralHeap/LockFreeChunkCache.hpp"
+#include "gc_malloc/CentralHeap/LargeChunkCache.hpp"
+#include "gc_malloc/CentralHeap/PageRunAllocator.hpp"
+#include "gc_malloc/CentralHeap/PageMap.hpp"
+#include "gc_malloc/CentralHeap/ReservedArenaChunkAllocator.hpp"
+#include "gc_malloc/CentralHeap/RetainedChunkCache.hpp"
+#include "gc_malloc/CentralHeap/TransferCache.hpp"
+#include "gc_malloc/ThreadHeap/BlockHeader.hpp"
+#include "gc_malloc/ThreadHeap/SizeClassConfig.hpp"
 
+#include <gc_malloc/CentralHeap/sys/mman.hpp>
+
+#include <algorithm>
 #include <new>
 #include <type_traits>
 #include <cassert>
 #include <iostream>
+#include <pthread.h>
+
+static_assert(SizeClassConfig::kClassCount <= CentralHeap::kOrphanClassSlots,
+              "every size class needs an orphan pool queue");
+static_assert(SizeClassConfig::kClassCount <= CentralHeap::kTransferClassSlots,
+              "every size class needs a transfer cache");
 
 // -----------------------------------------------------------------------------
 // 1. 在编译时，在 .bss 段为我们的核心组件预留静态内存。
 //    这些全局静态变量保证了它们的生命周期与程序相同，并且不依赖于堆分配。
 // -----------------------------------------------------------------------------
 
-static std::aligned_storage<sizeof(AlignedChunkAllocatorByMmap),
-                            alignof(AlignedChunkAllocatorByMmap)>::type g_kernel_allocator_buffer;
+// 两种 chunk 来源共用一块存储，由构造参数决定放置哪一种
+static std::aligned_union<0, AlignedChunkAllocatorByMmap,
+                          ReservedArenaChunkAllocator>::type g_kernel_allocator_buffer;
+
+// 两种 chunk 缓存实现共用一块存储，由构造参数决定放置哪一种
+static std::aligned_union<0, FreeChunkListCache, LockFreeChunkCache>::type g_chunk_cache_buffer;
+
+static std::aligned_storage<sizeof(LargeChunkCache),
+                            alignof(LargeChunkCache)>::type g_large_cache_buffer;
+
+static std::aligned_storage<sizeof(FormattedPoolCache),
+                            alignof(FormattedPoolCache)>::type g_formatted_pool_buffer;
+
+static std::aligned_storage<sizeof(RetainedChunkCache),
+                            alignof(RetainedChunkCache)>::type g_retained_cache_buffer;
+
+static std::aligned_storage<sizeof(PageRunAllocator),
+                            alignof(PageRunAllocator)>::type g_page_run_buffer;
+
+// 每个 size-class 一个传输缓存，逐个 placement new（避免数组 new 的额外头部）
+static std::aligned_storage<sizeof(TransferCache),
+                            alignof(TransferCache)>::type g_transfer_cache_buffer[CentralHeap::kTransferClassSlots];
+
+// CentralHeap 自身也放在静态存储上：不注册 atexit 析构（__cxa_atexit 可能回调 calloc），
+// 作为 malloc 替换库使用时可以在任何分配发生之前安全地完成初始化。
+static std::aligned_storage<sizeof(CentralHeap),
+                            alignof(CentralHeap)>::type g_central_heap_buffer;
 
-static std::aligned_storage<sizeof(FreeChunkListCache),
-                            alignof(FreeChunkListCache)>::type g_chunk_cache_buffer;
 
+namespace {
+
+// 衰减计时用单调时钟（vDSO，不陷入内核）
+uint64_t nowNs() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t toNs(std::chrono::milliseconds ms) noexcept {
+    return ms.count() <= 0 ? 0 : static_cast<uint64_t>(ms.count()) * 1000000u;
+}
+
+} // namespace
 
 // -----------------------------------------------------------------------------
 // 2. CentralHeap 的构造/析构函数和单例实现
 // -----------------------------------------------------------------------------
 
 CentralHeap& CentralHeap::GetInstance() {
-    // Meyers' Singleton: C++11 保证了函数内静态变量的线程安全初始化。
-    // instance 本身也会被存放在 BSS/DATA 段。
-    static CentralHeap instance;
-    return instance;
+    // 函数内静态变量的初始化由 C++11 保证线程安全；
+    // 静态量本身是平凡的指针，因此不会注册析构函数，实例永不销毁。
+    static CentralHeap* const instance = new (&g_central_heap_buffer) CentralHeap(kDefaultChunkCacheKind,
+                                                                                kDefaultChunkSourceKind);
+    return *instance;
 }
 
-CentralHeap::CentralHeap() {
+CentralHeap::CentralHeap(ChunkCacheKind cache_kind, ChunkSourceKind source_kind)
+    : dirty_decay_ns_(toNs(kDefaultDirtyDecay)),
+      muzzy_decay_ns_(toNs(kDefaultMuzzyDecay)),
+      hot_window_start_ns_(nowNs()) {
     // 使用 placement new 在预留的静态内存上构造组件。
     // 这不会调用全局 malloc/new。
-    ChunkAllocatorFromKernel_ptr = new (&g_kernel_allocator_buffer) AlignedChunkAllocatorByMmap();
-    FreeChunkCache_ptr = new (&g_chunk_cache_buffer) FreeChunkListCache();
+    if (source_kind == ChunkSourceKind::kReservedArena) {
+        auto* arena = new (&g_kernel_allocator_buffer) ReservedArenaChunkAllocator();
+        if (arena->isReserved()) {
+            ReservedArena_ptr = arena;
+            ChunkAllocatorFromKernel_ptr = arena;
+        } else {
+            // 地址空间受限（如 ulimit -v）导致保留失败：退回逐次 mmap
+            arena->~ReservedArenaChunkAllocator();
+        }
+    }
+    if (ChunkAllocatorFromKernel_ptr == nullptr) {
+        ChunkAllocatorFromKernel_ptr = new (&g_kernel_allocator_buffer) AlignedChunkAllocatorByMmap();
+    }
+    if (cache_kind == ChunkCacheKind::kLockFree) {
+        FreeChunkCache_ptr = new (&g_chunk_cache_buffer) LockFreeChunkCache();
+    } else {
+        FreeChunkCache_ptr = new (&g_chunk_cache_buffer) FreeChunkListCache();
+    }
+    LargeChunkCache_ptr = new (&g_large_cache_buffer) LargeChunkCache();
+    FormattedPoolCache_ptr = new (&g_formatted_pool_buffer) FormattedPoolCache();
+    RetainedChunkCache_ptr = new (&g_retained_cache_buffer) RetainedChunkCache();
+
+    PageRunAllocator_ptr = new (&g_page_run_buffer) PageRunAllocator();
+    PageRunAllocator_ptr->setRefillCallback(&CentralHeap::pageRunRefill_cb, this);
+    PageRunAllocator_ptr->setReturnCallback(&CentralHeap::pageRunReturn_cb, this);
+
+    // 传输缓存的容量按块大小折算成块数：大块少存几个，小块受 TransferCache::kMaxBlocks 限制
+    TransferCache_ptr = reinterpret_cast<TransferCache*>(&g_transfer_cache_buffer[0]);
+    for (size_t i = 0; i < kTransferClassSlots; ++i) {
+        auto* cache = new (&g_transfer_cache_buffer[i]) TransferCache();
+        if (i < SizeClassConfig::kClassCount) {
+            cache->setCapacity(kTransferBytesPerClass / SizeClassConfig::ClassToSize(i));
+        }
+    }
 }
 
 
@@ -43,11 +134,28 @@ CentralHeap::CentralHeap() {
 CentralHeap::~CentralHeap() {
     // 必须手动、显式地调用【派生类】的析构函数。
     // 我们使用 static_cast，因为我们确切地知道指针背后的真实对象类型。
+    if (TransferCache_ptr) {
+        for (size_t i = 0; i < kTransferClassSlots; ++i) {
+            TransferCache_ptr[i].~TransferCache();
+        }
+    }
+    if (PageRunAllocator_ptr) {
+        PageRunAllocator_ptr->~PageRunAllocator();
+    }
+    if (RetainedChunkCache_ptr) {
+        RetainedChunkCache_ptr->~RetainedChunkCache();
+    }
+    if (FormattedPoolCache_ptr) {
+        FormattedPoolCache_ptr->~FormattedPoolCache();
+    }
+    if (LargeChunkCache_ptr) {
+        LargeChunkCache_ptr->~LargeChunkCache();
+    }
     if (FreeChunkCache_ptr) {
-        static_cast<FreeChunkListCache*>(FreeChunkCache_ptr)->~FreeChunkListCache();
+        FreeChunkCache_ptr->~FreeChunkCache();   // 虚析构，实际类型由构造时的选择决定
     }
     if (ChunkAllocatorFromKernel_ptr) {
-        static_cast<AlignedChunkAllocatorByMmap*>(ChunkAllocatorFromKernel_ptr)->~AlignedChunkAllocatorByMmap();
+        ChunkAllocatorFromKernel_ptr->~ChunkAllocatorFromKernel();
     }
 }
 
@@ -57,10 +165,21 @@ CentralHeap::~CentralHeap() {
 // -----------------------------------------------------------------------------
 
 void* CentralHeap::acquireChunk(size_t size) {
-    assert(size == kChunkSize);
+    assert(size > 0 && size % kChunkSize == 0);
+
+    if (size > kChunkSize) {
+        return acquireLargeSpan(size);
+    }
 
     void* chunk = FreeChunkCache_ptr->acquire();
     if(chunk != nullptr) { 
+        noteHotCount(FreeChunkCache_ptr->getCacheCount());
+        return chunk;
+    }
+
+    // 热缓存已空：先复用保留缓存中仍保持映射的 chunk，再向内核要
+    chunk = RetainedChunkCache_ptr->acquire();
+    if (chunk != nullptr) {
         return chunk;
     }
 
@@ -75,31 +194,334 @@ void* CentralHeap::acquireChunk(size_t size) {
         return chunk;
     }
 
-    return nullptr;
+    // 补充的 chunk 被其他线程抢走，或无锁缓存的近似计数让 refillCache 误以为已在目标水位之上：
+    // 直接向内核要一个，不让调用方因缓存竞争而失败
+    return ChunkAllocatorFromKernel_ptr->allocate(kChunkSize);
 }
 
 bool CentralHeap::refillCache() {
-    if (FreeChunkCache_ptr->getCacheCount() > 0) {
+    // 水位是唯一的判断：一次性补到目标水位之上，整批只向 chunk 来源要一次，而不是每个 chunk 各要一遍
+    const size_t count = FreeChunkCache_ptr->getCacheCount();
+    if (count > kTargetWatermarkInChunks) {
         return true;
     }
 
-    while(FreeChunkCache_ptr->getCacheCount() <= CentralHeap::kTargetWatermarkInChunks) {
-        void* chunk = ChunkAllocatorFromKernel_ptr->allocate(kChunkSize);
-        if(!chunk)
-            return false;
-        FreeChunkCache_ptr->deposit(chunk);
+    void* batch[kTargetWatermarkInChunks + 1];
+    const size_t wanted = kTargetWatermarkInChunks + 1 - count;
+    const size_t got = ChunkAllocatorFromKernel_ptr->allocateBatch(kChunkSize, wanted, batch);
+    for (size_t i = 0; i < got; ++i) {
+        FreeChunkCache_ptr->deposit(batch[i]);
     }
 
-    return true;
+    return got > 0;
 }
 
 void CentralHeap::releaseChunk(void* chunk, size_t size) {
-    assert(size == kChunkSize);
+    assert(size > 0 && size % kChunkSize == 0);
+
+    if (size > kChunkSize) {
+        releaseLargeSpan(chunk, size);
+        return;
+    }
 
     if(FreeChunkCache_ptr->getCacheCount() < kMaxWatermarkInChunks) {
         FreeChunkCache_ptr->deposit(chunk);
     } else {
-        ChunkAllocatorFromKernel_ptr->deallocate(chunk, kChunkSize);
+        // 超出热缓存水位：保持映射转入保留缓存，由衰减逐步交还物理页
+        retainOrRelease(chunk, ChunkDecayStage::kDirty, nowNs());
     }
+    decayTick();
 }
 
+bool CentralHeap::owns(const void* ptr) const noexcept {
+    // 保留区溢出后，区间外的指针也可能是本分配器的 chunk，区间比较不再能给出否定答案
+    return ReservedArena_ptr == nullptr || ReservedArena_ptr->hasOverflowed() ||
+           ReservedArena_ptr->owns(ptr);
+}
+
+// -----------------------------------------------------------------------------
+// 4. 多 chunk 大块映射（大对象）
+// -----------------------------------------------------------------------------
+
+void* CentralHeap::acquireLargeSpan(size_t size) {
+    size_t span_size = 0;
+    void* span = LargeChunkCache_ptr->acquire(size, &span_size);
+    if (span != nullptr) {
+        // 缓存段比请求长：裁掉尾部多余的 chunk 还给内核
+        if (span_size > size) {
+            ChunkAllocatorFromKernel_ptr->deallocate(static_cast<char*>(span) + size, span_size - size);
+        }
+        return span;
+    }
+
+    return ChunkAllocatorFromKernel_ptr->allocate(size);
+}
+
+void CentralHeap::releaseLargeSpan(void* span, size_t size) {
+    if (!LargeChunkCache_ptr->deposit(span, size)) {
+        ChunkAllocatorFromKernel_ptr->deallocate(span, size);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// 5. 页段（中等对象）：多个 size-class 共享同一批 chunk
+// -----------------------------------------------------------------------------
+
+void* CentralHeap::acquirePageRun(size_t pages) {
+    return PageRunAllocator_ptr->allocate(pages);
+}
+
+void CentralHeap::releasePageRun(void* run) {
+    PageRunAllocator_ptr->release(run);
+}
+
+void* CentralHeap::pageRunRefill_cb(void* ctx) noexcept {
+    auto* self = static_cast<CentralHeap*>(ctx);
+    void* chunk = self->acquireChunk(kChunkSize);
+    if (chunk == nullptr) {
+        return nullptr;
+    }
+
+    // 页段 chunk 由所有线程共享，不记录所有者
+    PageMapEntry entry;
+    entry.kind = ChunkKind::kMediumRun;
+    entry.base = chunk;
+    if (!PageMap::GetInstance().set(chunk, 1, entry)) {
+        self->releaseChunk(chunk, kChunkSize);
+        return nullptr;
+    }
+    return chunk;
+}
+
+void CentralHeap::pageRunReturn_cb(void* ctx, void* chunk) noexcept {
+    PageMap::GetInstance().clear(chunk, 1);
+    static_cast<CentralHeap*>(ctx)->releaseChunk(chunk, kChunkSize);
+}
+
+// -----------------------------------------------------------------------------
+// 6. 孤儿队列：线程退出时发布，存活线程补充子池或自动 GC 时认领
+// -----------------------------------------------------------------------------
+
+void CentralHeap::publishOrphanPool(size_t size_class, BlockHeader* pool_node) {
+    assert(size_class < kOrphanClassSlots && pool_node != nullptr);
+    std::lock_guard<std::mutex> guard(orphan_mutex_);
+    pool_node->next = orphan_pools_[size_class].load(std::memory_order_relaxed);
+    orphan_pools_[size_class].store(pool_node, std::memory_order_release);
+}
+
+BlockHeader* CentralHeap::adoptOrphanPool(size_t size_class) {
+    if (!hasOrphanPools(size_class)) return nullptr;
+
+    std::lock_guard<std::mutex> guard(orphan_mutex_);
+    BlockHeader* node = orphan_pools_[size_class].load(std::memory_order_relaxed);
+    if (node) {
+        orphan_pools_[size_class].store(node->next, std::memory_order_relaxed);
+        node->next = nullptr;
+    }
+    return node;
+}
+
+void CentralHeap::publishOrphanBlocks(BlockHeader* first, BlockHeader* last) {
+    if (!first) return;
+    std::lock_guard<std::mutex> guard(orphan_mutex_);
+    last->next = orphan_blocks_.load(std::memory_order_relaxed);
+    orphan_blocks_.store(first, std::memory_order_release);
+}
+
+BlockHeader* CentralHeap::adoptOrphanBlocks() {
+    if (!hasOrphanBlocks()) return nullptr;
+
+    std::lock_guard<std::mutex> guard(orphan_mutex_);
+    return orphan_blocks_.exchange(nullptr, std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------
+// 7. 已格式化子池：按 size-class 暂存交还的空子池
+// -----------------------------------------------------------------------------
+
+void* CentralHeap::acquireFormattedPool(size_t size_class) {
+    return FormattedPoolCache_ptr->acquire(size_class);
+}
+
+void* CentralHeap::depositFormattedPool(void* pool, size_t size_class, size_t purge_offset) {
+    return FormattedPoolCache_ptr->deposit(pool, size_class, purge_offset, nowNs());
+}
+
+// -----------------------------------------------------------------------------
+// 8. 传输缓存：线程缓存之间按 size-class 成批换手小对象块
+// -----------------------------------------------------------------------------
+
+size_t CentralHeap::insertTransferBlocks(size_t size_class, void* const* blocks, size_t n) {
+    assert(size_class < kTransferClassSlots);
+    return TransferCache_ptr[size_class].insert(blocks, n);
+}
+
+size_t CentralHeap::removeTransferBlocks(size_t size_class, void** out, size_t n) {
+    assert(size_class < kTransferClassSlots);
+    return TransferCache_ptr[size_class].remove(out, n);
+}
+
+size_t CentralHeap::transferBlockCount(size_t size_class) const noexcept {
+    assert(size_class < kTransferClassSlots);
+    return TransferCache_ptr[size_class].getCount();
+}
+
+size_t CentralHeap::transferCapacity(size_t size_class) const noexcept {
+    assert(size_class < kTransferClassSlots);
+    return TransferCache_ptr[size_class].getCapacity();
+}
+
+// -----------------------------------------------------------------------------
+// 9. 衰减回收：保留缓存与已格式化子池按时间依次 MADV_FREE、MADV_DONTNEED
+// -----------------------------------------------------------------------------
+
+void CentralHeap::setDecayTimes(std::chrono::milliseconds dirty, std::chrono::milliseconds muzzy) {
+    dirty_decay_ns_.store(toNs(dirty), std::memory_order_relaxed);
+    muzzy_decay_ns_.store(toNs(muzzy), std::memory_order_relaxed);
+}
+
+size_t CentralHeap::purgeDecayed() {
+    std::unique_lock<std::mutex> guard(purge_mutex_, std::try_to_lock);
+    if (!guard.owns_lock()) {
+        return 0;   // 另一轮正在进行：不等待
+    }
+
+    const uint64_t now   = nowNs();
+    const uint64_t dirty = dirty_decay_ns_.load(std::memory_order_relaxed);
+    const uint64_t muzzy = muzzy_decay_ns_.load(std::memory_order_relaxed);
+    next_tick_ns_.store(now + toNs(kDecayTickInterval), std::memory_order_relaxed);
+
+    size_t advanced = decayHotCache(now, dirty);
+    advanced += RetainedChunkCache_ptr->advance(now, dirty, muzzy, &CentralHeap::adviseChunk_cb, this);
+    advanced += FormattedPoolCache_ptr->advance(now, dirty, muzzy, &CentralHeap::adviseChunk_cb, this);
+    return advanced;
+}
+
+void CentralHeap::decayTick() noexcept {
+    if (nowNs() < next_tick_ns_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    purgeDecayed();
+}
+
+CentralHeap::DecayStats CentralHeap::getDecayStats() const {
+    DecayStats stats{};
+    stats.hot_chunks     = FreeChunkCache_ptr->getCacheCount();
+    stats.retained_dirty = RetainedChunkCache_ptr->getCount(ChunkDecayStage::kDirty);
+    stats.retained_muzzy = RetainedChunkCache_ptr->getCount(ChunkDecayStage::kMuzzy);
+    stats.retained_clean = RetainedChunkCache_ptr->getCount(ChunkDecayStage::kClean);
+    stats.pools_dirty    = FormattedPoolCache_ptr->getCount(ChunkDecayStage::kDirty);
+    stats.pools_muzzy    = FormattedPoolCache_ptr->getCount(ChunkDecayStage::kMuzzy);
+    stats.pools_clean    = FormattedPoolCache_ptr->getCount(ChunkDecayStage::kClean);
+    return stats;
+}
+
+size_t CentralHeap::decayHotCache(uint64_t now_ns, uint64_t dirty_ns) {
+    // 窗口还不满一个 dirty 衰减时间：继续观察
+    if (now_ns - hot_window_start_ns_ < dirty_ns) {
+        return 0;
+    }
+
+    // 窗口内热缓存从未低于 low 个：至少有 low 个 chunk 整个窗口都没被取用。
+    // 取出的是栈顶的几个，chunk 之间可以互换，数量对了即可
+    const size_t idle = std::min(hot_low_water_.load(std::memory_order_relaxed),
+                                 FreeChunkCache_ptr->getCacheCount());
+    size_t moved = 0;
+    while (moved < idle) {
+        void* chunk = FreeChunkCache_ptr->acquire();
+        if (chunk == nullptr) {
+            break;
+        }
+        // 从窗口起点计时：随后的 advance 会立即把它降级
+        retainOrRelease(chunk, ChunkDecayStage::kDirty, hot_window_start_ns_);
+        ++moved;
+    }
+
+    hot_low_water_.store(FreeChunkCache_ptr->getCacheCount(), std::memory_order_relaxed);
+    hot_window_start_ns_ = now_ns;
+    return moved;
+}
+
+void CentralHeap::noteHotCount(size_t count) noexcept {
+    size_t low = hot_low_water_.load(std::memory_order_relaxed);
+    while (count < low &&
+           !hot_low_water_.compare_exchange_weak(low, count, std::memory_order_relaxed)) {
+    }
+}
+
+void CentralHeap::retainOrRelease(void* chunk, ChunkDecayStage stage, uint64_t since_ns) {
+    if (RetainedChunkCache_ptr->deposit(chunk, stage, since_ns)) {
+        return;
+    }
+    // 该 chunk 可能仍被进行中的无锁出栈读取，解除映射前需等其结束
+    FreeChunkCache_ptr->waitForReaders();
+    ChunkAllocatorFromKernel_ptr->deallocate(chunk, kChunkSize);
+}
+
+bool CentralHeap::adviseChunk_cb(void* /*ctx*/, void* base, size_t offset, ChunkDecayStage to) noexcept {
+    // 只交还整页：子池头部所在的页保持常驻
+    const size_t page  = PageRunAllocator::kPageSize;
+    const size_t begin = (offset + page - 1) & ~(page - 1);
+    if (begin >= kChunkSize) {
+        return true;
+    }
+    char* start = static_cast<char*>(base) + begin;
+    const size_t length = kChunkSize - begin;
+
+    if (to == ChunkDecayStage::kMuzzy && madvise(start, length, MADV_FREE) == 0) {
+        return true;
+    }
+    // 不支持 MADV_FREE 的内核（< 4.5）退回 MADV_DONTNEED：提前交还，阶段仍按 muzzy 记账
+    return madvise(start, length, MADV_DONTNEED) == 0;
+}
+
+bool CentralHeap::startBackgroundPurge(std::chrono::milliseconds interval) {
+    std::unique_lock<std::mutex> lk(purge_thread_mutex_);
+    purge_interval_ = std::max(interval, std::chrono::milliseconds{1});
+    if (purge_thread_state_ == PurgeThreadState::kRunning) {
+        purge_thread_cv_.notify_all();   // 按新间隔重新计时
+        return true;
+    }
+    purge_thread_cv_.wait(lk, [this] { return purge_thread_state_ == PurgeThreadState::kStopped; });
+
+    pthread_attr_t attr;
+    if (pthread_attr_init(&attr) != 0) {
+        return false;
+    }
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    pthread_t tid;
+    const int rc = pthread_create(&tid, &attr, &CentralHeap::backgroundPurgeMain, this);
+    pthread_attr_destroy(&attr);
+    if (rc != 0) {
+        return false;
+    }
+    purge_thread_state_ = PurgeThreadState::kRunning;
+    return true;
+}
+
+void CentralHeap::stopBackgroundPurge() {
+    std::unique_lock<std::mutex> lk(purge_thread_mutex_);
+    if (purge_thread_state_ == PurgeThreadState::kRunning) {
+        purge_thread_state_ = PurgeThreadState::kStopping;
+        purge_thread_cv_.notify_all();
+    }
+    purge_thread_cv_.wait(lk, [this] { return purge_thread_state_ == PurgeThreadState::kStopped; });
+}
+
+void* CentralHeap::backgroundPurgeMain(void* self) noexcept {
+    auto* heap = static_cast<CentralHeap*>(self);
+    const auto stopping = [heap] { return heap->purge_thread_state_ != PurgeThreadState::kRunning; };
+
+    std::unique_lock<std::mutex> lk(heap->purge_thread_mutex_);
+    while (!stopping()) {
+        if (heap->purge_thread_cv_.wait_for(lk, heap->purge_interval_, stopping)) {
+            break;
+        }
+        lk.unlock();
+        heap->purgeDecayed();
+        lk.lock();
+    }
+    heap->purge_thread_state_ = PurgeThreadState::kStopped;
+    heap->purge_thread_cv_.notify_all();
+    return nullptr;
+}
@@ -0,0 +1,93 @@
+#include "gc_malloc/CentralHeap/FormattedPoolCache.hpp"
+#include <cassert>
+
+void* FormattedPoolCache::acquire(size_t size_class) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // 从最新的条目找起：最近交还的子池最可能还在缓存里
+    for (size_t i = entry_count_; i > 0; --i) {
+        if (entries_[i - 1].size_class == size_class) {
+            return removeAt(i - 1);
+        }
+    }
+    return nullptr;
+}
+
+void* FormattedPoolCache::deposit(void* pool, size_t size_class, size_t purge_offset, uint64_t now_ns) {
+    if (pool == nullptr) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    void* evicted = nullptr;
+    size_t oldest_same = kMaxEntries;
+    size_t same = 0;
+    for (size_t i = 0; i < entry_count_; ++i) {
+        if (entries_[i].size_class != size_class) continue;
+        if (same++ == 0) oldest_same = i;
+    }
+
+    if (same >= kMaxPerClass) {
+        evicted = removeAt(oldest_same);
+    } else if (entry_count_ == kMaxEntries) {
+        evicted = removeAt(0);
+    }
+
+    assert(entry_count_ < kMaxEntries);
+    entries_[entry_count_++] = Entry{pool, size_class, purge_offset, now_ns, ChunkDecayStage::kDirty};
+    return evicted;
+}
+
+size_t FormattedPoolCache::advance(uint64_t now_ns, uint64_t dirty_ns, uint64_t muzzy_ns,
+                                   ChunkAdviseCallback cb, void* ctx) {
+    assert(cb != nullptr);
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    size_t advanced = 0;
+    for (size_t i = 0; i < entry_count_; ++i) {
+        Entry& e = entries_[i];
+        const uint64_t age = now_ns > e.since_ns ? now_ns - e.since_ns : 0;
+        const ChunkDecayStage to = decayTarget(e.stage, age, dirty_ns, muzzy_ns);
+        if (to == e.stage || !cb(ctx, e.pool, e.purge_offset, to)) {
+            continue;
+        }
+        e.stage    = to;
+        e.since_ns = now_ns;
+        ++advanced;
+    }
+    return advanced;
+}
+
+size_t FormattedPoolCache::getCacheCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entry_count_;
+}
+
+size_t FormattedPoolCache::getClassCount(size_t size_class) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t n = 0;
+    for (size_t i = 0; i < entry_count_; ++i) {
+        if (entries_[i].size_class == size_class) ++n;
+    }
+    return n;
+}
+
+size_t FormattedPoolCache::getCount(ChunkDecayStage stage) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t n = 0;
+    for (size_t i = 0; i < entry_count_; ++i) {
+        if (entries_[i].stage == stage) ++n;
+    }
+    return n;
+}
+
+void* FormattedPoolCache::removeAt(size_t index) {
+    assert(index < entry_count_);
+    void* pool = entries_[index].pool;
+    for (size_t i = index + 1; i < entry_count_; ++i) {
+        entries_[i - 1] = entries_[i];
+    }
+    entry_count_--;
+    return pool;
+}
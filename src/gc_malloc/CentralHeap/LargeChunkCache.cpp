@@ -0,0 +1,56 @@
+#include "gc_malloc/CentralHeap/LargeChunkCache.hpp"
+#include <cassert>
+
+void* LargeChunkCache::acquire(size_t size, size_t* span_size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    size_t best = kMaxEntries;
+    for (size_t i = 0; i < entry_count_; ++i) {
+        if (entries_[i].size < size) continue;
+        if (best == kMaxEntries || entries_[i].size < entries_[best].size) {
+            best = i;
+        }
+    }
+
+    if (best == kMaxEntries) {
+        return nullptr;
+    }
+
+    Entry found = entries_[best];
+    // 用末尾条目填补空位，保持数组紧凑
+    entries_[best] = entries_[entry_count_ - 1];
+    entry_count_--;
+    cached_bytes_ -= found.size;
+
+    if (span_size) {
+        *span_size = found.size;
+    }
+    return found.span;
+}
+
+bool LargeChunkCache::deposit(void* span, size_t size) {
+    if (span == nullptr || size == 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (entry_count_ >= kMaxEntries || cached_bytes_ + size > kMaxCachedBytes) {
+        return false;
+    }
+
+    entries_[entry_count_++] = Entry{span, size};
+    cached_bytes_ += size;
+    assert(cached_bytes_ <= kMaxCachedBytes);
+    return true;
+}
+
+size_t LargeChunkCache::getCacheCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entry_count_;
+}
+
+size_t LargeChunkCache::getCachedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cached_bytes_;
+}
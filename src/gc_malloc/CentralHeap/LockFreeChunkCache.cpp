@@ -0,0 +1,63 @@
+#include "gc_malloc/CentralHeap/LockFreeChunkCache.hpp"
+#include <cassert>
+
+void* LockFreeChunkCache::acquire() {
+    readers_.fetch_add(1, std::memory_order_seq_cst);
+
+    uint64_t old_head = head_.load(std::memory_order_seq_cst);
+    Node* node = unpackNode(old_head);
+
+    while (node != nullptr) {
+        // node 可能已被其他线程取走并改写，此时读到的 next 无意义，
+        // 但版本号已变化，下面的 CAS 必然失败并重试
+        Node* next = node->next.load(std::memory_order_relaxed);
+        const uint64_t new_head = pack(next, unpackTag(old_head) + 1);
+
+        if (head_.compare_exchange_weak(old_head, new_head,
+                                        std::memory_order_seq_cst,
+                                        std::memory_order_seq_cst)) {
+            break;
+        }
+        node = unpackNode(old_head);
+    }
+
+    readers_.fetch_sub(1, std::memory_order_release);
+
+    if (node == nullptr) {
+        return nullptr;
+    }
+
+    chunk_count_.fetch_sub(1, std::memory_order_relaxed);
+    return static_cast<void*>(node);
+}
+
+void LockFreeChunkCache::deposit(void* chunk) {
+    if (chunk == nullptr) {
+        return;
+    }
+    assert((reinterpret_cast<uint64_t>(chunk) & ~kPointerMask) == 0);
+
+    Node* node = static_cast<Node*>(chunk);
+    // 计数先于入栈增加：并发 acquire 的减计数不会把它减成“负数”
+    chunk_count_.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t old_head = head_.load(std::memory_order_relaxed);
+    do {
+        node->next.store(unpackNode(old_head), std::memory_order_relaxed);
+        // 入栈不改变版本号：ABA 只影响出栈一侧
+    } while (!head_.compare_exchange_weak(old_head, pack(node, unpackTag(old_head)),
+                                          std::memory_order_seq_cst,
+                                          std::memory_order_relaxed));
+}
+
+size_t LockFreeChunkCache::getCacheCount() const {
+    return chunk_count_.load(std::memory_order_relaxed);
+}
+
+void LockFreeChunkCache::waitForReaders() const {
+    while (readers_.load(std::memory_order_seq_cst) != 0) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+}
@@ -0,0 +1,80 @@
+#include "gc_malloc/CentralHeap/PageMap.hpp"
+
+#include <gc_malloc/CentralHeap/sys/mman.hpp>
+#include <new>
+#include <type_traits>
+#include <cassert>
+
+// PageMap 放在静态存储上：与 CentralHeap 一样不注册析构，任何分配发生之前都可安全使用
+static std::aligned_storage<sizeof(PageMap), alignof(PageMap)>::type g_page_map_buffer;
+
+PageMap& PageMap::GetInstance() {
+    static PageMap* const instance = new (&g_page_map_buffer) PageMap();
+    return *instance;
+}
+
+PageMap::PageMap() noexcept {
+    for (size_t i = 0; i < kRootLength; ++i) {
+        root_[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+bool PageMap::set(const void* chunk, size_t nchunks, const PageMapEntry& entry) noexcept {
+    const uintptr_t first = reinterpret_cast<uintptr_t>(chunk) >> kChunkShift;
+    assert((reinterpret_cast<uintptr_t>(chunk) & ((uintptr_t{1} << kChunkShift) - 1)) == 0);
+    assert((reinterpret_cast<uintptr_t>(entry.base) & ~kBaseMask) == 0);
+
+    const uint64_t word = (reinterpret_cast<uint64_t>(entry.base) & kBaseMask)
+                        | (static_cast<uint64_t>(entry.size_class) << kClassShift)
+                        | (static_cast<uint64_t>(entry.kind) << kKindShift);
+
+    for (size_t i = 0; i < nchunks; ++i) {
+        Slot* slot = slotFor(first + i, /*create=*/true);
+        if (slot == nullptr) {
+            clear(chunk, i);
+            return false;
+        }
+        // 先写 owner 再发布 kind/base：读者看到非 kNone 时 owner 已就绪
+        slot->owner.store(entry.owner, std::memory_order_relaxed);
+        slot->tagged_base.store(word, std::memory_order_release);
+    }
+    return true;
+}
+
+void PageMap::clear(const void* chunk, size_t nchunks) noexcept {
+    const uintptr_t first = reinterpret_cast<uintptr_t>(chunk) >> kChunkShift;
+
+    for (size_t i = 0; i < nchunks; ++i) {
+        Slot* slot = slotFor(first + i, /*create=*/false);
+        if (slot == nullptr) continue;
+        slot->tagged_base.store(0, std::memory_order_release);
+        slot->owner.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+PageMap::Slot* PageMap::slotFor(uintptr_t key, bool create) noexcept {
+    if (key >> kKeyBits) return nullptr;
+
+    std::atomic<Leaf*>& root_slot = root_[key >> kLeafBits];
+    Leaf* leaf = root_slot.load(std::memory_order_acquire);
+
+    if (leaf == nullptr) {
+        if (!create) return nullptr;
+
+        // 叶子直接向内核要（匿名映射天然清零）；不经过 CentralHeap，避免相互依赖
+        void* raw = mmap(nullptr, sizeof(Leaf), PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) return nullptr;
+
+        Leaf* fresh = static_cast<Leaf*>(raw);
+        if (root_slot.compare_exchange_strong(leaf, fresh,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_acquire)) {
+            leaf = fresh;
+        } else {
+            munmap(raw, sizeof(Leaf));   // 其他线程已抢先建立
+        }
+    }
+
+    return &leaf->slots[key & (kLeafLength - 1)];
+}
@@ -0,0 +1,287 @@
+#include "gc_malloc/CentralHeap/PageRunAllocator.hpp"
+
+#include <new>
+#include <cassert>
+#include <cstring>
+
+static_assert(sizeof(PageRunChunk) <= PageRunChunk::kPageSize,
+              "PageRunChunk header must fit in the first page of a chunk");
+static_assert(PageRunChunk::kUsablePages < 0x8000,
+              "run length must not collide with the free bit");
+
+namespace {
+
+inline PageRunChunk* chunkOf(const void* ptr) noexcept {
+    const auto addr = reinterpret_cast<uintptr_t>(ptr);
+    return reinterpret_cast<PageRunChunk*>(addr & ~(uintptr_t)(PageRunChunk::kChunkSize - 1));
+}
+
+} // namespace
+
+// ===== PageRunChunk =====
+
+PageRunChunk::PageRunChunk() noexcept : magic_(kChunkMagic) {
+    std::memset(start_tag_, 0, sizeof(start_tag_));
+    std::memset(end_tag_, 0, sizeof(end_tag_));
+    for (size_t i = 0; i < kPageCount; ++i) {
+        owner_[i] = kNoOwner;
+    }
+    setRun(kFirstUsablePage, kUsablePages, /*free=*/true);
+}
+
+PageRunChunk::~PageRunChunk() {
+    magic_ = 0;   // 归还后同一地址可能被复用为其他类型的 chunk
+}
+
+bool PageRunChunk::isPageRunChunkHeader(const void* base) noexcept {
+    if (base == nullptr) return false;
+    return static_cast<const PageRunChunk*>(base)->magic_ == kChunkMagic;
+}
+
+size_t PageRunChunk::pageIndexOf(const void* p) const noexcept {
+    const auto off = reinterpret_cast<uintptr_t>(p) - reinterpret_cast<uintptr_t>(this);
+    return static_cast<size_t>(off / kPageSize);
+}
+
+void* PageRunChunk::pageAddress(size_t page) noexcept {
+    return reinterpret_cast<char*>(this) + page * kPageSize;
+}
+
+void* PageRunChunk::runOf(const void* ptr) const noexcept {
+    const size_t page = pageIndexOf(ptr);
+    if (page < kFirstUsablePage || page >= kPageCount) return nullptr;
+
+    const uint16_t first = owner_[page];
+    if (first == kNoOwner) return nullptr;
+    return const_cast<char*>(reinterpret_cast<const char*>(this)) + first * kPageSize;
+}
+
+size_t PageRunChunk::runBytes(const void* run) const noexcept {
+    const size_t page = pageIndexOf(run);
+    if (page < kFirstUsablePage || page >= kPageCount) return 0;
+
+    const uint16_t tag = start_tag_[page];
+    if (tag == 0 || (tag & kFreeBit)) return 0;
+    return static_cast<size_t>(tag) * kPageSize;
+}
+
+void PageRunChunk::setRun(size_t first, size_t len, bool free) noexcept {
+    assert(len > 0 && first >= kFirstUsablePage && first + len <= kPageCount);
+
+    const uint16_t tag = static_cast<uint16_t>(len | (free ? kFreeBit : 0));
+    start_tag_[first]         = tag;
+    end_tag_[first + len - 1] = tag;
+
+    // 仅已分配段需要页 -> 段首映射；空闲段内部页的标记保持为 kNoOwner
+    const uint16_t owner = free ? kNoOwner : static_cast<uint16_t>(first);
+    for (size_t i = first; i < first + len; ++i) {
+        owner_[i] = owner;
+    }
+}
+
+// ===== PageRunAllocator =====
+
+PageRunAllocator::PageRunAllocator() noexcept {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        buckets_[i] = nullptr;
+    }
+    for (size_t i = 0; i < kBucketWords; ++i) {
+        nonempty_[i] = 0;
+    }
+}
+
+void PageRunAllocator::setRefillCallback(RefillCallback cb, void* ctx) noexcept {
+    refill_cb_  = cb;
+    refill_ctx_ = ctx;
+}
+
+void PageRunAllocator::setReturnCallback(ReturnCallback cb, void* ctx) noexcept {
+    return_cb_  = cb;
+    return_ctx_ = ctx;
+}
+
+void* PageRunAllocator::allocate(size_t pages) noexcept {
+    if (pages == 0 || pages > kMaxRunPages) return nullptr;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    size_t len = findBucket(pages);
+    PageRunChunk* surplus = nullptr;
+    if (len == 0) {
+        // 向上游要 chunk 可能陷入内核（mmap / mprotect / madvise），不持锁进行，
+        // 其他线程的分配与释放不必排在这次系统调用后面
+        lock.unlock();
+        PageRunChunk* fresh = fetchChunk();
+        if (!fresh) return nullptr;
+        lock.lock();
+
+        // 等待期间其他线程可能已补充了可用段：空 chunk 已足够时，多要的这个在分配完成后交还上游
+        len = findBucket(pages);
+        if (len != 0 && empty_chunks_ >= kMaxEmptyChunks && return_cb_) {
+            surplus = fresh;
+        } else {
+            adoptChunk(fresh);
+            len = findBucket(pages);
+            assert(len != 0);
+        }
+    }
+
+    FreeRun* node = buckets_[len];
+    PageRunChunk* chunk = chunkOf(node);
+    const size_t first = chunk->pageIndexOf(node);
+
+    removeFree(chunk, first, len);
+    chunk->setRun(first, pages, /*free=*/false);
+
+    // 切分：尾部剩余部分重新挂回对应桶
+    if (len > pages) {
+        chunk->setRun(first + pages, len - pages, /*free=*/true);
+        insertFree(chunk, first + pages, len - pages);
+    }
+
+    void* run = chunk->pageAddress(first);
+    if (surplus) {
+        lock.unlock();
+        surplus->~PageRunChunk();
+        return_cb_(return_ctx_, static_cast<void*>(surplus));
+    }
+    return run;
+}
+
+void PageRunAllocator::release(void* run) noexcept {
+    if (run == nullptr) return;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    PageRunChunk* chunk = chunkOf(run);
+    assert(PageRunChunk::isPageRunChunkHeader(chunk));
+
+    size_t first = chunk->pageIndexOf(run);
+    const uint16_t tag = chunk->start_tag_[first];
+    assert(tag != 0 && !(tag & PageRunChunk::kFreeBit) && "release: not the start of a live run");
+    size_t len = tag;
+
+    // 与前一个空闲段合并（依据其尾页标签）
+    if (first > PageRunChunk::kFirstUsablePage) {
+        const uint16_t prev_tag = chunk->end_tag_[first - 1];
+        if (prev_tag & PageRunChunk::kFreeBit) {
+            const size_t prev_len = prev_tag & ~PageRunChunk::kFreeBit;
+            removeFree(chunk, first - prev_len, prev_len);
+            chunk->end_tag_[first - 1] = 0;
+            chunk->start_tag_[first]   = 0;
+            first -= prev_len;
+            len   += prev_len;
+        }
+    }
+
+    // 与后一个空闲段合并（依据其首页标签）
+    const size_t next = first + len;
+    if (next < PageRunChunk::kPageCount) {
+        const uint16_t next_tag = chunk->start_tag_[next];
+        if (next_tag & PageRunChunk::kFreeBit) {
+            const size_t next_len = next_tag & ~PageRunChunk::kFreeBit;
+            removeFree(chunk, next, next_len);
+            chunk->end_tag_[next - 1] = 0;
+            chunk->start_tag_[next]   = 0;
+            len += next_len;
+        }
+    }
+
+    chunk->setRun(first, len, /*free=*/true);
+
+    // 整个 chunk 空闲且已保留足够的空 chunk：交还上游
+    if (len == kMaxRunPages && empty_chunks_ >= kMaxEmptyChunks && return_cb_) {
+        // 先在锁内把 chunk 摘出记账，再在锁外交还：回调可能做系统调用
+        chunk->~PageRunChunk();
+        --chunk_count_;
+        lock.unlock();
+        return_cb_(return_ctx_, static_cast<void*>(chunk));
+        return;
+    }
+
+    insertFree(chunk, first, len);
+}
+
+void* PageRunAllocator::runOf(const void* ptr) noexcept {
+    if (ptr == nullptr) return nullptr;
+    const PageRunChunk* chunk = chunkOf(ptr);
+    if (!PageRunChunk::isPageRunChunkHeader(chunk)) return nullptr;
+    return chunk->runOf(ptr);
+}
+
+size_t PageRunAllocator::runBytes(const void* run) noexcept {
+    if (run == nullptr) return 0;
+    const PageRunChunk* chunk = chunkOf(run);
+    if (!PageRunChunk::isPageRunChunkHeader(chunk)) return 0;
+    return chunk->runBytes(run);
+}
+
+size_t PageRunAllocator::getChunkCount() const noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return chunk_count_;
+}
+
+size_t PageRunAllocator::getFreePages() const noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_pages_;
+}
+
+// -------------------- 内部实现 --------------------
+
+void PageRunAllocator::insertFree(PageRunChunk* chunk, size_t first, size_t len) noexcept {
+    auto* node = static_cast<FreeRun*>(chunk->pageAddress(first));
+    node->prev = nullptr;
+    node->next = buckets_[len];
+    if (node->next) node->next->prev = node;
+    buckets_[len] = node;
+
+    nonempty_[len / 64] |= (uint64_t{1} << (len % 64));
+    free_pages_ += len;
+    if (len == kMaxRunPages) ++empty_chunks_;
+}
+
+void PageRunAllocator::removeFree(PageRunChunk* chunk, size_t first, size_t len) noexcept {
+    auto* node = static_cast<FreeRun*>(chunk->pageAddress(first));
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else {
+        assert(buckets_[len] == node);
+        buckets_[len] = node->next;
+    }
+    if (node->next) node->next->prev = node->prev;
+
+    if (buckets_[len] == nullptr) {
+        nonempty_[len / 64] &= ~(uint64_t{1} << (len % 64));
+    }
+    free_pages_ -= len;
+    if (len == kMaxRunPages) --empty_chunks_;
+}
+
+// 返回 >= min_len 的最短非空桶的段长；没有则返回 0
+size_t PageRunAllocator::findBucket(size_t min_len) const noexcept {
+    size_t word = min_len / 64;
+    uint64_t bits = nonempty_[word] & (~uint64_t{0} << (min_len % 64));
+
+    while (true) {
+        if (bits != 0) {
+            return word * 64 + static_cast<size_t>(__builtin_ctzll(bits));
+        }
+        if (++word >= kBucketWords) return 0;
+        bits = nonempty_[word];
+    }
+}
+
+PageRunChunk* PageRunAllocator::fetchChunk() noexcept {
+    if (!refill_cb_) return nullptr;
+
+    void* raw = refill_cb_(refill_ctx_);
+    if (!raw) return nullptr;
+
+    // 挂入空闲桶之前只有本线程看得到这个 chunk，头部在锁外构造即可
+    return new (raw) PageRunChunk();
+}
+
+void PageRunAllocator::adoptChunk(PageRunChunk* chunk) noexcept {
+    ++chunk_count_;
+    insertFree(chunk, PageRunChunk::kFirstUsablePage, kMaxRunPages);
+}
@@ -0,0 +1,223 @@
+#include "gc_malloc/CentralHeap/ReservedArenaChunkAllocator.hpp"
+
+#include <gc_malloc/CentralHeap/sys/mman.hpp>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+ReservedArenaChunkAllocator::ReservedArenaChunkAllocator(size_t reserve_bytes) {
+    for (size_t i = 0; i < kBitmapWords; ++i) {
+        used_[i].store(0, std::memory_order_relaxed);
+    }
+
+    if (reserve_bytes > kMaxReserveBytes) {
+        reserve_bytes = kMaxReserveBytes;
+    }
+    reserve_bytes &= ~(kChunkSize - 1);
+    if (reserve_bytes == 0) {
+        return;
+    }
+
+    // 只保留地址空间：PROT_NONE + MAP_NORESERVE 不占物理内存，也不计入提交额度。
+    // 多保留一个 chunk 再裁剪，使整个区间按 2MB 对齐（只在启动时做一次）。
+    const size_t over_size = reserve_bytes + kChunkSize;
+    void* raw_ptr = mmap(nullptr, over_size, PROT_NONE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (raw_ptr == MAP_FAILED) {
+        return;
+    }
+
+    const uintptr_t raw_addr     = reinterpret_cast<uintptr_t>(raw_ptr);
+    const uintptr_t aligned_addr = (raw_addr + kChunkSize - 1) & ~(uintptr_t)(kChunkSize - 1);
+    const uintptr_t aligned_end  = aligned_addr + reserve_bytes;
+    const uintptr_t raw_end      = raw_addr + over_size;
+
+    if (aligned_addr > raw_addr) {
+        munmap(raw_ptr, aligned_addr - raw_addr);
+    }
+    if (raw_end > aligned_end) {
+        munmap(reinterpret_cast<void*>(aligned_end), raw_end - aligned_end);
+    }
+
+    base_           = aligned_addr;
+    reserved_bytes_ = reserve_bytes;
+    chunk_capacity_ = reserve_bytes / kChunkSize;
+}
+
+ReservedArenaChunkAllocator::~ReservedArenaChunkAllocator() {
+    if (base_ != 0) {
+        munmap(reinterpret_cast<void*>(base_), reserved_bytes_);
+    }
+}
+
+void* ReservedArenaChunkAllocator::allocate(size_t size) {
+    assert(size > 0 && size % kChunkSize == 0 &&
+            "Allocation size must be a positive multiple of kChunkSize (2MB)");
+
+    if (base_ == 0) {
+        return nullptr;
+    }
+
+    const size_t count = size / kChunkSize;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        const size_t first = findFreeRange(count);
+        if (first != chunk_capacity_) {
+            void* addr = reinterpret_cast<void*>(base_ + first * kChunkSize);
+            if (mprotect(addr, size, PROT_READ | PROT_WRITE) != 0) {
+                return nullptr;
+            }
+
+            // 先提交再置位：owns() 为真时内存一定可访问
+            markRange(first, count, /*used=*/true);
+            committed_ += count;
+            return addr;
+        }
+    }
+
+    // 保留区已耗尽：退回普通 mmap，在锁外做系统调用
+    void* addr = overflow_.allocate(size);
+    if (addr != nullptr) {
+        overflowed_.store(true, std::memory_order_relaxed);
+    }
+    return addr;
+}
+
+size_t ReservedArenaChunkAllocator::allocateBatch(size_t chunk_size, size_t count, void** out) {
+    assert(chunk_size > 0 && chunk_size % kChunkSize == 0 &&
+            "Allocation size must be a positive multiple of kChunkSize (2MB)");
+
+    if (count == 0 || out == nullptr) {
+        return 0;
+    }
+    if (base_ == 0 || count > chunk_capacity_) {
+        return overflow_.allocateBatch(chunk_size, count, out);
+    }
+
+    const size_t per_chunk = chunk_size / kChunkSize;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        size_t run = 0;
+        const size_t first = findLongestFreeRange(count * per_chunk, &run);
+        const size_t n = run / per_chunk;
+        if (n > 0) {
+            char* addr = reinterpret_cast<char*>(base_ + first * kChunkSize);
+            if (mprotect(addr, n * chunk_size, PROT_READ | PROT_WRITE) != 0) {
+                return 0;
+            }
+
+            markRange(first, n * per_chunk, /*used=*/true);
+            committed_ += n * per_chunk;
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = addr + i * chunk_size;
+            }
+            return n;
+        }
+    }
+
+    // 保留区已耗尽：与 allocate 相同，在锁外退回 mmap
+    const size_t n = overflow_.allocateBatch(chunk_size, count, out);
+    if (n > 0) {
+        overflowed_.store(true, std::memory_order_relaxed);
+    }
+    return n;
+}
+
+void ReservedArenaChunkAllocator::deallocate(void* ptr, size_t size) {
+    assert(ptr != nullptr && "Cannot deallocate a null pointer.");
+    assert(size > 0 && "Deallocation size must be positive.");
+
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+    if (addr - base_ >= reserved_bytes_) {
+        overflow_.deallocate(ptr, size);   // 保留区耗尽时的溢出 chunk
+        return;
+    }
+    assert(addr + size <= base_ + reserved_bytes_ &&
+           "deallocate: range straddles the end of the reserved arena");
+    assert((addr - base_) % kChunkSize == 0 && size % kChunkSize == 0);
+
+    const size_t first = (addr - base_) >> kChunkShift;
+    const size_t count = size / kChunkSize;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // 先清位再解除提交；用 MAP_FIXED 重新映射成 PROT_NONE，物理页立即交还内核
+    markRange(first, count, /*used=*/false);
+    committed_ -= count;
+
+    void* res = mmap(ptr, size, PROT_NONE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+    if (res != ptr) {
+        std::cerr << "[FATAL] ReservedArenaChunkAllocator::deallocate: decommit failed. "
+                  << "System error: " << strerror(errno) << " (errno=" << errno << ")."
+                  << std::endl;
+        assert(false && "decommit failed!");
+    }
+}
+
+size_t ReservedArenaChunkAllocator::getCommittedChunks() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return committed_;
+}
+
+void ReservedArenaChunkAllocator::markRange(size_t first, size_t count, bool used) noexcept {
+    for (size_t i = first; i < first + count; ++i) {
+        const uint64_t bit = uint64_t{1} << (i % 64);
+        if (used) {
+            assert(!isUsed(i));
+            used_[i / 64].fetch_or(bit, std::memory_order_relaxed);
+        } else {
+            assert(isUsed(i));
+            used_[i / 64].fetch_and(~bit, std::memory_order_relaxed);
+        }
+    }
+}
+
+size_t ReservedArenaChunkAllocator::findFreeRange(size_t count) const noexcept {
+    size_t run = 0;
+    size_t idx = 0;
+    while (idx < chunk_capacity_) {
+        // 整字已满：一次跳过 64 个 chunk
+        if (idx % 64 == 0 && used_[idx / 64].load(std::memory_order_relaxed) == ~uint64_t{0}) {
+            run = 0;
+            idx += 64;
+            continue;
+        }
+        if (isUsed(idx)) {
+            run = 0;
+        } else if (++run == count) {
+            return idx + 1 - count;
+        }
+        ++idx;
+    }
+    return chunk_capacity_;
+}
+
+size_t ReservedArenaChunkAllocator::findLongestFreeRange(size_t count, size_t* len) const noexcept {
+    size_t best_first = chunk_capacity_;
+    size_t best_len   = 0;
+    size_t run = 0;
+    size_t idx = 0;
+    while (idx < chunk_capacity_) {
+        if (idx % 64 == 0 && used_[idx / 64].load(std::memory_order_relaxed) == ~uint64_t{0}) {
+            run = 0;
+            idx += 64;
+            continue;
+        }
+        if (isUsed(idx)) {
+            run = 0;
+        } else if (++run > best_len) {
+            best_first = idx + 1 - run;
+            best_len   = run;
+            if (best_len == count) break;
+        }
+        ++idx;
+    }
+    *len = best_len;
+    return best_first;
+}
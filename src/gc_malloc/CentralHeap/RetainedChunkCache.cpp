@@ -0,0 +1,74 @@
+#include "gc_malloc/CentralHeap/RetainedChunkCache.hpp"
+#include <cassert>
+
+void* RetainedChunkCache::acquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    size_t best = kMaxEntries;
+    for (size_t i = 0; i < entry_count_; ++i) {
+        if (best == kMaxEntries ||
+            entries_[i].stage < entries_[best].stage ||
+            (entries_[i].stage == entries_[best].stage && entries_[i].since_ns > entries_[best].since_ns)) {
+            best = i;
+        }
+    }
+
+    if (best == kMaxEntries) {
+        return nullptr;
+    }
+
+    void* chunk = entries_[best].chunk;
+    // 用末尾条目填补空位，保持数组紧凑
+    entries_[best] = entries_[entry_count_ - 1];
+    entry_count_--;
+    return chunk;
+}
+
+bool RetainedChunkCache::deposit(void* chunk, ChunkDecayStage stage, uint64_t since_ns) {
+    if (chunk == nullptr) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (entry_count_ >= kMaxEntries) {
+        return false;
+    }
+    entries_[entry_count_++] = Entry{chunk, since_ns, stage};
+    return true;
+}
+
+size_t RetainedChunkCache::advance(uint64_t now_ns, uint64_t dirty_ns, uint64_t muzzy_ns,
+                                   ChunkAdviseCallback cb, void* ctx) {
+    assert(cb != nullptr);
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // 持锁 madvise：降级期间 chunk 不会被取走复用，不会丢失刚写入的数据
+    size_t advanced = 0;
+    for (size_t i = 0; i < entry_count_; ++i) {
+        Entry& e = entries_[i];
+        const uint64_t age = now_ns > e.since_ns ? now_ns - e.since_ns : 0;
+        const ChunkDecayStage to = decayTarget(e.stage, age, dirty_ns, muzzy_ns);
+        if (to == e.stage || !cb(ctx, e.chunk, 0, to)) {
+            continue;
+        }
+        e.stage    = to;
+        e.since_ns = now_ns;
+        ++advanced;
+    }
+    return advanced;
+}
+
+size_t RetainedChunkCache::getCacheCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entry_count_;
+}
+
+size_t RetainedChunkCache::getCount(ChunkDecayStage stage) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t n = 0;
+    for (size_t i = 0; i < entry_count_; ++i) {
+        if (entries_[i].stage == stage) ++n;
+    }
+    return n;
+}
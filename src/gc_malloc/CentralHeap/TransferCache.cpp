@@ -0,0 +1,46 @@
+#include "gc_malloc/CentralHeap/TransferCache.hpp"
+
+#include <algorithm>
+
+size_t TransferCache::insert(void* const* blocks, size_t n) {
+    if (blocks == nullptr || n == 0) {
+        return 0;
+    }
+    // 无锁预判：已满时不去争锁
+    if (count_.load(std::memory_order_relaxed) >= capacity_) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const size_t count = count_.load(std::memory_order_relaxed);
+    if (count >= capacity_) {
+        return 0;
+    }
+    const size_t k = std::min(n, capacity_ - count);
+    std::copy(blocks, blocks + k, slots_ + count);
+    count_.store(count + k, std::memory_order_relaxed);
+    return k;
+}
+
+size_t TransferCache::remove(void** out, size_t n) {
+    if (out == nullptr || n == 0) {
+        return 0;
+    }
+    if (count_.load(std::memory_order_relaxed) == 0) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const size_t count = count_.load(std::memory_order_relaxed);
+    const size_t k = std::min(n, count);
+    // 取栈顶一段：最近存入的块最可能还在缓存里
+    std::copy(slots_ + (count - k), slots_ + count, out);
+    count_.store(count - k, std::memory_order_relaxed);
+    return k;
+}
+
+void TransferCache::setCapacity(size_t capacity) {
+    capacity_ = std::min(capacity, kMaxBlocks);
+}
@@ -0,0 +1,162 @@
+#include "gc_malloc/Shim/MallocApi.hpp"
+
+#include "gc_malloc/ThreadHeap/ThreadHeap.hpp"
+#include "gc_malloc/ThreadHeap/SizeClassConfig.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+// 块的状态与链表节点都记录在带外（子池位图 / 对象头部），ThreadHeap 返回的块首直接交给用户。
+
+namespace {
+
+constexpr std::size_t kMinAlignment = SizeClassConfig::kAlignment;   // 16B，与 max_align_t 一致
+constexpr std::size_t kPageSize     = SizeClassConfig::kPageSize;
+
+inline bool isPowerOfTwo(std::size_t x) noexcept {
+    return x != 0 && (x & (x - 1)) == 0;
+}
+
+inline std::uintptr_t alignUp(std::uintptr_t v, std::size_t a) noexcept {
+    return (v + a - 1) & ~(static_cast<std::uintptr_t>(a) - 1);
+}
+
+// 对齐分配：多申请 alignment 字节，在块内取对齐位置；
+// 释放时由 ThreadHeap::deallocate 经 PageMap 从内部指针找回块首（任意 chunk 内均可）。
+void* allocateAligned(std::size_t alignment, std::size_t size) noexcept {
+    if (alignment <= kMinAlignment) {
+        return gc_malloc(size);
+    }
+    // 块首至少 kMinAlignment 对齐，多出 alignment - kMinAlignment 字节即可容纳对齐偏移
+    const std::size_t slack = alignment - kMinAlignment;
+    if (size > SIZE_MAX - slack) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+
+    void* blk = ThreadHeap::allocate(size + slack);
+    if (!blk) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+
+    const std::uintptr_t user = alignUp(reinterpret_cast<std::uintptr_t>(blk), alignment);
+    return reinterpret_cast<void*>(user);
+}
+
+} // namespace
+
+// -------------------- 基本分配 / 释放 --------------------
+
+void* gc_malloc(std::size_t size) noexcept {
+    void* p = ThreadHeap::allocate(size);
+    if (!p) {
+        errno = ENOMEM;
+    }
+    return p;
+}
+
+void gc_free(void* ptr) noexcept {
+    if (!ptr) return;
+    ThreadHeap::deallocate(ptr);   // 对齐分配得到的内部指针由 ThreadHeap 经 PageMap 找回块首
+}
+
+void* gc_calloc(std::size_t count, std::size_t size) noexcept {
+    std::size_t total = 0;
+    if (__builtin_mul_overflow(count, size, &total)) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+
+    void* p = gc_malloc(total);
+    if (p) {
+        // chunk 可能来自缓存复用，不能假定内容为 0
+        std::memset(p, 0, total);
+    }
+    return p;
+}
+
+void* gc_realloc(void* ptr, std::size_t size) noexcept {
+    if (!ptr) return gc_malloc(size);
+    if (size == 0) {
+        gc_free(ptr);
+        return nullptr;
+    }
+
+    const std::size_t old_usable = ThreadHeap::usableSize(ptr);
+    if (size <= old_usable) {
+        return ptr;  // 原块放得下：原地返回
+    }
+
+    void* fresh = gc_malloc(size);
+    if (!fresh) return nullptr;  // 失败时原块保持不变
+
+    std::memcpy(fresh, ptr, old_usable);
+    gc_free(ptr);
+    return fresh;
+}
+
+void* gc_reallocarray(void* ptr, std::size_t count, std::size_t size) noexcept {
+    std::size_t total = 0;
+    if (__builtin_mul_overflow(count, size, &total)) {
+        errno = ENOMEM;   // 与 glibc 一致：溢出时原块保持不变
+        return nullptr;
+    }
+    return gc_realloc(ptr, total);
+}
+
+// -------------------- 对齐分配 --------------------
+
+int gc_posix_memalign(void** memptr, std::size_t alignment, std::size_t size) noexcept {
+    if (!isPowerOfTwo(alignment) || alignment % sizeof(void*) != 0) {
+        return EINVAL;
+    }
+
+    void* p = allocateAligned(alignment, size);
+    if (!p) return ENOMEM;
+
+    *memptr = p;
+    return 0;
+}
+
+void* gc_aligned_alloc(std::size_t alignment, std::size_t size) noexcept {
+    if (!isPowerOfTwo(alignment)) {
+        errno = EINVAL;
+        return nullptr;
+    }
+    return allocateAligned(alignment, size);
+}
+
+void* gc_memalign(std::size_t alignment, std::size_t size) noexcept {
+    // 与 glibc 一致：非 2 的幂的对齐向上取整
+    if (alignment > (SIZE_MAX >> 1) + 1) {
+        errno = EINVAL;
+        return nullptr;
+    }
+    std::size_t a = kMinAlignment;
+    while (a < alignment) {
+        a <<= 1;
+    }
+    return allocateAligned(a, size);
+}
+
+void* gc_valloc(std::size_t size) noexcept {
+    return allocateAligned(kPageSize, size);
+}
+
+void* gc_pvalloc(std::size_t size) noexcept {
+    // 与 glibc 一致：大小向上取整到页，0 字节也给一整页
+    const std::size_t rounded = (size == 0) ? kPageSize : alignUp(size, kPageSize);
+    if (rounded < size) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+    return allocateAligned(kPageSize, rounded);
+}
+
+// -------------------- 查询 --------------------
+
+std::size_t gc_malloc_usable_size(void* ptr) noexcept {
+    return ThreadHeap::usableSize(ptr);
+}
@@ -0,0 +1,174 @@
+// MallocOverride.cpp
+// 仅编入共享库 libgc_malloc.so：以标准名字导出 malloc 族和全局 operator new/delete，
+// 全部转发到 MallocApi 中的 gc_ 接口。链接或 LD_PRELOAD 该库即可替换系统分配器。
+
+#include "gc_malloc/Shim/MallocApi.hpp"
+
+#include <cstddef>
+#include <new>
+
+#define GC_EXPORT __attribute__((visibility("default")))
+
+// -------------------- C 接口 --------------------
+// 与 glibc 的声明保持一致（C++ 下 __THROW 展开为 noexcept）。
+
+extern "C" {
+
+GC_EXPORT void* malloc(std::size_t size) noexcept {
+    return gc_malloc(size);
+}
+
+GC_EXPORT void free(void* ptr) noexcept {
+    gc_free(ptr);
+}
+
+GC_EXPORT void* calloc(std::size_t count, std::size_t size) noexcept {
+    return gc_calloc(count, size);
+}
+
+GC_EXPORT void* realloc(void* ptr, std::size_t size) noexcept {
+    return gc_realloc(ptr, size);
+}
+
+GC_EXPORT void* reallocarray(void* ptr, std::size_t count, std::size_t size) noexcept {
+    return gc_reallocarray(ptr, count, size);
+}
+
+// 旧式接口，glibc 仍导出：不转发的话会落到系统分配器上释放本库的块
+GC_EXPORT void cfree(void* ptr) noexcept {
+    gc_free(ptr);
+}
+
+GC_EXPORT int posix_memalign(void** memptr, std::size_t alignment, std::size_t size) noexcept {
+    return gc_posix_memalign(memptr, alignment, size);
+}
+
+GC_EXPORT void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept {
+    return gc_aligned_alloc(alignment, size);
+}
+
+GC_EXPORT void* memalign(std::size_t alignment, std::size_t size) noexcept {
+    return gc_memalign(alignment, size);
+}
+
+GC_EXPORT void* valloc(std::size_t size) noexcept {
+    return gc_valloc(size);
+}
+
+GC_EXPORT void* pvalloc(std::size_t size) noexcept {
+    return gc_pvalloc(size);
+}
+
+GC_EXPORT std::size_t malloc_usable_size(void* ptr) noexcept {
+    return gc_malloc_usable_size(ptr);
+}
+
+} // extern "C"
+
+// -------------------- 全局 operator new / delete --------------------
+
+namespace {
+
+// 标准要求：分配失败时循环调用 new_handler，没有 handler 才抛出 bad_alloc
+void* newImpl(std::size_t size, std::size_t alignment) {
+    for (;;) {
+        void* p = (alignment <= alignof(std::max_align_t))
+                      ? gc_malloc(size)
+                      : gc_aligned_alloc(alignment, size);
+        if (p) return p;
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* newNothrowImpl(std::size_t size, std::size_t alignment) noexcept {
+    try {
+        return newImpl(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+} // namespace
+
+GC_EXPORT void* operator new(std::size_t size) {
+    return newImpl(size, 0);
+}
+
+GC_EXPORT void* operator new[](std::size_t size) {
+    return newImpl(size, 0);
+}
+
+GC_EXPORT void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return newNothrowImpl(size, 0);
+}
+
+GC_EXPORT void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return newNothrowImpl(size, 0);
+}
+
+GC_EXPORT void* operator new(std::size_t size, std::align_val_t al) {
+    return newImpl(size, static_cast<std::size_t>(al));
+}
+
+GC_EXPORT void* operator new[](std::size_t size, std::align_val_t al) {
+    return newImpl(size, static_cast<std::size_t>(al));
+}
+
+GC_EXPORT void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return newNothrowImpl(size, static_cast<std::size_t>(al));
+}
+
+GC_EXPORT void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return newNothrowImpl(size, static_cast<std::size_t>(al));
+}
+
+GC_EXPORT void operator delete(void* ptr) noexcept {
+    gc_free(ptr);
+}
+
+GC_EXPORT void operator delete[](void* ptr) noexcept {
+    gc_free(ptr);
+}
+
+GC_EXPORT void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    gc_free(ptr);
+}
+
+GC_EXPORT void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    gc_free(ptr);
+}
+
+GC_EXPORT void operator delete(void* ptr, std::size_t) noexcept {
+    gc_free(ptr);
+}
+
+GC_EXPORT void operator delete[](void* ptr, std::size_t) noexcept {
+    gc_free(ptr);
+}
+
+GC_EXPORT void operator delete(void* ptr, std::align_val_t) noexcept {
+    gc_free(ptr);
+}
+
+GC_EXPORT void operator delete[](void* ptr, std::align_val_t) noexcept {
+    gc_free(ptr);
+}
+
+GC_EXPORT void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    gc_free(ptr);
+}
+
+GC_EXPORT void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    gc_free(ptr);
+}
+
+GC_EXPORT void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    gc_free(ptr);
+}
+
+GC_EXPORT void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+    gc_free(ptr);
+}
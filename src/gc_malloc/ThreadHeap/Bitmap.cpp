@@ -1,10 +1,80 @@
 #include "gc_malloc/ThreadHeap/Bitmap.hpp"
-#include <cstring>   // For std::memset
+#include <atomic>
+#include <cstring>   // For std::memset, std::memcpy
 #include <stdexcept> // For std::runtime_error
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GC_MALLOC_BITMAP_X86 1
+#endif
+
+// ===== 全满字节的批量跳过 =====
+// 返回 [begin, end) 中第一个“不全为 0xFF”的 8 字节组的起点（begin 与返回值都是 8 的倍数）；
+// 全部为满时返回 end 向下取整到 8 的倍数。按 CPU 能力在运行时选择 AVX2 / SSE4.2 / 标量实现。
+namespace {
+
+using SkipFn = size_t (*)(const unsigned char*, size_t, size_t);
+
+size_t skipFullScalar(const unsigned char* buf, size_t begin, size_t end) {
+    while (begin + 8 <= end) {
+        uint64_t w;
+        std::memcpy(&w, buf + begin, sizeof(w));
+        if (w != ~0ull) break;
+        begin += 8;
+    }
+    return begin;
+}
+
+#ifdef GC_MALLOC_BITMAP_X86
+__attribute__((target("avx2")))
+size_t skipFullAvx2(const unsigned char* buf, size_t begin, size_t end) {
+    const __m256i ones = _mm256_set1_epi8(-1);
+    while (begin + 32 <= end) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buf + begin));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, ones)) != -1) break;
+        begin += 32;
+    }
+    return skipFullScalar(buf, begin, end);
+}
+
+__attribute__((target("sse4.2")))
+size_t skipFullSse42(const unsigned char* buf, size_t begin, size_t end) {
+    while (begin + 16 <= end) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + begin));
+        if (!_mm_test_all_ones(v)) break;
+        begin += 16;
+    }
+    return skipFullScalar(buf, begin, end);
+}
+#endif
+
+SkipFn resolveSkip() {
+#ifdef GC_MALLOC_BITMAP_X86
+    // 可能在静态构造之前被调用（malloc 替换库），先显式初始化 cpuid 结果
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))   return &skipFullAvx2;
+    if (__builtin_cpu_supports("sse4.2")) return &skipFullSse42;
+#endif
+    return &skipFullScalar;
+}
+
+// 惰性解析：并发首次调用的结果相同，重复写入无害
+std::atomic<SkipFn> g_skip_full{nullptr};
+
+inline size_t skipFullBytes(const unsigned char* buf, size_t begin, size_t end) {
+    SkipFn fn = g_skip_full.load(std::memory_order_relaxed);
+    if (__builtin_expect(fn == nullptr, 0)) {
+        fn = resolveSkip();
+        g_skip_full.store(fn, std::memory_order_relaxed);
+    }
+    return fn(buf, begin, end);
+}
+
+} // namespace
+
 
 // 构造函数
-Bitmap::Bitmap(size_t capacity_in_bits, unsigned char* buffer, size_t buffer_size_in_bytes)
+Bitmap::Bitmap(size_t capacity_in_bits, unsigned char* buffer, size_t buffer_size_in_bytes, bool zero_fill)
     : buffer_(buffer),
       capacity_in_bits_(capacity_in_bits)
 {
@@ -18,6 +88,10 @@ Bitmap::Bitmap(size_t capacity_in_bits, unsigned char* buffer, size_t buffer_siz
         throw std::runtime_error("Bitmap buffer is smaller than required.");
     }
     
+    if (!zero_fill) {
+        return;
+    }
+
     // 3. 将所有有效字节初始化为 0 (空闲)
     std::memset(buffer_, 0, required_bytes);
 
@@ -70,43 +144,119 @@ bool Bitmap::isUsed(size_t bit_index) const {
 }
 
 // 从指定的起始位置开始，查找第一个为 0 (空闲) 的位。
+// 每次取 64 位，取反后用 ctz 直接定位；连续的全满字交给 skipFullBytes 批量跳过。
 size_t Bitmap::findFirstFree(size_t start_bit) const {
-    size_t current_bit = start_bit;
+    if (start_bit >= capacity_in_bits_) return k_not_found;
+
     const size_t required_bytes = (capacity_in_bits_ + 7) / 8;
+    const size_t word_count     = wordCount();
+    const size_t full_bytes     = (required_bytes / 8) * 8;   // 可整字读取的范围
 
-    // 1. 处理起始字节中剩余的位
-    size_t byte_index = current_bit / 8;
-    if (byte_index < required_bytes) {
-        size_t bit_in_byte = current_bit % 8;
-        if (bit_in_byte != 0) {
-            for (size_t bit = bit_in_byte; bit < 8; ++bit) {
-                if (current_bit >= capacity_in_bits_) return k_not_found;
-                if (!isUsed(current_bit)) {
-                    return current_bit;
-                }
-                current_bit++;
-            }
-            byte_index++;
-        }
+    size_t   word      = start_bit / 64;
+    uint64_t free_bits = ~loadWord(word) & (~0ull << (start_bit % 64));
+
+    while (free_bits == 0) {
+        ++word;
+        if (word >= word_count) return k_not_found;
+
+        word = skipFullBytes(buffer_, word * 8, full_bytes) / 8;
+        if (word >= word_count) return k_not_found;
+        free_bits = ~loadWord(word);
+    }
+
+    const size_t bit = word * 64 + static_cast<size_t>(__builtin_ctzll(free_bits));
+    return bit < capacity_in_bits_ ? bit : k_not_found;
+}
+
+// 查找连续 n 个空闲位：交替定位“下一个空闲位”和“其后第一个占用位”，两者都是字级扫描
+size_t Bitmap::findFirstFreeRun(size_t n, size_t start_bit) const {
+    if (n == 0) return k_not_found;
+
+    size_t pos = start_bit;
+    while (true) {
+        const size_t first = findFirstFree(pos);
+        if (first == k_not_found || n > capacity_in_bits_ - first) return k_not_found;
+
+        const size_t used = findFirstUsed(first);
+        if (used - first >= n) return first;
+        pos = used;
+    }
+}
+
+size_t Bitmap::findFirstUsed(size_t start_bit) const {
+    if (start_bit >= capacity_in_bits_) return capacity_in_bits_;
+
+    const size_t word_count = wordCount();
+
+    size_t   word      = start_bit / 64;
+    uint64_t used_bits = loadWord(word) & (~0ull << (start_bit % 64));
+
+    while (used_bits == 0) {
+        if (++word >= word_count) return capacity_in_bits_;
+        used_bits = loadWord(word);
+    }
+
+    const size_t bit = word * 64 + static_cast<size_t>(__builtin_ctzll(used_bits));
+    return bit < capacity_in_bits_ ? bit : capacity_in_bits_;
+}
+
+// 小端拼字：第 i 位位于第 i/8 字节的第 i%8 位，与逐位接口的位序一致
+uint64_t Bitmap::loadWord(size_t word_index) const {
+    const size_t required_bytes = (capacity_in_bits_ + 7) / 8;
+    const size_t first_byte     = word_index * 8;
+
+    if (first_byte + 8 <= required_bytes) {
+        uint64_t w;
+        std::memcpy(&w, buffer_ + first_byte, sizeof(w));
+        return w;
     }
 
-    // 2. 快速检查完整的字节
-    //    我们可以一次检查一个字节是否为 0xFF (全被占用)。
-    while (byte_index < required_bytes && buffer_[byte_index] == 0xFF) {
-        byte_index++;
+    uint64_t w = ~0ull;
+    for (size_t i = 0; first_byte + i < required_bytes; ++i) {
+        w &= ~(0xFFull << (8 * i));
+        w |= static_cast<uint64_t>(buffer_[first_byte + i]) << (8 * i);
     }
+    return w;
+}
 
-    // 3. 逐位检查找到的第一个不完全占用的字节
-    if (byte_index < required_bytes) {
-        current_bit = byte_index * 8;
-        for (size_t bit = 0; bit < 8; ++bit) {
-            if (current_bit >= capacity_in_bits_) return k_not_found;
-            if (!isUsed(current_bit)) {
-                return current_bit;
-            }
-            current_bit++;
+// 按 64 位字清位：位序与 markAsUsed 一致（第 i 位位于第 i/8 字节的第 i%8 位）。
+// 只处理容量内的字节，mask 中超出容量的位被忽略。
+size_t Bitmap::clearMask(size_t word_index, uint64_t mask) {
+    const size_t required_bytes = (capacity_in_bits_ + 7) / 8;
+    size_t cleared = 0;
+
+    for (size_t i = 0; i < 8 && mask != 0; ++i, mask >>= 8) {
+        const size_t byte_index = word_index * 8 + i;
+        if (byte_index >= required_bytes) break;
+
+        unsigned char bits = static_cast<unsigned char>(mask & 0xFF);
+        if (byte_index == required_bytes - 1 && capacity_in_bits_ % 8 != 0) {
+            bits &= static_cast<unsigned char>((1u << (capacity_in_bits_ % 8)) - 1);
         }
+
+        const unsigned char hit = buffer_[byte_index] & bits;
+        buffer_[byte_index] &= static_cast<unsigned char>(~hit);
+        cleared += static_cast<size_t>(__builtin_popcount(hit));
     }
+    return cleared;
+}
+
+size_t Bitmap::setMask(size_t word_index, uint64_t mask) {
+    const size_t required_bytes = (capacity_in_bits_ + 7) / 8;
+    size_t set = 0;
+
+    for (size_t i = 0; i < 8 && mask != 0; ++i, mask >>= 8) {
+        const size_t byte_index = word_index * 8 + i;
+        if (byte_index >= required_bytes) break;
 
-    return k_not_found; // 没有找到任何空闲位
+        unsigned char bits = static_cast<unsigned char>(mask & 0xFF);
+        if (byte_index == required_bytes - 1 && capacity_in_bits_ % 8 != 0) {
+            bits &= static_cast<unsigned char>((1u << (capacity_in_bits_ % 8)) - 1);
+        }
+
+        const unsigned char hit = static_cast<unsigned char>(~buffer_[byte_index] & bits);
+        buffer_[byte_index] |= hit;
+        set += static_cast<size_t>(__builtin_popcount(hit));
+    }
+    return set;
 }
@@ -0,0 +1,33 @@
+// BlockCache.cpp
+#include "gc_malloc/ThreadHeap/BlockCache.hpp"
+
+namespace {
+
+constexpr std::size_t capacityFor(std::size_t block_size) noexcept {
+    const std::size_t n = block_size ? BlockCache::kBytesPerClass / block_size : BlockCache::kMaxCapacity;
+    if (n < BlockCache::kMinCapacity) return BlockCache::kMinCapacity;
+    if (n > BlockCache::kMaxCapacity) return BlockCache::kMaxCapacity;
+    return n;
+}
+
+} // namespace
+
+BlockCache::BlockCache(std::size_t block_size) noexcept
+    : capacity_(capacityFor(block_size)) {}
+
+std::size_t BlockCache::popBatch(void** out, std::size_t n) noexcept {
+    std::size_t got = 0;
+    while (got < n && head_) {
+        out[got++] = head_;
+        head_ = head_->next;
+    }
+    count_ -= got;
+    return got;
+}
+
+bool BlockCache::contains(const void* block) const noexcept {
+    for (const FreeNode* node = head_; node; node = node->next) {
+        if (node == block) return true;
+    }
+    return false;
+}
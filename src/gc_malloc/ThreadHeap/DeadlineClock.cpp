@@ -0,0 +1,120 @@
+// DeadlineClock.cpp
+#include "gc_malloc/ThreadHeap/DeadlineClock.hpp"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define GC_MALLOC_HAVE_TSC 1
+#else
+#define GC_MALLOC_HAVE_TSC 0
+#endif
+
+namespace {
+
+// 两次读数间隔至少这么久才求比值：1ms 内 steady_clock 的抖动对比值的影响在千分之一量级
+constexpr std::int64_t kCalibrationWindowNs = 1000 * 1000;
+
+std::atomic<std::uint64_t> g_ref_tsc{0};
+std::atomic<std::int64_t>  g_ref_ns{0};
+std::atomic<std::uint64_t> g_ticks_per_kns{0};   // 0 表示尚未标定
+
+bool invariantTsc() noexcept {
+#if GC_MALLOC_HAVE_TSC
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid_max(0x80000000u, nullptr) < 0x80000007u) return false;
+    __cpuid(0x80000007u, eax, ebx, ecx, edx);
+    return (edx & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+const bool g_tsc_usable = invariantTsc();
+
+// 截止时间的换算与相加都饱和到 UINT64_MAX：极大的预算等同于不设期限，而不是回绕成立即到期
+std::uint64_t budgetTicks(std::uint64_t budget_ns, std::uint64_t ticks_per_kns) noexcept {
+    std::uint64_t product = 0;
+    return __builtin_mul_overflow(budget_ns, ticks_per_kns, &product) ? UINT64_MAX : product / 1024;
+}
+
+std::uint64_t saturatingAdd(std::uint64_t a, std::uint64_t b) noexcept {
+    std::uint64_t r = 0;
+    return __builtin_add_overflow(a, b, &r) ? UINT64_MAX : r;
+}
+
+// 返回每 1024ns 的 TSC 周期数；尚未标定完成时推进标定并返回 0
+std::uint64_t calibratedTicksPerKns(std::uint64_t tsc, std::int64_t ns) noexcept {
+    const std::uint64_t ratio = g_ticks_per_kns.load(std::memory_order_relaxed);
+    if (ratio != 0 || !g_tsc_usable) return ratio;
+
+    const std::int64_t ref_ns = g_ref_ns.load(std::memory_order_acquire);
+    if (ref_ns == 0) {
+        // 第一次使用：只记下参考点。抢到 TSC 的线程再以 release 发布对应的纳秒读数
+        std::uint64_t expected = 0;
+        if (g_ref_tsc.compare_exchange_strong(expected, tsc, std::memory_order_relaxed)) {
+            g_ref_ns.store(ns, std::memory_order_release);
+        }
+        return 0;
+    }
+
+    const std::int64_t dns = ns - ref_ns;
+    const std::uint64_t ref_tsc = g_ref_tsc.load(std::memory_order_relaxed);
+    if (dns < kCalibrationWindowNs || tsc <= ref_tsc) return 0;
+
+    const std::uint64_t computed = (tsc - ref_tsc) * 1024 / static_cast<std::uint64_t>(dns);
+    if (computed == 0) return 0;
+    g_ticks_per_kns.store(computed, std::memory_order_relaxed);
+    return computed;
+}
+
+} // namespace
+
+std::uint64_t DeadlineClock::readTsc() noexcept {
+#if GC_MALLOC_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+std::int64_t DeadlineClock::steadyNs() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+DeadlineClock::DeadlineClock(std::chrono::nanoseconds budget) noexcept
+    : use_tsc_(false), start_(0), deadline_(0), ticks_per_kns_(0) {
+    const std::uint64_t budget_ns = budget.count() > 0 ? static_cast<std::uint64_t>(budget.count()) : 0;
+
+    if (g_tsc_usable) {
+        const std::uint64_t tsc = readTsc();
+        ticks_per_kns_ = g_ticks_per_kns.load(std::memory_order_relaxed);
+        if (ticks_per_kns_ == 0) {
+            ticks_per_kns_ = calibratedTicksPerKns(tsc, steadyNs());
+        }
+        if (ticks_per_kns_ != 0) {
+            use_tsc_  = true;
+            start_    = tsc;
+            deadline_ = saturatingAdd(tsc, budgetTicks(budget_ns, ticks_per_kns_));
+            return;
+        }
+    }
+
+    start_    = static_cast<std::uint64_t>(steadyNs());
+    deadline_ = saturatingAdd(start_, budget_ns);
+}
+
+bool DeadlineClock::expired() const noexcept {
+    if (use_tsc_) return readTsc() >= deadline_;
+    return static_cast<std::uint64_t>(steadyNs()) >= deadline_;
+}
+
+std::chrono::nanoseconds DeadlineClock::elapsed() const noexcept {
+    if (use_tsc_) {
+        const std::uint64_t ticks = readTsc() - start_;
+        return std::chrono::nanoseconds(static_cast<std::int64_t>(ticks * 1024 / ticks_per_kns_));
+    }
+    return std::chrono::nanoseconds(steadyNs() - static_cast<std::int64_t>(start_));
+}
@@ -0,0 +1,40 @@
+// LargeObject.cpp
+#include "gc_malloc/ThreadHeap/LargeObject.hpp"
+
+#include <cstdint>
+
+static_assert(sizeof(LargeObject) <= LargeObject::kHeaderSize,
+              "LargeObject header must fit in kHeaderSize");
+
+LargeObject::LargeObject(std::size_t mapped_bytes) noexcept
+    : magic_(kLargeMagic),
+      mapped_bytes_(mapped_bytes),
+      managed_node_(BlockState::Used) {}
+
+LargeObject::~LargeObject() {
+    // 抹掉魔数：映射被缓存复用为子池或其他大对象时不能再被误认
+    magic_ = 0;
+}
+
+void* LargeObject::block() noexcept {
+    return reinterpret_cast<char*>(this) + kHeaderSize;
+}
+
+std::size_t LargeObject::blockSize() const noexcept {
+    return mapped_bytes_ - kHeaderSize;
+}
+
+std::size_t LargeObject::mappedBytes() const noexcept {
+    return mapped_bytes_;
+}
+
+std::size_t LargeObject::mappingSizeFor(std::size_t nbytes) noexcept {
+    if (nbytes > SIZE_MAX - kHeaderSize - kChunkSize) return 0;
+    const std::size_t total = nbytes + kHeaderSize;
+    return (total + kChunkSize - 1) & ~(kChunkSize - 1);
+}
+
+bool LargeObject::isLargeObjectHeader(const void* base) noexcept {
+    if (base == nullptr) return false;
+    return static_cast<const LargeObject*>(base)->magic_ == kLargeMagic;
+}
@@ -7,19 +7,52 @@ ManagedList::ManagedList() noexcept
       cursor_prev_(nullptr),
       cursor_cur_(nullptr) {}
 
-void ManagedList::appendUsed(BlockHeader* blk) noexcept {
-    if (!blk) return;
+bool ManagedList::appendUsed(BlockHeader* blk) noexcept {
+    if (!blk) return false;
     blk->storeUsed();
+    return append(blk);
+}
+
+bool ManagedList::append(BlockHeader* blk) noexcept {
+    if (!blk) return false;
     blk->next = nullptr;
+    ++size_;
 
     if (!head_) {
         head_ = tail_ = blk;
         // 若游标尚未初始化，保持为空；由 reset_cursor() 显式开启一轮遍历
-        return;
+        return true;
     }
 
     tail_->next = blk;
     tail_ = blk;
+    return true;
+}
+
+BlockHeader* ManagedList::unlinkAtCursor() noexcept {
+    BlockHeader* cur = cursor_cur_;
+    BlockHeader* nxt = cur->next;
+
+    // 从链表中摘除 cur
+    if (cursor_prev_) {
+        cursor_prev_->next = nxt;
+    } else {
+        // 移除的是头结点
+        head_ = nxt;
+    }
+
+    if (cur == tail_) {
+        // 更新尾指针
+        tail_ = cursor_prev_;
+    }
+
+    // 断开 cur->next，返回给上层回收处理
+    cur->next = nullptr;
+    --size_;
+
+    // 游标前驱不变（仍指向摘除前的前驱）
+    cursor_cur_ = nxt;
+    return cur;
 }
 
 BlockHeader* ManagedList::reclaimNextFree() noexcept {
@@ -27,34 +60,13 @@ BlockHeader* ManagedList::reclaimNextFree() noexcept {
     if (!cursor_cur_) return nullptr;
 
     while (cursor_cur_) {
-        BlockHeader* cur = cursor_cur_;
-        BlockHeader* nxt = cur->next;
-
-        if (cur->loadState() == BlockState::Free) {
-            // 从链表中摘除 cur
-            if (cursor_prev_) {
-                cursor_prev_->next = nxt;
-            } else {
-                // 移除的是头结点
-                head_ = nxt;
-            }
-
-            if (cur == tail_) {
-                // 更新尾指针
-                tail_ = cursor_prev_;
-            }
-
-            // 断开 cur->next，返回给上层回收处理
-            cur->next = nullptr;
-
-            // 游标前驱不变（仍指向摘除前的前驱）
-            cursor_cur_ = nxt;
-            return cur;
+        if (cursor_cur_->loadState() == BlockState::Free) {
+            return unlinkAtCursor();
         }
 
         // 未释放：向前推进游标
-        cursor_prev_ = cur;
-        cursor_cur_  = nxt;
+        cursor_prev_ = cursor_cur_;
+        cursor_cur_  = cursor_cur_->next;
     }
 
     // 遍历到末尾未发现可回收块
@@ -64,6 +76,60 @@ BlockHeader* ManagedList::reclaimNextFree() noexcept {
 void ManagedList::resetCursor() noexcept {
     cursor_prev_ = nullptr;
     cursor_cur_  = head_;
+    in_pass_      = true;
+    pass_visited_ = 0;
+    pass_size_    = size_;
+    pass_end_      = tail_;
+    pass_end_seen_ = (tail_ == nullptr);
+}
+
+BlockHeader* ManagedList::sweepNextFree(std::size_t max_visit, std::size_t* visited) noexcept {
+    if (!in_pass_) {
+        // 回绕：从表头开始新一轮
+        resetCursor();
+    }
+
+    std::size_t n = 0;
+    while (n < max_visit) {
+        if (pass_end_seen_ || !cursor_cur_) {
+            // 本轮结束：开始后尾插的节点（含重新挂回的子池）留给下一轮，
+            // 否则持续被远端释放的子池会在同一轮里反复摘除、挂回，整轮永远走不完
+            in_pass_  = false;
+            pass_end_ = nullptr;
+            ++epoch_;
+            break;
+        }
+
+        ++n;
+        ++pass_visited_;
+        if (cursor_cur_ == pass_end_) pass_end_seen_ = true;
+        if (cursor_cur_->loadState() == BlockState::Free) {
+            if (visited) *visited += n;
+            return unlinkAtCursor();
+        }
+
+        cursor_prev_ = cursor_cur_;
+        cursor_cur_  = cursor_cur_->next;
+    }
+
+    if (visited) *visited += n;
+    return nullptr;
+}
+
+void ManagedList::drain(VisitCallback cb, void* ctx) noexcept {
+    BlockHeader* cur = head_;
+    head_ = tail_ = nullptr;
+    cursor_prev_ = cursor_cur_ = nullptr;
+    pass_end_ = nullptr;
+    size_    = 0;
+    in_pass_ = false;
+
+    while (cur) {
+        BlockHeader* nxt = cur->next;   // 回调可能改写 next
+        cur->next = nullptr;
+        cb(ctx, cur);
+        cur = nxt;
+    }
 }
 
 bool ManagedList::empty() const noexcept {
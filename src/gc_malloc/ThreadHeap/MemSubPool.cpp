@@ -9,6 +9,14 @@ namespace {
     inline size_t align_up(size_t value, size_t alignment) {
         return (value + alignment - 1) & ~(alignment - 1);
     }
+
+    // 第 word 个字中位于 bump 之下（已分配过）的位
+    inline uint64_t belowBumpMask(size_t word, size_t bump) {
+        const size_t first = word * 64;
+        if (first + 64 <= bump) return ~0ull;
+        if (first >= bump) return 0;
+        return (1ull << (bump - first)) - 1;
+    }
 }
 
 size_t MemSubPool::calculateDataOffset() {
@@ -27,59 +35,153 @@ size_t MemSubPool::calculateTotalBlockCount(size_t block_size, size_t data_offse
 }
 
 
-MemSubPool::MemSubPool(size_t block_size):
+MemSubPool::MemSubPool(size_t block_size, uint32_t size_class):
     magic_(kPoolMagic),
-    lock_(),
+    size_class_(size_class),
+    owner_(std::this_thread::get_id()),
     block_size_(block_size),
     data_offset_(calculateDataOffset()),
     total_block_count_(calculateTotalBlockCount(block_size, data_offset_)),
     used_block_count_(0),
-    next_free_block_hint_(0),
-    bitmap_buffer_{0},
-    bitmap_(total_block_count_, bitmap_buffer_, kBitMapLength)
+    bump_index_(0),
+    remote_head_(0),
+    remote_notice_word_(nullptr),
+    remote_notice_bit_(0),
+    summary_(kBitMapWords),
+    bitmap_(total_block_count_, bitmap_buffer_, kBitMapLength, /*zero_fill=*/false)
 {
     if (total_block_count_ > kBitMapLength * 8) {
         throw std::logic_error("Calculated total block count exceeds bitmap capacity.");
     }
+    static_assert(kBitMapWords < UINT16_MAX, "remote_next_ stores word indices as uint16_t");
+    // 位图与释放请求位图都不清零：新子池处于 bump 模式，只有 bump 走过的位才会被读取
 }
 
 // --- 析构函数 ---
 // 在这里执行清理工作。
 MemSubPool::~MemSubPool() {
+    // 抹掉魔数：chunk 回收后可能被当作其他用途，不能再被识别为子池
+    magic_ = 0;
 }
 
 
 // --- 公共接口实现 ---
 
 void* MemSubPool::allocate() {
-    std::lock_guard<std::mutex> guard(lock_);
+    if (!isOwnedByCurrentThread()) {
+        fprintf(stderr, "Error: Only the owning thread may allocate from a sub-pool.\n");
+        return nullptr;
+    }
 
     // 如果已知池已满，可以直接返回。
     if (used_block_count_.load(std::memory_order_relaxed) >= total_block_count_) {
         return nullptr;
     }
 
+    void* block_ptr = nullptr;
+    allocateOwned(&block_ptr, 1);
+    return block_ptr;
+}
 
-    size_t free_block_index = bitmap_.findFirstFree(next_free_block_hint_);
-    
-    if (free_block_index == Bitmap::k_not_found && next_free_block_hint_ > 0) {
-        free_block_index = bitmap_.findFirstFree(0);
+
+size_t MemSubPool::allocateBatch(void** out, size_t max_count) {
+    if (out == nullptr || max_count == 0) {
+        return 0;
     }
+    if (!isOwnedByCurrentThread()) {
+        fprintf(stderr, "Error: Only the owning thread may allocate from a sub-pool.\n");
+        return 0;
+    }
+    return allocateOwned(out, max_count);
+}
 
-    if (free_block_index != Bitmap::k_not_found) {
-        bitmap_.markAsUsed(free_block_index);
 
-        used_block_count_.fetch_add(1, std::memory_order_relaxed);
-        
-        next_free_block_hint_ = free_block_index + 1;
+// 先复用 bump 之下被释放的块（摘要位图两次 ctz 定位），不够再从 bump 处顺序切块；
+// 两者都耗尽时才取走远程释放栈，再复用一轮。各段都按 64 位字整字领取。
+size_t MemSubPool::allocateOwned(void** out, size_t max_count) {
+    char* data_start = reinterpret_cast<char*>(this) + data_offset_;
+    const size_t bump = bump_index_.load(std::memory_order_relaxed);
+    size_t taken = takeFreedBlocks(out, max_count, bump);
+
+    size_t next = bump;
+    while (taken < max_count && next < total_block_count_) {
+        const size_t word = next / 64;
+        const size_t bit  = next % 64;
+        if (bit == 0) {
+            // 第一次进入这个字：此前没有块交出去，不会有并发的释放请求
+            free_requested_[word].store(0, std::memory_order_relaxed);
+        }
+
+        size_t n = 64 - bit;
+        if (n > total_block_count_ - next) n = total_block_count_ - next;
+        if (n > max_count - taken)         n = max_count - taken;
+
+        const uint64_t mask = (n == 64) ? ~0ull : ((1ull << n) - 1) << bit;
+        bitmap_.setMask(word, mask);
+
+        for (size_t k = 0; k < n; ++k) {
+            out[taken++] = data_start + (next + k) * block_size_;
+        }
+        next += n;
+    }
+    bump_index_.store(next, std::memory_order_release);
 
-        char* data_start = reinterpret_cast<char*>(this) + data_offset_;
-        void* block_ptr = data_start + (free_block_index * block_size_);
+    if (taken < max_count && hasRemoteFrees()) {
+        // 本地空闲块已用尽：其他线程释放的块一次取回
+        drainRemoteFrees();
+        taken += takeFreedBlocks(out + taken, max_count - taken, next);
+    }
 
-        return block_ptr;
+    used_block_count_.fetch_add(taken, std::memory_order_relaxed);
+    return taken;
+}
+
+
+size_t MemSubPool::takeFreedBlocks(void** out, size_t max_count, size_t bump) {
+    char* data_start = reinterpret_cast<char*>(this) + data_offset_;
+    size_t taken = 0;
+
+    while (taken < max_count) {
+        const size_t word = summary_.findFirstWithFree();
+        if (word == SummaryBitmap::k_not_found) {
+            break;
+        }
+
+        const uint64_t valid = belowBumpMask(word, bump);
+        uint64_t grab = ~bitmap_.loadWord(word) & valid;
+        const size_t need = max_count - taken;
+        if (static_cast<size_t>(__builtin_popcountll(grab)) > need) {
+            // 只取最低的 need 个空闲位
+            uint64_t keep = 0;
+            for (size_t k = 0; k < need; ++k) {
+                keep |= grab & (~grab + 1);
+                grab &= grab - 1;
+            }
+            grab = keep;
+        }
+
+        bitmap_.setMask(word, grab);
+        if ((~bitmap_.loadWord(word) & valid) == 0) {
+            summary_.markFull(word);
+        }
+
+        while (grab != 0) {
+            const size_t index = word * 64 + static_cast<size_t>(__builtin_ctzll(grab));
+            out[taken++] = data_start + index * block_size_;
+            grab &= grab - 1;
+        }
     }
+    return taken;
+}
 
-    return nullptr;
+
+void MemSubPool::resetIfEmpty() {
+    if (used_block_count_.load(std::memory_order_relaxed) != 0) {
+        return;
+    }
+    // 所有块都已释放：bump 之下的位全为 0、没有待处理的释放请求，可以重新顺序切块
+    bump_index_.store(0, std::memory_order_release);
+    summary_.reset();
 }
 
 
@@ -88,8 +190,34 @@ void MemSubPool::release(void* block_ptr) {
         return;
     }
 
-    std::lock_guard<std::mutex> guard(lock_);
+    if (!isOwnedByCurrentThread()) {
+        requestFree(block_ptr);
+        return;
+    }
+    releaseOwned(block_ptr);
+}
 
+
+void MemSubPool::releaseBatch(void* const* blocks, size_t count) {
+    if (blocks == nullptr || count == 0) {
+        return;
+    }
+
+    const bool owned = isOwnedByCurrentThread();
+    for (size_t i = 0; i < count; ++i) {
+        if (blocks[i] == nullptr) {
+            continue;
+        }
+        if (owned) {
+            releaseOwned(blocks[i]);
+        } else {
+            requestFree(blocks[i]);
+        }
+    }
+}
+
+
+void MemSubPool::releaseOwned(void* block_ptr) {
     char* data_start = reinterpret_cast<char*>(this) + data_offset_;
     char* data_end = reinterpret_cast<char*>(this) + kPoolTotalSize;
     char* p = static_cast<char*>(block_ptr);
@@ -111,14 +239,204 @@ void MemSubPool::release(void* block_ptr) {
     const size_t block_index = offset / block_size_;
     
     // 检查位图中对应的位是否已经是“空闲”，如果是，则为重复释放错误。
+    if (block_index >= bump_index_.load(std::memory_order_relaxed)) {
+        fprintf(stderr, "Error: Attempted to release block index %zu that was never allocated.\n", block_index);
+        return;
+    }
+
     if (!bitmap_.isUsed(block_index)) {
         fprintf(stderr, "Error: Double-free detected on block index %zu.\n", block_index);
         return;
     }
 
     bitmap_.markAsFree(block_index);
+    summary_.markHasFree(block_index / 64);
     used_block_count_.fetch_sub(1, std::memory_order_relaxed);
+    resetIfEmpty();
+
+}
+
+
+// --- 带外释放请求 ---
+// 释放方与清扫方对 free_requested_、remote_head_ 和 managed_node.state 的访问都用 seq_cst：
+// 释放方“先置位（必要时压栈）、再读节点状态”，清扫方“先把节点置回 Used、再摘栈”，
+// 两边至少有一方能看到对方的写入，请求不会在两次清扫之间丢失。
+
+size_t MemSubPool::indexOf(const void* block_ptr) const {
+    const char* data_start = reinterpret_cast<const char*>(this) + data_offset_;
+    const char* p = static_cast<const char*>(block_ptr);
 
+    if (p < data_start || p >= data_start + total_block_count_ * block_size_) {
+        return SIZE_MAX;
+    }
+    const size_t offset = static_cast<size_t>(p - data_start);
+    if (offset % block_size_ != 0) {
+        return SIZE_MAX;
+    }
+    const size_t block_index = offset / block_size_;
+    if (block_index >= bump_index_.load(std::memory_order_acquire)) {
+        return SIZE_MAX;
+    }
+    return block_index;
+}
+
+
+bool MemSubPool::requestFree(const void* block_ptr) {
+    const size_t block_index = indexOf(block_ptr);
+    if (block_index == SIZE_MAX) {
+        fprintf(stderr, "Error: Free requested for a pointer that is not a block of this sub-pool.\n");
+        return false;
+    }
+
+    const uint64_t bit = 1ull << (block_index % 64);
+    const uint64_t prev = free_requested_[block_index / 64].fetch_or(bit);
+    if (prev & bit) {
+        fprintf(stderr, "Error: Double-free detected on block index %zu.\n", block_index);
+        return false;
+    }
+    if (prev == 0) {
+        pushRemoteWord(block_index / 64);
+    }
+
+    // 节点已是 Free 时不再写：避免多个释放线程反复写同一缓存行
+    const auto free_state = static_cast<uint64_t>(BlockState::Free);
+    if (managed_node.state.load() != free_state) {
+        managed_node.state.store(free_state);
+    }
+    return true;
+}
+
+
+size_t MemSubPool::requestFreeBatch(void* const* blocks, size_t count) {
+    size_t requested = 0;
+    size_t i = 0;
+
+    while (i < count) {
+        const size_t first = indexOf(blocks[i]);
+        if (first == SIZE_MAX) {
+            fprintf(stderr, "Error: Free requested for a pointer that is not a block of this sub-pool.\n");
+            ++i;
+            continue;
+        }
+
+        // 收集同一个字上的连续请求
+        const size_t word = first / 64;
+        uint64_t bits = 1ull << (first % 64);
+        size_t j = i + 1;
+        for (; j < count; ++j) {
+            const size_t index = indexOf(blocks[j]);
+            if (index == SIZE_MAX || index / 64 != word) break;
+            bits |= 1ull << (index % 64);
+        }
+
+        const uint64_t prev = free_requested_[word].fetch_or(bits);
+        if (prev & bits) {
+            fprintf(stderr, "Error: Double-free detected in word %zu.\n", word);
+        }
+        if (prev == 0) {
+            pushRemoteWord(word);
+        }
+        requested += static_cast<size_t>(__builtin_popcountll(bits & ~prev));
+        i = j;
+    }
+
+    if (requested != 0) {
+        const auto free_state = static_cast<uint64_t>(BlockState::Free);
+        if (managed_node.state.load() != free_state) {
+            managed_node.state.store(free_state);
+        }
+    }
+    return requested;
+}
+
+
+bool MemSubPool::isFreeRequested(const void* block_ptr) const {
+    const size_t block_index = indexOf(block_ptr);
+    if (block_index == SIZE_MAX) {
+        return false;
+    }
+    return (free_requested_[block_index / 64].load() & (1ull << (block_index % 64))) != 0;
+}
+
+
+void MemSubPool::pushRemoteWord(size_t word) {
+    uint32_t head = remote_head_.load(std::memory_order_relaxed);
+    do {
+        remote_next_[word].store(static_cast<uint16_t>(head), std::memory_order_relaxed);
+    } while (!remote_head_.compare_exchange_weak(head, static_cast<uint32_t>(word + 1)));
+
+    // 成功时 head 是压栈前的值：栈由空变为非空才通知，之后的压栈不再触碰通知位
+    if (head == 0) {
+        notifyRemoteFrees();
+    }
+}
+
+
+void MemSubPool::notifyRemoteFrees() {
+    // 与 managed_node.state 的写入一样发生在字入栈之后；所属线程登记通知后会再查一次 remote_head_，
+    // 因此两边至少有一方看到对方，不会漏报
+    std::atomic<uint64_t>* word = remote_notice_word_.load();
+    if (word != nullptr) {
+        word->fetch_or(remote_notice_bit_.load(std::memory_order_relaxed));
+    }
+}
+
+
+void MemSubPool::setRemoteNotice(std::atomic<uint64_t>* word, uint64_t bit) {
+    if (word == nullptr) {
+        remote_notice_word_.store(nullptr);
+        remote_notice_bit_.store(0, std::memory_order_relaxed);
+        return;
+    }
+    remote_notice_bit_.store(bit, std::memory_order_relaxed);
+    remote_notice_word_.store(word);
+}
+
+
+size_t MemSubPool::sweepFreeRequested() {
+    if (!isOwnedByCurrentThread()) {
+        return 0;
+    }
+
+    // 先确认：此后到达的请求会把节点重新置为 Free，留给下一轮清扫
+    managed_node.state.store(static_cast<uint64_t>(BlockState::Used));
+
+    const size_t freed = drainRemoteFrees();
+    resetIfEmpty();
+    return freed;
+}
+
+
+size_t MemSubPool::drainRemoteFrees() {
+    // 只有消费者会摘栈，且一次取走整栈：压栈方不会遇到 ABA
+    uint32_t node = remote_head_.exchange(0);
+
+    size_t freed = 0;
+    while (node != 0) {
+        const size_t w = node - 1;
+        // 先读链接再清零该字：清零之后它可能立刻被重新压栈并改写 remote_next_[w]
+        node = remote_next_[w].load(std::memory_order_relaxed);
+
+        const uint64_t bits = free_requested_[w].exchange(0);
+        const size_t cleared = bitmap_.clearMask(w, bits);
+        if (cleared != static_cast<size_t>(__builtin_popcountll(bits))) {
+            fprintf(stderr, "Error: Free requested for blocks that are not in use (word %zu).\n", w);
+        }
+        if (cleared != 0) {
+            summary_.markHasFree(w);
+        }
+        freed += cleared;
+    }
+
+    used_block_count_.fetch_sub(freed, std::memory_order_relaxed);
+    return freed;
+}
+
+
+void MemSubPool::adoptByCurrentThread() {
+    // release/acquire 配对：新所属线程能看到原所属线程对位图等非原子状态的全部写入
+    owner_.store(std::this_thread::get_id(), std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_acquire);
 }
 
 
@@ -134,4 +452,26 @@ bool MemSubPool::isEmpty() const {
 
 size_t MemSubPool::getBlockSize() const {
     return block_size_;
+}
+
+
+void* MemSubPool::blockOf(const void* ptr) const {
+    const char* data_start = reinterpret_cast<const char*>(this) + data_offset_;
+    const char* data_end = data_start + total_block_count_ * block_size_;
+    const char* p = static_cast<const char*>(ptr);
+
+    if (p < data_start || p >= data_end) {
+        return nullptr;
+    }
+
+    const size_t block_index = static_cast<size_t>(p - data_start) / block_size_;
+    return const_cast<char*>(data_start + block_index * block_size_);
+}
+
+
+bool MemSubPool::isPoolHeader(const void* base) {
+    if (base == nullptr) {
+        return false;
+    }
+    return static_cast<const MemSubPool*>(base)->magic_ == kPoolMagic;
 }
\ No newline at end of file
@@ -0,0 +1,290 @@
+// SegmentedManagedList.cpp
+#include "gc_malloc/ThreadHeap/SegmentedManagedList.hpp"
+
+#include <new>
+
+static_assert(SegmentedManagedList::kSegmentBytes >= 512,
+              "a segment must hold a useful number of entries");
+
+SegmentedManagedList::SegmentedManagedList(SegmentAllocCallback alloc_cb,
+                                           SegmentFreeCallback free_cb,
+                                           void* ctx) noexcept
+    : alloc_cb_(alloc_cb),
+      free_cb_(free_cb),
+      ctx_(ctx) {}
+
+SegmentedManagedList::~SegmentedManagedList() {
+    Segment* seg = head_;
+    while (seg) {
+        Segment* next = seg->next;
+        if (free_cb_) free_cb_(ctx_, seg);
+        seg = next;
+    }
+}
+
+void SegmentedManagedList::drain(VisitCallback cb, void* ctx) noexcept {
+    abandonPass();   // 先恢复紧凑：进行中的一轮在读写游标之间留有作废的条目
+
+    Segment* seg = head_;
+    head_ = tail_ = nullptr;
+    size_ = 0;
+    segment_count_ = 0;
+    while (seg) {
+        Segment* next = seg->next;
+        for (std::size_t i = 0; i < seg->count; ++i) cb(ctx, seg->entries[i]);
+        if (free_cb_) free_cb_(ctx_, seg);
+        seg = next;
+    }
+}
+
+// ===================== 追加 =====================
+
+bool SegmentedManagedList::appendUsed(BlockHeader* blk) noexcept {
+    if (!blk) return false;
+    blk->storeUsed();
+    return append(blk);
+}
+
+bool SegmentedManagedList::append(BlockHeader* blk) noexcept {
+    if (!blk) return false;
+
+    if (!tail_ || tail_->count == kSegmentEntries) {
+        Segment* seg = newSegment();
+        if (!seg) return false;
+        if (tail_) {
+            tail_->next = seg;
+        } else {
+            head_ = seg;
+        }
+        tail_ = seg;
+    }
+
+    tail_->entries[tail_->count++] = blk;
+    ++size_;
+    return true;
+}
+
+SegmentedManagedList::Segment* SegmentedManagedList::newSegment() noexcept {
+    void* raw = alloc_cb_ ? alloc_cb_(ctx_) : nullptr;
+    if (!raw) return nullptr;
+
+    auto* seg = static_cast<Segment*>(raw);
+    seg->next  = nullptr;
+    seg->count = 0;
+    seg->freed = 0;
+    ++segment_count_;
+    return seg;
+}
+
+// ===================== 增量清扫 =====================
+
+void SegmentedManagedList::beginPass() noexcept {
+    in_pass_      = true;
+    pass_visited_ = 0;
+    pass_size_    = size_;
+
+    read_seg_   = head_;
+    read_idx_   = 0;
+    write_seg_  = head_;
+    write_prev_ = nullptr;
+    write_idx_  = 0;
+    end_seg_    = tail_;
+    end_idx_    = tail_ ? tail_->count : 0;
+}
+
+void SegmentedManagedList::keep(BlockHeader* blk) noexcept {
+    // 惰性换段：写位置落后于读位置，写满一段时后面必然还有段
+    if (write_idx_ == kSegmentEntries) {
+        write_prev_ = write_seg_;
+        write_seg_  = write_seg_->next;
+        write_idx_  = 0;
+    }
+    write_seg_->entries[write_idx_++] = blk;
+}
+
+void SegmentedManagedList::finishPass() noexcept {
+    in_pass_ = false;
+    ++epoch_;
+    keepUnread();   // 本轮开始后追加的条目
+    trimAfterWrite();
+}
+
+void SegmentedManagedList::trimAfterWrite() noexcept {
+    // 写位置之前的段都是满的；写段收尾，其后的段全部释放
+    Segment* first_unused = nullptr;
+    if (write_idx_ == 0) {
+        first_unused = write_seg_;
+        tail_ = write_prev_;
+        if (tail_) {
+            tail_->next = nullptr;
+        } else {
+            head_ = nullptr;
+        }
+    } else {
+        write_seg_->count = write_idx_;
+        first_unused = write_seg_->next;
+        write_seg_->next = nullptr;
+        tail_ = write_seg_;
+    }
+
+    while (first_unused) {
+        Segment* next = first_unused->next;
+        --segment_count_;
+        if (free_cb_) free_cb_(ctx_, first_unused);
+        first_unused = next;
+    }
+
+    read_seg_ = write_seg_ = write_prev_ = nullptr;
+    read_idx_ = write_idx_ = 0;
+}
+
+BlockHeader* SegmentedManagedList::sweepNextFree(std::size_t max_visit, std::size_t* visited) noexcept {
+    if (!in_pass_) {
+        // 回绕：从头开始新一轮
+        beginPass();
+    }
+
+    std::size_t n = 0;
+    while (n < max_visit) {
+        Segment* seg = read_seg_;
+        if (!seg) {
+            // 本轮开始时表为空：其间追加的条目留给下一轮，不做压实
+            in_pass_ = false;
+            ++epoch_;
+            break;
+        }
+
+        // 只走到本轮开始时的末尾：重新挂回的子池若在本轮再被访问，
+        // 持续的远端释放会让它反复移出、挂回，整轮永远走不完
+        if (read_idx_ == seg->count || (seg == end_seg_ && read_idx_ == end_idx_)) {
+            if (seg == tail_ || seg == end_seg_) {
+                finishPass();
+                break;
+            }
+            read_seg_ = seg->next;
+            read_idx_ = 0;
+            continue;
+        }
+
+        // 条目数组是顺序读，硬件预取足够；节点散布在各处，提前 kPrefetchDistance 个条目预取其状态字
+        if (read_idx_ + kPrefetchDistance < seg->count) {
+            __builtin_prefetch(&seg->entries[read_idx_ + kPrefetchDistance]->state, 0, 1);
+        }
+
+        BlockHeader* blk = seg->entries[read_idx_++];
+        ++n;
+        ++pass_visited_;
+
+        if (blk->loadState() == BlockState::Free) {
+            --size_;
+            if (visited) *visited += n;
+            return blk;
+        }
+        keep(blk);
+    }
+
+    if (visited) *visited += n;
+    return nullptr;
+}
+
+// ===================== 并行清扫 =====================
+
+void SegmentedManagedList::abandonPass() noexcept {
+    if (in_pass_) {
+        if (read_seg_) {
+            // 放弃进行中的一轮：未访问的条目原样搬到写游标处
+            keepUnread();
+            trimAfterWrite();
+        }
+        in_pass_ = false;
+    }
+}
+
+void SegmentedManagedList::keepUnread() noexcept {
+    for (;;) {
+        if (read_idx_ == read_seg_->count) {
+            if (read_seg_ == tail_) break;
+            read_seg_ = read_seg_->next;
+            read_idx_ = 0;
+            continue;
+        }
+        keep(read_seg_->entries[read_idx_++]);
+    }
+}
+
+void SegmentedManagedList::beginParallelScan() noexcept {
+    abandonPass();
+
+    pass_visited_ = 0;
+    pass_size_    = size_;
+    scan_next_.store(head_, std::memory_order_release);
+}
+
+std::size_t SegmentedManagedList::scanShared() noexcept {
+    std::size_t visited = 0;
+    Segment* seg = scan_next_.load(std::memory_order_acquire);
+    while (seg) {
+        // 段链在判定期间不变：领取即把共享游标推进到下一段
+        if (!scan_next_.compare_exchange_weak(seg, seg->next,
+                                              std::memory_order_acq_rel, std::memory_order_acquire)) {
+            continue;
+        }
+        visited += partitionSegment(seg);
+        seg = scan_next_.load(std::memory_order_acquire);
+    }
+    return visited;
+}
+
+std::size_t SegmentedManagedList::partitionSegment(Segment* seg) noexcept {
+    BlockHeader* freed[kSegmentEntries];
+    std::size_t live = 0;
+    std::size_t dead = 0;
+
+    const std::size_t count = seg->count;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i + kPrefetchDistance < count) {
+            __builtin_prefetch(&seg->entries[i + kPrefetchDistance]->state, 0, 1);
+        }
+        BlockHeader* blk = seg->entries[i];
+        if (blk->loadState() == BlockState::Free) {
+            freed[dead++] = blk;
+        } else {
+            seg->entries[live++] = blk;
+        }
+    }
+    for (std::size_t i = 0; i < dead; ++i) {
+        seg->entries[live + i] = freed[i];
+    }
+    seg->freed = dead;
+    return count;
+}
+
+std::size_t SegmentedManagedList::finishParallelScan(ReclaimCallback cb, void* ctx) noexcept {
+    write_seg_  = head_;
+    write_prev_ = nullptr;
+    write_idx_  = 0;
+
+    // 写位置始终不超过读位置：keep() 只会覆盖已经读过的条目
+    std::size_t removed = 0;
+    for (Segment* seg = head_; seg; seg = seg->next) {
+        const std::size_t live = seg->count - seg->freed;
+        for (std::size_t i = 0; i < live; ++i) {
+            keep(seg->entries[i]);
+        }
+        for (std::size_t i = live; i < seg->count; ++i) {
+            BlockHeader* blk = seg->entries[i];
+            if (cb(ctx, blk)) {
+                keep(blk);
+            } else {
+                ++removed;
+            }
+        }
+        seg->freed = 0;
+    }
+
+    size_ -= removed;
+    pass_visited_ = pass_size_;
+    ++epoch_;
+    trimAfterWrite();
+    return removed;
+}
@@ -63,6 +63,25 @@ static_assert((kClassSizeTable[kLocalClassCount - 1] % SizeClassConfig::kAlignme
 static_assert(kClassSizeTable[kLocalClassCount - 1] == SizeClassConfig::kMaxSmallAlloc,
               "Last class should be 1 MiB to match kMaxSmallAlloc.");
 
+// 小尺寸直接查表：按 16B 粒度把 [0, kLookupMax] 映射到 size-class，省去二分查找
+constexpr std::size_t kLookupMax = 1024;
+
+struct SmallClassLookup {
+    std::uint8_t idx[kLookupMax / SizeClassConfig::kAlignment + 1];
+};
+
+constexpr SmallClassLookup BuildSmallClassLookup() {
+    SmallClassLookup t{};
+    std::size_t c = 0;
+    for (std::size_t i = 0; i <= kLookupMax / SizeClassConfig::kAlignment; ++i) {
+        while (kClassSizeTable[c] < i * SizeClassConfig::kAlignment) ++c;
+        t.idx[i] = static_cast<std::uint8_t>(c);
+    }
+    return t;
+}
+
+constexpr SmallClassLookup kSmallClassLookup = BuildSmallClassLookup();
+
 } // namespace
 
 // ---- 接口实现 ----
@@ -79,6 +98,11 @@ std::size_t SizeClassConfig::SizeToClass(std::size_t nbytes) noexcept {
     // 低于最小值按最小值处理
     if (nbytes <= kMinAlloc) return 0;
 
+    // 常见的小尺寸：一次查表（表项 <= 1024 的 class 都是 16B 的倍数，向上取整不会跨 class）
+    if (nbytes <= kLookupMax) {
+        return kSmallClassLookup.idx[(nbytes + SizeClassConfig::kAlignment - 1) / SizeClassConfig::kAlignment];
+    }
+
     // 超过小对象上限则映射到最后一个 size-class（上层通常会走大对象路径）
     if (nbytes > kMaxSmallAlloc) return kLocalClassCount - 1;
 
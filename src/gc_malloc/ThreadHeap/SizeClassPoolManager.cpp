@@ -15,7 +15,12 @@ SizeClassPoolManager::SizeClassPoolManager(std::size_t block_size) noexcept
 {}
 
 SizeClassPoolManager::~SizeClassPoolManager()
-{}
+{
+    // 仍在 full_ 中的子池不再向本对象发通知
+    for (MemSubPool* pool = full_.front(); pool != nullptr; pool = pool->list_next) {
+        pool->setRemoteNotice(nullptr, 0);
+    }
+}
 
 // ===================== 回调设置 =====================
 
@@ -34,11 +39,6 @@ void SizeClassPoolManager::setReturnCallback(ReturnCallback cb, void* ctx) noexc
 // ===================== 分配 / 释放 =====================
 
 void* SizeClassPoolManager::allocateBlock() noexcept {
-    // 若 partial 与 empty 都空，先尝试按水位补齐空闲
-    if (partial_.empty() && empty_.empty()) {
-        refillEmptyPools();
-    }
-
     // 选取可用子池（会从对应链表 pop 出来）
     MemSubPool* pool = acquireUsablePool();
     if (!pool) return nullptr;
@@ -49,7 +49,7 @@ void* SizeClassPoolManager::allocateBlock() noexcept {
         if (pool->isEmpty())       
             empty_.pusFront(pool);
         else if (pool->isFull())   
-            full_.pusFront(pool);
+            pushFull(pool);
         else                       
             partial_.pusFront(pool);
         return nullptr;
@@ -57,13 +57,36 @@ void* SizeClassPoolManager::allocateBlock() noexcept {
 
     // 分配后迁移：满 -> full；否则 -> partial
     if (pool->isFull()) 
-        full_.pusFront(pool);
+        pushFull(pool);
     else                
         partial_.pusFront(pool);
 
     return block;
 }
 
+std::size_t SizeClassPoolManager::allocateBlocks(void** out, std::size_t count) noexcept {
+    if (!out || count == 0) return 0;
+
+    std::size_t got = 0;
+    while (got < count) {
+        MemSubPool* pool = acquireUsablePool();
+        if (!pool) break;
+
+        const std::size_t n = pool->allocateBatch(out + got, count - got);
+        got += n;
+
+        if (pool->isEmpty())
+            empty_.pusFront(pool);
+        else if (pool->isFull())
+            pushFull(pool);
+        else
+            partial_.pusFront(pool);
+
+        if (n == 0) break;   // 理论上不应发生：取出的子池必有空闲块
+    }
+    return got;
+}
+
 bool SizeClassPoolManager::releaseBlock(void* ptr) noexcept {
     if (!ptr) return true;
 
@@ -79,28 +102,102 @@ bool SizeClassPoolManager::releaseBlock(void* ptr) noexcept {
     // 执行释放
     pool->release(ptr);
 
-    // 从旧链摘除并插入新链（按照释放后的状态）
-    if (was_full) {
-        // 必然在 full_ 链
-        MemSubPool* removed = full_.remove(pool);
-        (void)removed; // 仅用于调试期校验
-        assert(removed == pool);
-    } else {
-        // 必然在 partial_ 链（empty_ 不可能持有在用块）
-        MemSubPool* removed = partial_.remove(pool);
-        (void)removed;
-        assert(removed == pool);
+    relinkAfterRelease(pool, was_full);
+    return true;
+}
+
+bool SizeClassPoolManager::releaseBlocks(MemSubPool* pool, void* const* blocks, std::size_t count) noexcept {
+    if (!pool || pool->getBlockSize() != block_size_) {
+        return false;
+    }
+    if (count == 0) return true;
+
+    const bool was_full = pool->isFull();
+    pool->releaseBatch(blocks, count);
+    relinkAfterRelease(pool, was_full);
+    return true;
+}
+
+std::size_t SizeClassPoolManager::reclaimFreeRequested(MemSubPool* pool, bool* pool_emptied) noexcept {
+    if (pool_emptied) *pool_emptied = false;
+    if (!pool || pool->getBlockSize() != block_size_) {
+        return 0;
     }
 
+    const bool was_full = pool->isFull();
+    const std::size_t reclaimed = pool->sweepFreeRequested();
+    if (reclaimed == 0) return 0;
+
+    // 迁移前记下是否已空：relinkAfterRelease 可能把空子池交还 CentralHeap
+    const bool emptied = pool->isEmpty();
+    relinkAfterRelease(pool, was_full);
+    if (pool_emptied) *pool_emptied = emptied;
+    return reclaimed;
+}
+
+// ===================== 线程退出 / 认领 =====================
+
+void SizeClassPoolManager::abandonPools(ReturnCallback orphan_cb, void* ctx) noexcept {
+    while (MemSubPool* p = empty_.popFront()) {
+        if (return_cb_) return_cb_(return_ctx_, p);
+    }
+    noteEmptyLow();
+    while (MemSubPool* p = partial_.popFront()) {
+        orphan_cb(ctx, p);
+    }
+    while (MemSubPool* p = full_.front()) {
+        removeFull(p);
+        orphan_cb(ctx, p);
+    }
+}
+
+std::size_t SizeClassPoolManager::adoptPool(MemSubPool* pool, bool* pool_emptied) noexcept {
+    if (pool_emptied) *pool_emptied = false;
+    if (!pool || pool->getBlockSize() != block_size_) {
+        return 0;
+    }
+    assert(pool->list_prev == nullptr && pool->list_next == nullptr);
+
+    pool->adoptByCurrentThread();
+    const std::size_t reclaimed = pool->sweepFreeRequested();
+
     if (pool->isEmpty()) {
+        if (pool_emptied) *pool_emptied = true;
         empty_.pusFront(pool);
-        // 空闲增加后，若超高水位则回落至目标水位
         trimEmptyPools();
+    } else if (pool->isFull()) {
+        pushFull(pool);
     } else {
         partial_.pusFront(pool);
     }
+    return reclaimed;
+}
 
-    return true;
+void SizeClassPoolManager::adoptAllByCurrentThread() noexcept {
+    MemSubPoolList* const lists[] = {&empty_, &partial_, &full_};
+    for (MemSubPoolList* list : lists) {
+        for (MemSubPool* pool = list->front(); pool != nullptr; pool = pool->list_next) {
+            pool->adoptByCurrentThread();
+        }
+    }
+}
+
+// ===================== 空子池衰减 =====================
+
+std::size_t SizeClassPoolManager::releaseIdleEmptyPools() noexcept {
+    std::size_t released = 0;
+    if (return_cb_) {
+        // 与 CentralHeap 热缓存的衰减相同：空子池之间可以互换，数量对了即可
+        const std::size_t idle = empty_low_water_ < empty_.size() ? empty_low_water_ : empty_.size();
+        while (released < idle) {
+            MemSubPool* p = empty_.popFront();
+            if (!p) break;
+            return_cb_(return_ctx_, p);
+            ++released;
+        }
+    }
+    empty_low_water_ = empty_.size();
+    return released;
 }
 
 // ===================== 统计 / 查询 =====================
@@ -130,6 +227,27 @@ bool SizeClassPoolManager::ownsPointer(const void* ptr) const noexcept {
 
 // ===================== 内部辅助 =====================
 
+// 释放后迁移子池：从旧链摘除并插入新链（按照释放后的状态）
+void SizeClassPoolManager::relinkAfterRelease(MemSubPool* pool, bool was_full) noexcept {
+    if (was_full) {
+        // 必然在 full_ 链
+        removeFull(pool);
+    } else {
+        // 必然在 partial_ 链（empty_ 不可能持有在用块）
+        MemSubPool* removed = partial_.remove(pool);
+        (void)removed;
+        assert(removed == pool);
+    }
+
+    if (pool->isEmpty()) {
+        empty_.pusFront(pool);
+        // 空闲增加后，若超高水位则回落至目标水位
+        trimEmptyPools();
+    } else {
+        partial_.pusFront(pool);
+    }
+}
+
 inline bool SizeClassPoolManager::poolIsEmpty(const MemSubPool* p) noexcept {
     return p->isEmpty();
 }
@@ -175,6 +293,12 @@ void SizeClassPoolManager::trimEmptyPools() noexcept {
     }
 }
 
+void SizeClassPoolManager::noteEmptyLow() noexcept {
+    if (empty_.size() < empty_low_water_) {
+        empty_low_water_ = empty_.size();
+    }
+}
+
 // —— 选择可用子池 ——
 
 MemSubPool* SizeClassPoolManager::acquireUsablePool() noexcept {
@@ -182,12 +306,69 @@ MemSubPool* SizeClassPoolManager::acquireUsablePool() noexcept {
         return partial_.popFront();
     }
 
-    if (empty_.empty()) {
-        refillEmptyPools();
+    if (!empty_.empty()) {
+        MemSubPool* pool = empty_.popFront();
+        noteEmptyLow();
+        return pool;
+    }
+
+    // 本地空闲块耗尽：先取回其他线程释放到满子池里的块，再向 CentralHeap 要新子池
+    if (MemSubPool* pool = takeFullPoolWithRemoteFrees()) {
+        return pool;
     }
+
+    refillEmptyPools();
     if (!empty_.empty()) {
-        return empty_.popFront();
+        MemSubPool* pool = empty_.popFront();
+        noteEmptyLow();
+        return pool;
     }
 
     return nullptr;
 }
+
+MemSubPool* SizeClassPoolManager::takeFullPoolWithRemoteFrees() noexcept {
+    // 只看收到通知的槽；通知可能多报，逐个核实
+    uint64_t pending = notice_pending_.exchange(0) & notice_used_;
+    while (pending != 0) {
+        MemSubPool* pool = notice_slots_[__builtin_ctzll(pending)];
+        pending &= pending - 1;
+        if (!pool->hasRemoteFrees()) continue;
+
+        removeFull(pool);
+        // 取走整个远程释放栈；调用方分配后按新状态重新挂链
+        if (pool->sweepFreeRequested() != 0) {
+            notice_pending_.fetch_or(pending);   // 没看完的通知留给下一次
+            return pool;
+        }
+        pushFull(pool);   // 栈里只有已被清扫过的字：仍是满的，继续看下一个
+    }
+    return nullptr;
+}
+
+void SizeClassPoolManager::pushFull(MemSubPool* pool) noexcept {
+    full_.pusFront(pool);
+    if (notice_used_ == ~uint64_t{0}) return;
+
+    const std::size_t slot = static_cast<std::size_t>(__builtin_ctzll(~notice_used_));
+    const uint64_t bit = uint64_t{1} << slot;
+    notice_used_ |= bit;
+    notice_slots_[slot] = pool;
+    pool->setRemoteNotice(&notice_pending_, bit);
+    // 登记之前已经非空的远程释放栈不会再触发通知：在这里补上
+    if (pool->hasRemoteFrees()) {
+        notice_pending_.fetch_or(bit);
+    }
+}
+
+void SizeClassPoolManager::removeFull(MemSubPool* pool) noexcept {
+    MemSubPool* removed = full_.remove(pool);
+    (void)removed; // 仅用于调试期校验
+    assert(removed == pool);
+
+    const uint64_t bit = pool->getRemoteNoticeBit();
+    if (bit == 0) return;
+    pool->setRemoteNotice(nullptr, 0);
+    notice_used_ &= ~bit;
+    notice_slots_[__builtin_ctzll(bit)] = nullptr;
+}
@@ -0,0 +1,41 @@
+// SummaryBitmap.cpp
+#include "gc_malloc/ThreadHeap/SummaryBitmap.hpp"
+
+SummaryBitmap::SummaryBitmap(std::size_t leaf_words) noexcept
+    : leaf_words_(leaf_words < kMaxLeafWords ? leaf_words : kMaxLeafWords),
+      root_(0),
+      level1_{} {}
+
+void SummaryBitmap::reset() noexcept {
+    // 只有 root_ 中置位的 level1_ 字可能非零
+    while (root_ != 0) {
+        level1_[__builtin_ctzll(root_)] = 0;
+        root_ &= root_ - 1;
+    }
+}
+
+void SummaryBitmap::markHasFree(std::size_t leaf_index) noexcept {
+    if (leaf_index >= leaf_words_) return;
+    level1_[leaf_index / 64] |= 1ull << (leaf_index % 64);
+    root_ |= 1ull << (leaf_index / 64);
+}
+
+void SummaryBitmap::markFull(std::size_t leaf_index) noexcept {
+    if (leaf_index >= leaf_words_) return;
+    std::uint64_t& summary = level1_[leaf_index / 64];
+    summary &= ~(1ull << (leaf_index % 64));
+    if (summary == 0) {
+        root_ &= ~(1ull << (leaf_index / 64));
+    }
+}
+
+bool SummaryBitmap::hasFree(std::size_t leaf_index) const noexcept {
+    if (leaf_index >= leaf_words_) return false;
+    return (level1_[leaf_index / 64] >> (leaf_index % 64)) & 1u;
+}
+
+std::size_t SummaryBitmap::findFirstWithFree() const noexcept {
+    if (root_ == 0) return k_not_found;
+    const std::size_t i = static_cast<std::size_t>(__builtin_ctzll(root_));
+    return i * 64 + static_cast<std::size_t>(__builtin_ctzll(level1_[i]));
+}
@@ -0,0 +1,88 @@
+#include "gc_malloc/ThreadHeap/SweepWorkers.hpp"
+
+#include <new>
+#include <type_traits>
+#include <pthread.h>
+
+namespace {
+// 与 CentralHeap 相同：实例放在静态缓冲区里，不注册析构（退出时工作线程仍阻塞在条件变量上）
+std::aligned_storage_t<sizeof(SweepWorkers), alignof(SweepWorkers)> g_sweep_workers_buffer;
+}
+
+SweepWorkers& SweepWorkers::GetInstance() noexcept {
+    static SweepWorkers* const instance = new (&g_sweep_workers_buffer) SweepWorkers();
+    return *instance;
+}
+
+std::size_t SweepWorkers::prepare(std::size_t helpers) noexcept {
+    if (helpers > kMaxHelpers) helpers = kMaxHelpers;
+
+    std::lock_guard<std::mutex> guard(run_mutex_);
+    while (started_ < helpers) {
+        pthread_attr_t attr;
+        if (pthread_attr_init(&attr) != 0) break;
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+        pthread_t tid;
+        const int rc = pthread_create(&tid, &attr, &SweepWorkers::workerMain, this);
+        pthread_attr_destroy(&attr);
+        if (rc != 0) break;
+        ++started_;
+    }
+    return started_ < helpers ? started_ : helpers;
+}
+
+std::size_t SweepWorkers::run(std::size_t helpers, Task task, void* ctx) noexcept {
+    std::unique_lock<std::mutex> run_guard(run_mutex_, std::try_to_lock);
+    if (!run_guard.owns_lock()) {
+        helpers = 0;   // 工作线程正被其他调用方占用：不等待
+    } else if (helpers > started_) {
+        helpers = started_;
+    }
+
+    if (helpers != 0) {
+        {
+            std::lock_guard<std::mutex> lk(mutex_);
+            task_  = task;
+            ctx_   = ctx;
+            slots_ = helpers;
+            ++generation_;
+        }
+        wake_cv_.notify_all();
+    }
+
+    task(ctx);
+
+    std::size_t joined = 0;
+    if (helpers != 0) {
+        std::unique_lock<std::mutex> lk(mutex_);
+        joined = helpers - slots_;
+        slots_ = 0;   // 还没醒来的工作线程不再加入
+        done_cv_.wait(lk, [this] { return running_ == 0; });
+    }
+    return joined;
+}
+
+void* SweepWorkers::workerMain(void* self) noexcept {
+    auto* pool = static_cast<SweepWorkers*>(self);
+    std::uint64_t seen = 0;
+
+    std::unique_lock<std::mutex> lk(pool->mutex_);
+    for (;;) {
+        pool->wake_cv_.wait(lk, [&] { return pool->generation_ != seen; });
+        seen = pool->generation_;
+        if (pool->slots_ == 0) continue;
+
+        --pool->slots_;
+        ++pool->running_;
+        Task task = pool->task_;
+        void* ctx = pool->ctx_;
+
+        lk.unlock();
+        task(ctx);
+        lk.lock();
+
+        if (--pool->running_ == 0) pool->done_cv_.notify_all();
+    }
+    return nullptr;
+}
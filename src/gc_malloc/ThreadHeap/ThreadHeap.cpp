@@ -1,47 +1,462 @@
 #include <new>
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <limits>
 #include <cassert>
+#include <mutex>
+#include <atomic>
+#include <pthread.h>
+#include <unistd.h>
 
 #include "gc_malloc/CentralHeap/CentralHeap.hpp"
+#include "gc_malloc/CentralHeap/PageRunAllocator.hpp"
+#include "gc_malloc/CentralHeap/PageMap.hpp"
 #include "gc_malloc/ThreadHeap/MemSubPool.hpp"
+#include "gc_malloc/ThreadHeap/DeadlineClock.hpp"
+#include "gc_malloc/ThreadHeap/LargeObject.hpp"
+#include "gc_malloc/ThreadHeap/SweepWorkers.hpp"
 #include "gc_malloc/ThreadHeap/ThreadHeap.hpp"
 
+static_assert(SegmentedManagedList::kSegmentBytes == PageRunAllocator::kPageSize,
+              "ManagedList segments are single page runs");
+static_assert(SizeClassConfig::kPageSize == PageRunAllocator::kPageSize,
+              "SizeClassConfig and PageRunAllocator must agree on the page size");
+static_assert(SizeClassConfig::kMaxMediumAlloc == PageRunAllocator::kMaxRunPages * PageRunAllocator::kPageSize,
+              "medium allocations must fit in a single page run");
+
+// -------------------- 线程本地状态与实例存储 --------------------
+// TLS 中只放一个平凡的指针：非平凡的 thread_local 对象会经由 __cxa_thread_atexit
+// 注册析构，而 glibc 在其中调用 calloc，作为 malloc 替换库时会递归回到这里。
+// initial-exec 模型保证访问 TLS 时不会经过 __tls_get_addr 的惰性分配。
+
+namespace {
+
+__thread ThreadHeap* tls_heap __attribute__((tls_model("initial-exec"))) = nullptr;
+
+pthread_key_t  g_heap_key;
+pthread_once_t g_heap_key_once = PTHREAD_ONCE_INIT;
+
+// ThreadHeap 实例本身从 CentralHeap 的 chunk 中切分，线程退出后槽位挂入空闲链表复用。
+// 全程不经过系统分配器。
+struct RetiredSlot {
+    RetiredSlot* next;
+};
+
+std::mutex   g_slot_mutex;
+RetiredSlot* g_free_slots  = nullptr;
+char*        g_slot_cursor = nullptr;
+char*        g_slot_end    = nullptr;
+
+inline std::size_t alignUp(std::size_t v, std::size_t a) noexcept {
+    return (v + a - 1) & ~(a - 1);
+}
+
+void* acquireSlot(std::size_t slot_size) noexcept {
+    std::lock_guard<std::mutex> guard(g_slot_mutex);
+
+    if (g_free_slots) {
+        RetiredSlot* slot = g_free_slots;
+        g_free_slots = slot->next;
+        return slot;
+    }
+
+    if (g_slot_cursor == nullptr ||
+        static_cast<std::size_t>(g_slot_end - g_slot_cursor) < slot_size) {
+        void* chunk = CentralHeap::GetInstance().acquireChunk(SizeClassConfig::kChunkSizeBytes);
+        if (!chunk) return nullptr;
+        g_slot_cursor = static_cast<char*>(chunk);
+        g_slot_end    = g_slot_cursor + SizeClassConfig::kChunkSizeBytes;
+    }
+
+    void* slot = g_slot_cursor;
+    g_slot_cursor += slot_size;
+    return slot;
+}
+
+void releaseSlot(void* p) noexcept {
+    std::lock_guard<std::mutex> guard(g_slot_mutex);
+    auto* slot = static_cast<RetiredSlot*>(p);
+    slot->next = g_free_slots;
+    g_free_slots = slot;
+}
+
+// 退役实例的空闲表：实例保持构造状态（子池、缓存、跟踪表都还在），同样受 g_slot_mutex 保护
+ThreadHeap*              g_retired_heaps = nullptr;
+std::size_t              g_retired_count = 0;
+std::atomic<std::size_t> g_retired_limit{ThreadHeap::kDefaultRetiredHeapLimit};
+
+// 自动 GC 的触发阈值：所有线程共享，只在慢路径上读取
+std::atomic<std::size_t> g_gc_debt_bytes{ThreadHeap::kDefaultGcDebtBytes};
+std::atomic<std::size_t> g_gc_debt_blocks{ThreadHeap::kDefaultGcDebtBlocks};
+
+inline bool debtReached(std::size_t debt, const std::atomic<std::size_t>& threshold) noexcept {
+    const std::size_t limit = threshold.load(std::memory_order_relaxed);
+    return limit != 0 && debt >= limit;
+}
+
+// 小对象块 -> 所属子池（子池头部位于 2MB 对齐的 chunk 起始处）
+MemSubPool* poolOf(const void* block) noexcept {
+    const auto addr = reinterpret_cast<std::uintptr_t>(block);
+    const auto mask = static_cast<std::uintptr_t>(MemSubPool::kPoolTotalSize) - 1;
+    return reinterpret_cast<MemSubPool*>(addr & ~mask);
+}
+
+// 改写 chunk 的所属 ThreadHeap（线程退出交出 / 认领孤儿时）；表项已存在，不会失败
+void setChunkOwner(const void* base, std::size_t nchunks, ThreadHeap* owner) noexcept {
+    PageMapEntry entry = PageMap::GetInstance().lookup(base);
+    entry.owner = owner;
+    PageMap::GetInstance().set(base, nchunks, entry);
+}
+
+// 线程退出时交出的块，经 BlockHeader::next 串成一条链
+struct OrphanChain {
+    BlockHeader* first = nullptr;
+    BlockHeader* last  = nullptr;
+
+    void push(BlockHeader* node) noexcept {
+        node->next = nullptr;
+        if (last) {
+            last->next = node;
+        } else {
+            first = node;
+        }
+        last = node;
+    }
+};
+
+// 中等对象：页段首部放一个 BlockHeader 作为带外节点，用户数据紧随其后
+constexpr std::size_t kMediumHeaderSize = sizeof(BlockHeader);
+
+inline BlockHeader* mediumHeaderOf(void* blk) noexcept {
+    return reinterpret_cast<BlockHeader*>(static_cast<char*>(blk) - kMediumHeaderSize);
+}
+
+// PageMap 表项 + 块内任意指针 -> 块起始地址（即 allocate 的返回值）；不属于任何在用块时返回 nullptr
+void* blockStartIn(const PageMapEntry& entry, const void* ptr) noexcept {
+    switch (entry.kind) {
+    case ChunkKind::kSmallPool:
+        return static_cast<const MemSubPool*>(entry.base)->blockOf(ptr);
+    case ChunkKind::kMediumRun: {
+        char* run = static_cast<char*>(static_cast<const PageRunChunk*>(entry.base)->runOf(ptr));
+        if (!run) return nullptr;
+        char* blk = run + kMediumHeaderSize;
+        return (ptr >= blk) ? blk : nullptr;
+    }
+    case ChunkKind::kLargeObject: {
+        // 跨多个 chunk 的大对象：每个 chunk 都登记了同一个头部，内部指针同样可解析
+        void* blk = static_cast<LargeObject*>(entry.base)->block();
+        return (ptr >= blk) ? blk : nullptr;
+    }
+    case ChunkKind::kNone:
+        break;
+    }
+    return nullptr;
+}
+
+// 块的总字节数（blk 必须是 blockStartIn 的结果）
+std::size_t blockBytesIn(const PageMapEntry& entry, const void* blk) noexcept {
+    switch (entry.kind) {
+    case ChunkKind::kSmallPool:
+        return static_cast<const MemSubPool*>(entry.base)->getBlockSize();
+    case ChunkKind::kMediumRun:
+        return static_cast<const PageRunChunk*>(entry.base)->runBytes(
+                   static_cast<const char*>(blk) - kMediumHeaderSize) - kMediumHeaderSize;
+    case ChunkKind::kLargeObject:
+        return static_cast<const LargeObject*>(entry.base)->blockSize();
+    case ChunkKind::kNone:
+        break;
+    }
+    return 0;
+}
+
+} // namespace
+
 // -------------------- 对外公共接口 --------------------
 
 void* ThreadHeap::allocate(std::size_t nbytes) noexcept {
-    ThreadHeap& th = local();
+    ThreadHeap* th = local();
+    if (!th) return nullptr;
 
-    // 大对象：直接走 CentralHeap（整块 chunk）
-    if (nbytes > SizeClassConfig::kMaxSmallAlloc) {
-        return CentralHeap::GetInstance().acquireChunk(SizeClassConfig::kChunkSizeBytes);
+    // 大对象：独占一段由 CentralHeap 提供的多 chunk 映射
+    if (nbytes > SizeClassConfig::kMaxMediumAlloc) {
+        th->chargeDebt(nbytes, 0);
+        return th->allocateLarge(nbytes);
     }
 
-    // 小对象：映射到 size-class
-    const std::size_t class_idx = sizeToClass_(nbytes);
-    void* block_ptr = at(th.managers_storage_[class_idx]).allocateBlock();
-    if (!block_ptr) return nullptr;
+    // 中等对象：按 4KB 页取整，从共享 chunk 中切出连续页段
+    if (nbytes > SizeClassConfig::kMaxPooledAlloc) {
+        th->chargeDebt(nbytes, 0);
+        return th->allocateMedium(nbytes);
+    }
 
-    auto* hdr = static_cast<BlockHeader*>(block_ptr);
-    th.attachUsed(hdr);
-    return block_ptr;
+    // 小对象：映射到 size-class，先从线程缓存取，空了再按批补货
+    const std::size_t class_idx = sizeToClass_(nbytes);
+    void* block_ptr = at(th->caches_storage_[class_idx]).pop();
+    if (__builtin_expect(block_ptr != nullptr, 1)) return block_ptr;
+    return th->refillCache(class_idx);
 }
 
+// 跨线程释放只在带外状态上做标记（子池的 free-requested 位图 / 对象头部），不写用户数据
 void ThreadHeap::deallocate(void* ptr) noexcept {
     if (!ptr) return;
-    static_cast<BlockHeader*>(ptr)->storeFree();  // 跨线程释放只改状态
+
+    const PageMapEntry entry = PageMap::GetInstance().lookup(ptr);
+    void* blk = blockStartIn(entry, ptr);
+    if (!blk) return;   // 未登记的外来指针：忽略
+
+    ThreadHeap* th = tls_heap;
+    const bool own = (entry.owner == th && th != nullptr);
+
+    switch (entry.kind) {
+    case ChunkKind::kSmallPool:
+        // 所属线程释放：直接回到线程缓存，不碰子池；其他线程只登记释放请求
+        if (own) {
+            th->cacheFree(entry.size_class, blk);
+        } else {
+            static_cast<MemSubPool*>(entry.base)->requestFree(blk);
+        }
+        break;
+    case ChunkKind::kMediumRun:
+        mediumHeaderOf(blk)->storeFree();
+        break;
+    case ChunkKind::kLargeObject:
+        static_cast<LargeObject*>(entry.base)->managedNode()->storeFree();
+        if (own) ++th->debt_blocks_;   // 只记账，清扫留给下一次分配
+        break;
+    case ChunkKind::kNone:
+        break;
+    }
 }
 
 std::size_t ThreadHeap::garbageCollect(std::size_t max_scan) noexcept {
-    return local().reclaimBatch(max_scan);
+    ThreadHeap* th = local();
+    if (!th) return 0;
+    th->debt_bytes_  = 0;
+    th->debt_blocks_ = 0;
+    const std::size_t reclaimed = th->reclaimBatch(max_scan);
+    th->decayEmptyPools();
+    return reclaimed;
+}
+
+ThreadHeap::GcSlice ThreadHeap::garbageCollectFor(std::chrono::nanoseconds budget,
+                                                  std::size_t max_visit) noexcept {
+    GcSlice slice{0, 0, false};
+    ThreadHeap* th = local();
+    if (!th) return slice;
+
+    const DeadlineClock deadline(budget);
+    const uint64_t epoch = th->managed_list_.epoch();
+    th->debt_bytes_  = 0;
+    th->debt_blocks_ = 0;
+    slice.reclaimed = th->reclaimBatch(max_visit, &deadline, &slice.visited);
+    slice.pass_completed = (th->managed_list_.epoch() != epoch);
+    return slice;
+}
+
+ThreadHeap::SweepProgress ThreadHeap::sweepProgress() noexcept {
+    ThreadHeap* th = local();
+    if (!th) return SweepProgress{0, 0, 0, 0, 0.0};
+
+    const TrackingList& list = th->managed_list_;
+    SweepProgress p{list.epoch(), list.passVisited(), th->pass_reclaimed_, list.size(), 100.0};
+    if (list.passInProgress()) {
+        // 本轮中途尾插的节点会让访问数超过起始节点数：封顶在 100 以下，完成时才报 100
+        const std::size_t total = list.passSize();
+        p.percent = total ? std::min(99.9, 100.0 * static_cast<double>(p.visited) / static_cast<double>(total))
+                          : 0.0;
+    }
+    return p;
+}
+
+std::size_t ThreadHeap::garbageCollectParallel(std::size_t threads) noexcept {
+#ifdef GC_MALLOC_LINKED_MANAGED_LIST
+    (void)threads;
+    return garbageCollect();
+#else
+    ThreadHeap* th = local();
+    if (!th) return 0;
+
+    if (threads == 0) {
+        const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? static_cast<std::size_t>(cpus) : 1;
+    }
+    if (threads <= 1 || th->managed_list_.size() < kParallelSweepMinNodes) {
+        return garbageCollect();
+    }
+
+    // 工作线程须在清扫开始前就绪：创建线程可能经由 malloc 回到本线程的分配路径
+    SweepWorkers& workers = SweepWorkers::GetInstance();
+    const std::size_t helpers = workers.prepare(threads - 1);
+
+    th->debt_bytes_     = 0;
+    th->debt_blocks_    = 0;
+    th->pass_reclaimed_ = 0;
+
+    TrackingList& list = th->managed_list_;
+    list.beginParallelScan();
+    workers.run(helpers, [](void* ctx) noexcept { static_cast<TrackingList*>(ctx)->scanShared(); }, &list);
+    list.finishParallelScan(&ThreadHeap::reclaimNode_cb, th);
+    return th->pass_reclaimed_;
+#endif
+}
+
+void ThreadHeap::setGcDebtThreshold(std::size_t bytes, std::size_t blocks) noexcept {
+    g_gc_debt_bytes.store(bytes, std::memory_order_relaxed);
+    g_gc_debt_blocks.store(blocks, std::memory_order_relaxed);
+}
+
+// 经由 PageMap 定位：两次加载得到 chunk 的用途与头部，未登记的外来指针不会被解引用
+void* ThreadHeap::blockStart(const void* ptr) noexcept {
+    if (!ptr) return nullptr;
+    return blockStartIn(PageMap::GetInstance().lookup(ptr), ptr);
+}
+
+BlockState ThreadHeap::blockState(const void* ptr) noexcept {
+    const PageMapEntry entry = PageMap::GetInstance().lookup(ptr);
+    void* blk = blockStartIn(entry, ptr);
+    if (!blk) return BlockState::Free;
+
+    switch (entry.kind) {
+    case ChunkKind::kSmallPool: {
+        if (static_cast<const MemSubPool*>(entry.base)->isFreeRequested(blk)) return BlockState::Free;
+        // 留在所属线程缓存中的块同样视为已释放
+        ThreadHeap* th = tls_heap;
+        if (entry.owner == th && th != nullptr &&
+            at(th->caches_storage_[entry.size_class]).contains(blk)) {
+            return BlockState::Free;
+        }
+        return BlockState::Used;
+    }
+    case ChunkKind::kMediumRun:
+        return mediumHeaderOf(blk)->loadState();
+    case ChunkKind::kLargeObject:
+        return static_cast<LargeObject*>(entry.base)->managedNode()->loadState();
+    case ChunkKind::kNone:
+        break;
+    }
+    return BlockState::Free;
+}
+
+std::size_t ThreadHeap::usableSize(const void* ptr) noexcept {
+    if (!ptr) return 0;
+    const PageMapEntry entry = PageMap::GetInstance().lookup(ptr);
+    const char* blk = static_cast<const char*>(blockStartIn(entry, ptr));
+    if (!blk) return 0;
+    return blockBytesIn(entry, blk) - static_cast<std::size_t>(static_cast<const char*>(ptr) - blk);
 }
 
 // -------------------- 内部实现（TLS / 构造 / 回调桥） --------------------
 
-ThreadHeap& ThreadHeap::local() noexcept {
-    static thread_local ThreadHeap tls_instance;
-    return tls_instance;
+ThreadHeap* ThreadHeap::local() noexcept {
+    ThreadHeap* th = tls_heap;
+    if (__builtin_expect(th != nullptr, 1)) return th;
+    return createForCurrentThread();
+}
+
+ThreadHeap* ThreadHeap::createForCurrentThread() noexcept {
+    pthread_once(&g_heap_key_once, [] {
+        pthread_key_create(&g_heap_key, &ThreadHeap::destroyAtThreadExit);
+    });
+
+    // 优先接管退役实例：子池与线程缓存都是热的
+    ThreadHeap* th = takeRetired();
+    if (th) {
+        th->adoptByCurrentThread();
+    } else {
+        void* slot = acquireSlot(alignUp(sizeof(ThreadHeap), CACHE_LINE_SIZE));
+        if (!slot) return nullptr;
+        th = new (slot) ThreadHeap();
+    }
+    // 先发布 TLS 指针：pthread_setspecific 在 key 较多时可能 calloc，递归进来时可直接命中
+    tls_heap = th;
+    pthread_setspecific(g_heap_key, th);
+    return th;
+}
+
+void ThreadHeap::destroyAtThreadExit(void* heap) noexcept {
+    auto* th = static_cast<ThreadHeap*>(heap);
+    if (!th) return;
+    // 收尾时仍以本线程身份进行：清扫中的回调可能用到 tls_heap
+    th->prepareForRetirement();
+    // 之后的分配会重新创建（或接管）实例并再次登记，由 pthread 的多轮析构兜底
+    tls_heap = nullptr;
+
+    {
+        // 实例连同子池退役：不交出子池，接管它的新线程不必重新补充
+        std::lock_guard<std::mutex> guard(g_slot_mutex);
+        if (g_retired_count < g_retired_limit.load(std::memory_order_relaxed)) {
+            th->retired_next_ = g_retired_heaps;
+            g_retired_heaps = th;
+            ++g_retired_count;
+            return;
+        }
+    }
+
+    th->~ThreadHeap();
+    releaseSlot(th);
+}
+
+void ThreadHeap::prepareForRetirement() noexcept {
+    // 缓存中的块优先供其他线程直接取用，放不下的登记为所属子池的释放请求
+    for (std::size_t i = 0; i < k_class_count; ++i) {
+        const std::size_t n = at(caches_storage_[i]).count();
+        if (n == 0) continue;
+        flushCache(i, n - spillToTransfer(i, n));
+    }
+    // 已释放的中等 / 大对象与刚交回的块就地回收：游标在中途时走完本轮再从表头走一轮，
+    // 总访问数有界，线程退出的开销不随表长增长
+    const uint64_t stop_epoch = managed_list_.epoch() + (managed_list_.passInProgress() ? 2 : 1);
+    std::size_t visited = 0;
+    while (visited < kRetireScanBudget && managed_list_.epoch() < stop_epoch) {
+        reclaimBatch(kRetireScanBudget - visited, nullptr, &visited);
+    }
+    debt_bytes_  = 0;
+    debt_blocks_ = 0;
+}
+
+ThreadHeap* ThreadHeap::takeRetired() noexcept {
+    std::lock_guard<std::mutex> guard(g_slot_mutex);
+    ThreadHeap* th = g_retired_heaps;
+    if (th) {
+        g_retired_heaps = th->retired_next_;
+        th->retired_next_ = nullptr;
+        --g_retired_count;
+    }
+    return th;
+}
+
+void ThreadHeap::destroyRetired(ThreadHeap* th) noexcept {
+    // 析构会清扫子池：先转为当前线程所有
+    th->adoptByCurrentThread();
+    th->~ThreadHeap();
+    releaseSlot(th);
+}
+
+void ThreadHeap::adoptByCurrentThread() noexcept {
+    // PageMap 记录的所属者是实例地址，接管后无需改写；只有子池按线程 id 校验所有权
+    for (std::size_t i = 0; i < k_class_count; ++i) {
+        at(managers_storage_[i]).adoptAllByCurrentThread();
+    }
+}
+
+void ThreadHeap::setRetiredHeapLimit(std::size_t n) noexcept {
+    g_retired_limit.store(n, std::memory_order_relaxed);
+    for (;;) {
+        ThreadHeap* excess = nullptr;
+        {
+            std::lock_guard<std::mutex> guard(g_slot_mutex);
+            if (g_retired_count > n) {
+                excess = g_retired_heaps;
+                g_retired_heaps = excess->retired_next_;
+                excess->retired_next_ = nullptr;
+                --g_retired_count;
+            }
+        }
+        if (!excess) break;
+        destroyRetired(excess);
+    }
 }
 
 ThreadHeap::ThreadHeap() noexcept {
@@ -53,10 +468,19 @@ ThreadHeap::ThreadHeap() noexcept {
         // 回调 ctx 传回自身存储地址，回调里用 at(*ptr) 还原引用
         at(managers_storage_[i]).setRefillCallback(&ThreadHeap::refillFromCentral_cb, /*ctx=*/&managers_storage_[i]);
         at(managers_storage_[i]).setReturnCallback(&ThreadHeap::returnToCentral_cb,   /*ctx=*/&managers_storage_[i]);
+
+        new (static_cast<void*>(&caches_storage_[i])) BlockCache(bs);
     }
 }
 
 ThreadHeap::~ThreadHeap() {
+    // 缓存中的块交回子池（登记为释放请求），缓存本身是平凡析构
+    flushAllCaches();
+
+    // 能回收的先回收（已空的子池经回调交还 CentralHeap），其余交给孤儿队列
+    reclaimBatch(SIZE_MAX);
+    orphanAll();
+
     for (std::size_t i = 0; i < k_class_count; ++i) {
         at(managers_storage_[i]).~SizeClassPoolManager();
     }
@@ -73,49 +497,407 @@ MemSubPool* ThreadHeap::refillFromCentral_cb(void* ctx) noexcept {
     SizeClassPoolManager& mgr = at(*storage_ptr);
     const std::size_t block_size = mgr.getBlockSize();
 
+    // 优先取回同 size-class 已格式化的空子池：构造状态与 PageMap 表项都还在，只需改写所有者
+    if (void* cached = CentralHeap::GetInstance().acquireFormattedPool(sizeToClass_(block_size))) {
+        auto* pool = static_cast<MemSubPool*>(cached);
+        setChunkOwner(pool, 1, tls_heap);
+        pool->adoptByCurrentThread();
+        return pool;
+    }
+
+    // 新 chunk 不必清零：子池处于 bump 模式，位图只在 bump 走到时才按字初始化
     void* raw = CentralHeap::GetInstance().acquireChunk(SizeClassConfig::kChunkSizeBytes);
     if (!raw) return nullptr;
 
-    return new (raw) MemSubPool(block_size);
+    // 子池只在所属线程的分配路径上补充，此时 tls_heap 就是它的所有者
+    PageMapEntry entry;
+    entry.kind       = ChunkKind::kSmallPool;
+    entry.size_class = static_cast<uint8_t>(sizeToClass_(block_size));
+    entry.base       = raw;
+    entry.owner      = tls_heap;
+    if (!PageMap::GetInstance().set(raw, 1, entry)) {
+        CentralHeap::GetInstance().releaseChunk(raw, SizeClassConfig::kChunkSizeBytes);
+        return nullptr;
+    }
+
+    return new (raw) MemSubPool(block_size, static_cast<uint32_t>(entry.size_class));
 }
 
 void ThreadHeap::returnToCentral_cb(void* /*ctx*/, MemSubPool* p) noexcept {
     if (!p) return;
-    p->~MemSubPool();
-    CentralHeap::GetInstance().releaseChunk(static_cast<void*>(p), SizeClassConfig::kChunkSizeBytes);
+
+    // 空子池保持格式化状态交给 CentralHeap 暂存；先清掉所有者，存入后可能立即被其他线程取走
+    setChunkOwner(p, 1, nullptr);
+    void* evicted = CentralHeap::GetInstance().depositFormattedPool(p, p->getSizeClass(), p->getDataOffset());
+    if (!evicted) return;
+
+    // 被挤出的子池（可能是 p 本身，也可能是其他 size-class 的）才真正析构并归还 chunk
+    auto* pool = static_cast<MemSubPool*>(evicted);
+    PageMap::GetInstance().clear(pool, 1);
+    pool->~MemSubPool();
+    CentralHeap::GetInstance().releaseChunk(evicted, SizeClassConfig::kChunkSizeBytes);
+}
+
+void* ThreadHeap::listSegmentAlloc_cb(void* /*ctx*/) noexcept {
+    return CentralHeap::GetInstance().acquirePageRun(1);
+}
+
+void ThreadHeap::listSegmentFree_cb(void* /*ctx*/, void* seg) noexcept {
+    CentralHeap::GetInstance().releasePageRun(seg);
+}
+
+bool ThreadHeap::reclaimNode_cb(void* ctx, BlockHeader* node) noexcept {
+    auto* th = static_cast<ThreadHeap*>(ctx);
+    MemSubPool* still_used = nullptr;
+    th->pass_reclaimed_ += th->reclaimNode(node, &still_used);
+    if (!still_used) return false;
+    still_used->in_managed_list = true;   // 节点原地保留
+    return true;
+}
+
+// ---- 中等对象路径 ----
+
+void* ThreadHeap::allocateMedium(std::size_t nbytes) noexcept {
+    const std::size_t pages = (nbytes + kMediumHeaderSize + SizeClassConfig::kPageSize - 1) / SizeClassConfig::kPageSize;
+    if (pages > PageRunAllocator::kMaxRunPages) {
+        return allocateLarge(nbytes);   // 加上头部后放不进单个页段
+    }
+
+    void* run = CentralHeap::GetInstance().acquirePageRun(pages);
+    if (!run) return nullptr;
+
+    auto* hdr = new (run) BlockHeader(BlockState::Used);
+    if (!attachUsed(hdr)) {
+        // 无法跟踪的块永远不会被回收：直接归还
+        CentralHeap::GetInstance().releasePageRun(run);
+        return nullptr;
+    }
+    return static_cast<char*>(run) + kMediumHeaderSize;
+}
+
+// ---- 大对象路径 ----
+
+void* ThreadHeap::allocateLarge(std::size_t nbytes) noexcept {
+    const std::size_t mapped = LargeObject::mappingSizeFor(nbytes);
+    if (mapped == 0) return nullptr;
+
+    void* raw = CentralHeap::GetInstance().acquireChunk(mapped);
+    if (!raw) return nullptr;
+
+    PageMapEntry entry;
+    entry.kind  = ChunkKind::kLargeObject;
+    entry.base  = raw;
+    entry.owner = this;
+    if (!PageMap::GetInstance().set(raw, mapped / SizeClassConfig::kChunkSizeBytes, entry)) {
+        CentralHeap::GetInstance().releaseChunk(raw, mapped);
+        return nullptr;
+    }
+
+    auto* obj = new (raw) LargeObject(mapped);
+
+    // 与小对象一样挂入 ManagedList，释放后由 GC 统一回收
+    if (!attachUsed(obj->managedNode())) {
+        releaseLarge(obj);
+        return nullptr;
+    }
+    return obj->block();
+}
+
+void ThreadHeap::releaseLarge(LargeObject* obj) noexcept {
+    const std::size_t mapped = obj->mappedBytes();
+    PageMap::GetInstance().clear(obj, mapped / SizeClassConfig::kChunkSizeBytes);
+    obj->~LargeObject();
+    CentralHeap::GetInstance().releaseChunk(static_cast<void*>(obj), mapped);
+}
+
+// ---- 线程缓存 ----
+
+void* ThreadHeap::refillCache(std::size_t class_idx) noexcept {
+    BlockCache& cache = at(caches_storage_[class_idx]);
+    SizeClassPoolManager& mgr = at(managers_storage_[class_idx]);
+
+    void* batch[BlockCache::kMaxCapacity];
+    std::size_t n = 0;
+
+    // 即将向 CentralHeap 要新子池：先做一轮增量清扫，被释放的块可能已经够用；
+    // 仍不够时认领已退出线程留下的同 size-class 子池，再取其他线程溢出到传输缓存的块
+    if (mgr.needsRefill()) {
+        autoCollect();
+        if (mgr.needsRefill()) adoptOrphanPools(class_idx);
+        if (mgr.needsRefill()) {
+            n = CentralHeap::GetInstance().removeTransferBlocks(class_idx, batch, cache.refillCount());
+        }
+    }
+
+    if (n > 0) {
+        // 传输缓存中的块一直记为占用，其子池已在所属线程的表中跟踪，不能再挂入本线程的表
+        chargeDebt(n * mgr.getBlockSize(), 0);
+    } else {
+        // 一次批量分配：同一子池的块整字领取；按地址升序，低地址的块先被取走
+        n = mgr.allocateBlocks(batch, cache.refillCount());
+        if (n == 0) return nullptr;
+        chargeDebt(n * mgr.getBlockSize(), 0);
+
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i == 0 || poolOf(batch[i]) != poolOf(batch[i - 1])) trackPoolOf(batch[i]);
+        }
+    }
+    for (std::size_t i = n - 1; i > 0; --i) {
+        cache.push(batch[i]);
+    }
+    return batch[0];
+}
+
+void ThreadHeap::cacheFree(std::size_t class_idx, void* blk) noexcept {
+    BlockCache& cache = at(caches_storage_[class_idx]);
+    cache.push(blk);
+    if (__builtin_expect(cache.overflowed(), 0)) {
+        // 回吐到半满：先存入传输缓存供其他线程取用，放不下的再交回子池
+        const std::size_t excess = cache.count() - cache.capacity() / 2;
+        flushCache(class_idx, excess - spillToTransfer(class_idx, excess));
+    }
+}
+
+std::size_t ThreadHeap::spillToTransfer(std::size_t class_idx, std::size_t n) noexcept {
+    BlockCache& cache = at(caches_storage_[class_idx]);
+
+    void* batch[BlockCache::kMaxCapacity + 1];
+    const std::size_t got = cache.popBatch(batch, std::min(n, std::size(batch)));
+    const std::size_t kept = CentralHeap::GetInstance().insertTransferBlocks(class_idx, batch, got);
+    // 传输缓存只接收前缀：其余放回线程缓存，保持原来的顺序
+    for (std::size_t i = got; i > kept; --i) {
+        cache.push(batch[i - 1]);
+    }
+    return kept;
+}
+
+void ThreadHeap::flushCache(std::size_t class_idx, std::size_t n) noexcept {
+    BlockCache& cache = at(caches_storage_[class_idx]);
+
+    void* batch[BlockCache::kMaxCapacity + 1];
+    while (n > 0) {
+        const std::size_t got = cache.popBatch(batch, std::min(n, std::size(batch)));
+        if (got == 0) break;
+        n -= got;
+
+        // 按地址排序后同一子池、同一位图字的块相邻，每组只做一次原子或；真正的回收留给 GC 清扫
+        std::sort(batch, batch + got);
+        std::size_t i = 0;
+        while (i < got) {
+            MemSubPool* pool = poolOf(batch[i]);
+            std::size_t j = i + 1;
+            while (j < got && poolOf(batch[j]) == pool) ++j;
+            pool->requestFreeBatch(batch + i, j - i);
+            i = j;
+        }
+        debt_blocks_ += got;   // 只记账：flushCache 在释放路径上，清扫留给下一次分配
+    }
+}
+
+void ThreadHeap::flushAllCaches() noexcept {
+    for (std::size_t i = 0; i < k_class_count; ++i) {
+        flushCache(i, at(caches_storage_[i]).count());
+    }
 }
 
 // -------------------- 小工具 --------------------
 
-void ThreadHeap::attachUsed(BlockHeader* blk) noexcept {
-    if (!blk) return;
-    managed_list_.appendUsed(blk);
+void ThreadHeap::trackPoolOf(void* blk) noexcept {
+    // 块本身不带头部：子池在首次有块被取出时整体挂入 ManagedList
+    MemSubPool* pool = poolOf(blk);
+    if (!pool->in_managed_list) {
+        // 段内存耗尽时保持未挂入，下次取块时再试
+        pool->in_managed_list = managed_list_.append(&pool->managed_node);
+    }
+}
+
+bool ThreadHeap::attachUsed(BlockHeader* blk) noexcept {
+    if (!blk) return false;
+    return managed_list_.appendUsed(blk);
 }
 
-std::size_t ThreadHeap::reclaimBatch(std::size_t max_scan) noexcept {
+std::size_t ThreadHeap::reclaimBatch(std::size_t max_scan, const DeadlineClock* deadline,
+                                     std::size_t* visited_out) noexcept {
     std::size_t reclaimed = 0;
-    std::size_t scanned   = 0;
+    std::size_t visited   = 0;
 
-    managed_list_.resetCursor();
+    // 有预算的调用最多走到本轮结束，调用方借此观察到一轮完成；
+    // 不限预算且游标在中途时，“覆盖整张表”意味着走完本轮后再完整走一轮
+    const bool full = (max_scan == SIZE_MAX && deadline == nullptr);
+    const uint64_t stop_epoch =
+        managed_list_.epoch() + ((full && managed_list_.passInProgress()) ? 2 : 1);
 
-    while (scanned < max_scan) {
-        BlockHeader* freed = managed_list_.reclaimNextFree();
-        if (!freed) break;
-        ++scanned;
+    while (visited < max_scan && managed_list_.epoch() < stop_epoch) {
+        if (deadline && deadline->expired()) break;
+        if (!managed_list_.passInProgress()) pass_reclaimed_ = 0;   // 下一步将开始新一轮
 
-        void* user_ptr = static_cast<void*>(freed);
+        // 限时清扫时每一步至多访问 kDeadlineCheckInterval 个节点，步间检查时钟
+        std::size_t step = max_scan - visited;
+        if (deadline && step > kDeadlineCheckInterval) step = kDeadlineCheckInterval;
 
-        bool released = false;
-        for (std::size_t i = 0; i < k_class_count; ++i) {
-            if (at(managers_storage_[i]).releaseBlock(user_ptr)) {
-                released = true;
-                break;
-            }
+        BlockHeader* node = managed_list_.sweepNextFree(step, &visited);
+        if (!node) continue;   // 步长用完或本轮结束，由循环条件决定是否继续
+
+        MemSubPool* still_used = nullptr;
+        const std::size_t n = reclaimNode(node, &still_used);
+        if (still_used) {
+            // 仍有在用块的子池重新挂回
+            still_used->in_managed_list = managed_list_.append(node);
         }
-        assert(released && "reclaimBatch: block not owned by any SizeClassPoolManager");
 
-        if (released) ++reclaimed;
+        reclaimed       += n;
+        pass_reclaimed_ += n;
     }
 
+    if (visited_out) *visited_out += visited;
     return reclaimed;
 }
+
+void ThreadHeap::chargeDebt(std::size_t bytes, std::size_t blocks) noexcept {
+    debt_bytes_  += bytes;
+    debt_blocks_ += blocks;
+    if (debtReached(debt_bytes_, g_gc_debt_bytes) || debtReached(debt_blocks_, g_gc_debt_blocks)) {
+        autoCollect();
+    }
+}
+
+void ThreadHeap::autoCollect() noexcept {
+    // 增量：每次只回收有限个节点，剩下的留给后续的触发；债务总是清零，避免每次分配都重复触发
+    debt_bytes_  = 0;
+    debt_blocks_ = 0;
+    reclaimBatch(kAutoGcScanBudget);
+    adoptOrphanBlocks();
+    // 顺带推进缓存衰减（到点才做，否则只读一次时钟）；先交出闲置的空子池，让它们赶上这一轮
+    decayEmptyPools();
+    CentralHeap::GetInstance().decayTick();
+}
+
+void ThreadHeap::decayEmptyPools() noexcept {
+    // 空子池只能由所属线程摘链，衰减因此挂在本线程的 GC 路径上，按低水位判断闲置
+    const auto now = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    if (now - empty_decay_start_ns_ < CentralHeap::GetInstance().getDirtyDecayNs()) {
+        return;
+    }
+    for (std::size_t i = 0; i < k_class_count; ++i) {
+        at(managers_storage_[i]).releaseIdleEmptyPools();
+    }
+    empty_decay_start_ns_ = now;
+}
+
+// -------------------- 孤儿 --------------------
+
+void ThreadHeap::orphanAll() noexcept {
+    // 跟踪中的子池节点随子池一起交出；中等 / 大对象节点（仍在用或刚被释放）串成一条链
+    OrphanChain chain;
+    managed_list_.drain([](void* ctx, BlockHeader* node) noexcept {
+        const PageMapEntry entry = PageMap::GetInstance().lookup(node);
+        switch (entry.kind) {
+        case ChunkKind::kSmallPool:
+            static_cast<MemSubPool*>(entry.base)->in_managed_list = false;
+            return;
+        case ChunkKind::kLargeObject: {
+            auto* obj = static_cast<LargeObject*>(entry.base);
+            setChunkOwner(obj, obj->mappedBytes() / SizeClassConfig::kChunkSizeBytes, nullptr);
+            break;
+        }
+        default:
+            break;
+        }
+        static_cast<OrphanChain*>(ctx)->push(node);
+    }, &chain);
+    CentralHeap::GetInstance().publishOrphanBlocks(chain.first, chain.last);
+
+    // 不再有所属线程：之后的释放都走释放请求，由认领者清扫
+    for (std::size_t i = 0; i < k_class_count; ++i) {
+        at(managers_storage_[i]).abandonPools([](void* /*ctx*/, MemSubPool* pool) noexcept {
+            setChunkOwner(pool, 1, nullptr);
+            CentralHeap::GetInstance().publishOrphanPool(pool->getSizeClass(), &pool->managed_node);
+        }, nullptr);
+    }
+}
+
+void ThreadHeap::adoptOrphanPools(std::size_t class_idx) noexcept {
+    CentralHeap& central = CentralHeap::GetInstance();
+    SizeClassPoolManager& mgr = at(managers_storage_[class_idx]);
+
+    // 满子池认领后仍不可用：继续认领，但每次至多 kOrphanAdoptBatch 个，避免补货路径过长
+    for (std::size_t i = 0; i < kOrphanAdoptBatch && mgr.needsRefill(); ++i) {
+        BlockHeader* node = central.adoptOrphanPool(class_idx);
+        if (!node) break;
+
+        MemSubPool* pool = poolOf(node);
+        setChunkOwner(pool, 1, this);
+
+        bool emptied = false;
+        pass_reclaimed_ += mgr.adoptPool(pool, &emptied);
+        if (!emptied) {
+            // 认领前后到达的释放请求都由本线程的清扫处理
+            pool->in_managed_list = managed_list_.append(&pool->managed_node);
+        }
+    }
+}
+
+void ThreadHeap::adoptOrphanBlocks() noexcept {
+    BlockHeader* node = CentralHeap::GetInstance().adoptOrphanBlocks();
+    OrphanChain untracked;
+
+    while (node) {
+        BlockHeader* next = node->next;
+        node->next = nullptr;
+
+        if (node->loadState() == BlockState::Free) {
+            MemSubPool* still_used = nullptr;
+            pass_reclaimed_ += reclaimNode(node, &still_used);
+        } else if (managed_list_.append(node)) {
+            // 挂入时保留状态：认领之后才被释放的块由下一轮清扫回收
+            const PageMapEntry entry = PageMap::GetInstance().lookup(node);
+            if (entry.kind == ChunkKind::kLargeObject) {
+                auto* obj = static_cast<LargeObject*>(entry.base);
+                setChunkOwner(obj, obj->mappedBytes() / SizeClassConfig::kChunkSizeBytes, this);
+            }
+        } else {
+            untracked.push(node);   // 段内存耗尽：放回队列
+        }
+        node = next;
+    }
+    CentralHeap::GetInstance().publishOrphanBlocks(untracked.first, untracked.last);
+}
+
+std::size_t ThreadHeap::reclaimNode(BlockHeader* node, MemSubPool** still_used) noexcept {
+    // 节点都在带外头部里：子池头部、页段首部或大对象头部，经 PageMap 区分
+    const PageMapEntry entry = PageMap::GetInstance().lookup(node);
+
+    switch (entry.kind) {
+    case ChunkKind::kSmallPool: {
+        // 子池：一次清扫回收其中所有被请求释放的块
+        auto* pool = static_cast<MemSubPool*>(entry.base);
+        bool emptied = false;
+        const std::size_t n = reclaimPool(pool, &emptied);
+        // 已空的子池可能已交还 CentralHeap，不能再访问
+        if (!emptied) *still_used = pool;
+        return n;
+    }
+    case ChunkKind::kMediumRun:
+        // 中等对象：页段交还共享的页段分配器，与相邻空闲段合并
+        CentralHeap::GetInstance().releasePageRun(node);
+        return 1;
+    case ChunkKind::kLargeObject:
+        // 大对象：整段映射交还 CentralHeap（缓存或解除映射）
+        releaseLarge(static_cast<LargeObject*>(entry.base));
+        return 1;
+    case ChunkKind::kNone:
+        assert(false && "reclaimNode: block not registered in PageMap");
+        break;
+    }
+    return 0;
+}
+
+std::size_t ThreadHeap::reclaimPool(MemSubPool* pool, bool* emptied) noexcept {
+    // 子池头部记录了 size-class，直接分派给对应管理器
+    const uint32_t class_idx = pool->getSizeClass();
+    assert(class_idx < k_class_count && "reclaimPool: pool without a size class");
+
+    pool->in_managed_list = false;
+    return at(managers_storage_[class_idx]).reclaimFreeRequested(pool, emptied);
+}
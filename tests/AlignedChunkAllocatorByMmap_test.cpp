@@ -97,4 +97,37 @@ TEST_F(AlignedChunkAllocatorByMmapTest, DeallocateFailsWhenMunmapFails) {
 
     // 清理我们最开始正确分配的内存
     allocator->deallocate(ptr, kAlignmentSize);
-}
\ No newline at end of file
+}
+
+// --- 4. 批量分配 ---
+
+TEST_F(AlignedChunkAllocatorByMmapTest, AllocateBatchReturnsIndependentAlignedChunks) {
+    constexpr size_t kCount = 9;
+    void* chunks[kCount] = {};
+
+    ASSERT_EQ(allocator->allocateBatch(kAlignmentSize, kCount, chunks), kCount);
+
+    for (size_t i = 0; i < kCount; ++i) {
+        ASSERT_NE(chunks[i], nullptr);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(chunks[i]) & (kAlignmentSize - 1), 0u);
+        if (i > 0) {
+            // 同一批的 chunk 互不重叠
+            ASSERT_EQ(static_cast<char*>(chunks[i]) - static_cast<char*>(chunks[i - 1]),
+                      static_cast<ptrdiff_t>(kAlignmentSize));
+        }
+        // 每个 chunk 都可读写
+        static_cast<char*>(chunks[i])[0] = 1;
+        static_cast<char*>(chunks[i])[kAlignmentSize - 1] = 2;
+    }
+
+    // 每个 chunk 都能单独归还，顺序任意
+    for (size_t i = kCount; i-- > 0;) {
+        ASSERT_NO_THROW(allocator->deallocate(chunks[i], kAlignmentSize));
+    }
+}
+
+TEST_F(AlignedChunkAllocatorByMmapTest, AllocateBatchOfZeroReturnsNothing) {
+    void* chunk = nullptr;
+    EXPECT_EQ(allocator->allocateBatch(kAlignmentSize, 0, &chunk), 0u);
+    EXPECT_EQ(chunk, nullptr);
+}
@@ -1,6 +1,8 @@
 #include "gtest/gtest.h"
 #include "gc_malloc/ThreadHeap/Bitmap.hpp"
 
+#include <vector>
+
 // 测试套件名称: BitmapTest
 // 测试用例名称: HandlesInitializationCorrectly
 TEST(BitmapTest, HandlesInitializationCorrectly) {
@@ -69,4 +71,79 @@ TEST(BitmapTest, FindsFirstFreeBlockCorrectly) {
         bitmap.markAsUsed(i);
     }
     EXPECT_EQ(bitmap.findFirstFree(), Bitmap::k_not_found);
-}
\ No newline at end of file
+}
+// 按字清位：只清除已占用的位，返回实际清除的个数；超出容量的位不受影响
+TEST(BitmapTest, ClearMaskClearsOnlyUsedBits) {
+    const size_t capacity = 70;
+    unsigned char buffer[16];
+    Bitmap bitmap(capacity, buffer, sizeof(buffer));
+
+    for (size_t i : {0u, 5u, 63u, 64u, 69u}) bitmap.markAsUsed(i);
+
+    // 第 0 个字：第 0、5、63 位已占用，第 7 位本就空闲
+    EXPECT_EQ(bitmap.clearMask(0, (1ull << 0) | (1ull << 7) | (1ull << 63)), 2u);
+    EXPECT_FALSE(bitmap.isUsed(0));
+    EXPECT_TRUE(bitmap.isUsed(5));
+    EXPECT_FALSE(bitmap.isUsed(63));
+
+    // 第 1 个字：第 64、69 位；第 70 位以后超出容量，保持“占用”
+    EXPECT_EQ(bitmap.clearMask(1, ~0ull), 2u);
+    EXPECT_FALSE(bitmap.isUsed(64));
+    EXPECT_FALSE(bitmap.isUsed(69));
+    EXPECT_TRUE(bitmap.isUsed(70));
+    EXPECT_EQ(bitmap.findFirstFree(70), Bitmap::k_not_found);
+}
+
+// 字级扫描：跨越多个全满字（足以走到 SIMD 跳过路径）后仍能精确定位，容量不是 64 的倍数时不越界
+TEST(BitmapTest, WordScanSkipsLongFullRuns) {
+    const size_t capacity = 5000;
+    std::vector<unsigned char> buffer(1024);
+    Bitmap bitmap(capacity, buffer.data(), buffer.size());
+
+    for (size_t i = 0; i < capacity; ++i) bitmap.markAsUsed(i);
+    EXPECT_EQ(bitmap.findFirstFree(), Bitmap::k_not_found);
+
+    for (size_t hole : {4999u, 4097u, 777u, 64u, 63u}) {
+        bitmap.markAsFree(hole);
+        EXPECT_EQ(bitmap.findFirstFree(), hole);
+        EXPECT_EQ(bitmap.findFirstFree(hole), hole);
+        EXPECT_EQ(bitmap.findFirstFree(hole + 1), hole == 4999u ? Bitmap::k_not_found : 4999u);
+        if (hole != 4999u) bitmap.markAsUsed(hole);
+    }
+    EXPECT_EQ(bitmap.findFirstFree(capacity), Bitmap::k_not_found);
+}
+
+TEST(BitmapTest, FindFirstFreeRun) {
+    const size_t capacity = 300;
+    unsigned char buffer[40];
+    Bitmap bitmap(capacity, buffer, sizeof(buffer));
+
+    EXPECT_EQ(bitmap.findFirstFreeRun(10), 0u);
+    EXPECT_EQ(bitmap.findFirstFreeRun(0), Bitmap::k_not_found);
+
+    // 占用 [0, 60) 与 [70, 200)：[60, 70) 只有 10 位，更长的段要到 200 之后
+    for (size_t i = 0; i < 60; ++i) bitmap.markAsUsed(i);
+    for (size_t i = 70; i < 200; ++i) bitmap.markAsUsed(i);
+
+    EXPECT_EQ(bitmap.findFirstFreeRun(10), 60u);
+    EXPECT_EQ(bitmap.findFirstFreeRun(11), 200u);
+    EXPECT_EQ(bitmap.findFirstFreeRun(100), 200u);
+    EXPECT_EQ(bitmap.findFirstFreeRun(101), Bitmap::k_not_found);
+    EXPECT_EQ(bitmap.findFirstFreeRun(5, 65), 65u);
+    EXPECT_EQ(bitmap.findFirstFreeRun(6, 65), 200u);
+}
+
+TEST(BitmapTest, SetMaskSetsOnlyFreeBits) {
+    const size_t capacity = 70;
+    unsigned char buffer[16];
+    Bitmap bitmap(capacity, buffer, sizeof(buffer));
+
+    bitmap.markAsUsed(3);
+    EXPECT_EQ(bitmap.setMask(0, 0xFull), 3u);
+    EXPECT_EQ(bitmap.findFirstFree(), 4u);
+
+    // 第 1 个字只有 6 个有效位
+    EXPECT_EQ(bitmap.setMask(1, ~0ull), 6u);
+    EXPECT_EQ(bitmap.loadWord(1), ~0ull);
+    EXPECT_EQ(bitmap.findFirstFree(64), Bitmap::k_not_found);
+}
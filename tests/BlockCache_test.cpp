@@ -0,0 +1,48 @@
+#include "gtest/gtest.h"
+#include "gc_malloc/ThreadHeap/BlockCache.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// 容量按块大小缩放并夹在 [kMinCapacity, kMaxCapacity]
+TEST(BlockCacheTest, CapacityScalesWithBlockSize) {
+    EXPECT_EQ(BlockCache(32).capacity(), BlockCache::kMaxCapacity);
+    EXPECT_EQ(BlockCache(1024).capacity(), BlockCache::kBytesPerClass / 1024);
+    EXPECT_EQ(BlockCache(64 * 1024).capacity(), BlockCache::kMinCapacity);
+    EXPECT_GE(BlockCache(64 * 1024).refillCount(), 1u);
+}
+
+TEST(BlockCacheTest, PushPopIsLifo) {
+    std::vector<std::uint64_t> storage(8 * 4);
+    void* blocks[4];
+    for (int i = 0; i < 4; ++i) blocks[i] = &storage[i * 8];
+
+    BlockCache cache(64);
+    EXPECT_EQ(cache.pop(), nullptr);
+
+    for (void* b : blocks) cache.push(b);
+    EXPECT_EQ(cache.count(), 4u);
+    EXPECT_TRUE(cache.contains(blocks[2]));
+
+    EXPECT_EQ(cache.pop(), blocks[3]);
+    EXPECT_EQ(cache.pop(), blocks[2]);
+    EXPECT_FALSE(cache.contains(blocks[2]));
+
+    void* out[4] = {};
+    EXPECT_EQ(cache.popBatch(out, 4), 2u);
+    EXPECT_EQ(out[0], blocks[1]);
+    EXPECT_EQ(out[1], blocks[0]);
+    EXPECT_EQ(cache.count(), 0u);
+    EXPECT_EQ(cache.pop(), nullptr);
+}
+
+TEST(BlockCacheTest, OverflowedPastCapacity) {
+    const std::size_t block_size = 16 * 1024;
+    BlockCache cache(block_size);
+    std::vector<std::uint64_t> storage((cache.capacity() + 1) * 2);
+
+    for (std::size_t i = 0; i < cache.capacity(); ++i) cache.push(&storage[i * 2]);
+    EXPECT_FALSE(cache.overflowed());
+    cache.push(&storage[cache.capacity() * 2]);
+    EXPECT_TRUE(cache.overflowed());
+}
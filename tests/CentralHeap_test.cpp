@@ -1,5 +1,11 @@
 #include "gtest/gtest.h"
 #include "gc_malloc/CentralHeap/CentralHeap.hpp" // 引入要测试的类
+#include "gc_malloc/ThreadHeap/BlockHeader.hpp"
+
+#include <chrono>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
 
 // 定义一个简单的测试固件
 class CentralHeapTest : public ::testing::Test {
@@ -102,4 +108,141 @@ TEST_F(CentralHeapTest, ReleaseStopsAtHighWatermark) {
     for (void* chunk : acquired_chunks) {
         heap.releaseChunk(chunk, kChunkSize);
     }
-}
\ No newline at end of file
+}
+
+// 测试5：多 chunk 请求返回一段 2MB 对齐、整段可写的连续映射，释放后可被复用
+TEST_F(CentralHeapTest, MultiChunkSpanAcquireAndRelease) {
+    CentralHeap& heap = CentralHeap::GetInstance();
+    const size_t span_size = 3 * kChunkSize;
+
+    void* span = heap.acquireChunk(span_size);
+    ASSERT_NE(span, nullptr);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(span) & (kChunkSize - 1), 0u);
+
+    char* bytes = static_cast<char*>(span);
+    bytes[0] = 1;
+    bytes[span_size - 1] = 2;
+
+    heap.releaseChunk(span, span_size);
+
+    // 更小的多 chunk 请求可以从缓存段中裁剪得到
+    void* again = heap.acquireChunk(2 * kChunkSize);
+    ASSERT_NE(again, nullptr);
+    EXPECT_EQ(again, span);
+    static_cast<char*>(again)[2 * kChunkSize - 1] = 3;
+    heap.releaseChunk(again, 2 * kChunkSize);
+}
+
+// 测试：孤儿队列按 size-class 后进先出；孤儿块整链取走
+TEST_F(CentralHeapTest, OrphanQueuesHandOutPublishedNodes) {
+    CentralHeap& heap = CentralHeap::GetInstance();
+
+    // 用一个不对应任何 size-class 的槽位，避免与其他测试中退出的线程交出的子池混在一起
+    const size_t slot = CentralHeap::kOrphanClassSlots - 1;
+    BlockHeader pools[2];
+    EXPECT_FALSE(heap.hasOrphanPools(slot));
+    heap.publishOrphanPool(slot, &pools[0]);
+    heap.publishOrphanPool(slot, &pools[1]);
+    EXPECT_TRUE(heap.hasOrphanPools(slot));
+    EXPECT_EQ(heap.adoptOrphanPool(slot), &pools[1]);
+    EXPECT_EQ(pools[1].next, nullptr);
+    EXPECT_EQ(heap.adoptOrphanPool(slot), &pools[0]);
+    EXPECT_EQ(heap.adoptOrphanPool(slot), nullptr);
+    EXPECT_FALSE(heap.hasOrphanPools(slot));
+
+    BlockHeader blocks[3];
+    blocks[0].next = &blocks[1];
+    blocks[1].next = &blocks[2];
+    heap.publishOrphanBlocks(&blocks[0], &blocks[2]);
+    EXPECT_TRUE(heap.hasOrphanBlocks());
+
+    // 队列是全局的：其他线程退出时交出的块可能排在后面，找到自己的三块后原样放回
+    BlockHeader* chain = heap.adoptOrphanBlocks();
+    ASSERT_EQ(chain, &blocks[0]);
+    EXPECT_EQ(blocks[0].next, &blocks[1]);
+    EXPECT_EQ(blocks[1].next, &blocks[2]);
+    BlockHeader* rest = blocks[2].next;
+    if (rest) {
+        BlockHeader* last = rest;
+        while (last->next) last = last->next;
+        heap.publishOrphanBlocks(rest, last);
+    }
+}
+
+// 以 chunk 最后一页是否驻留判断它的物理页是否已交还
+static bool LastPageResident(void* chunk, size_t chunk_size) {
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    unsigned char vec = 0;
+    EXPECT_EQ(mincore(static_cast<char*>(chunk) + chunk_size - page, page, &vec), 0);
+    return (vec & 1) != 0;
+}
+
+// 测试：超出热缓存水位的 chunk 保持映射进入保留缓存，衰减到期后物理页被交还
+TEST_F(CentralHeapTest, DecayedChunksReturnPhysicalPages) {
+    CentralHeap& heap = CentralHeap::GetInstance();
+    std::vector<void*> chunks;
+    for (size_t i = 0; i < kMaxWatermarkInChunks + 4; ++i) {
+        void* chunk = heap.acquireChunk(kChunkSize);
+        ASSERT_NE(chunk, nullptr);
+        static_cast<char*>(chunk)[kChunkSize - 1] = 1;
+        chunks.push_back(chunk);
+    }
+    for (void* chunk : chunks) {
+        heap.releaseChunk(chunk, kChunkSize);
+    }
+    EXPECT_GE(heap.getDecayStats().retained_dirty + heap.getDecayStats().retained_clean, 4u);
+
+    // muzzy 时间为 0：到期直接 MADV_DONTNEED，驻留状态可以立即观察到
+    heap.setDecayTimes(std::chrono::milliseconds{0}, std::chrono::milliseconds{0});
+    heap.purgeDecayed();
+    const CentralHeap::DecayStats stats = heap.getDecayStats();
+    EXPECT_EQ(stats.retained_dirty, 0u);
+    EXPECT_EQ(stats.retained_muzzy, 0u);
+    EXPECT_GE(stats.retained_clean, 4u);
+
+    size_t purged = 0;
+    for (void* chunk : chunks) {
+        if (!LastPageResident(chunk, kChunkSize)) ++purged;
+    }
+    EXPECT_GE(purged, 4u);
+
+    // 交还物理页的 chunk 仍可直接复用
+    void* again = heap.acquireChunk(kChunkSize);
+    ASSERT_NE(again, nullptr);
+    static_cast<char*>(again)[kChunkSize - 1] = 2;
+    heap.releaseChunk(again, kChunkSize);
+
+    heap.setDecayTimes(CentralHeap::kDefaultDirtyDecay, CentralHeap::kDefaultMuzzyDecay);
+}
+
+// 测试：后台线程按间隔推进衰减，停止后可以再次启动
+TEST_F(CentralHeapTest, BackgroundPurgeDecaysRetainedChunks) {
+    CentralHeap& heap = CentralHeap::GetInstance();
+    std::vector<void*> chunks;
+    for (size_t i = 0; i < kMaxWatermarkInChunks + 2; ++i) {
+        void* chunk = heap.acquireChunk(kChunkSize);
+        ASSERT_NE(chunk, nullptr);
+        static_cast<char*>(chunk)[0] = 1;
+        chunks.push_back(chunk);
+    }
+    for (void* chunk : chunks) {
+        heap.releaseChunk(chunk, kChunkSize);
+    }
+
+    heap.setDecayTimes(std::chrono::milliseconds{0}, std::chrono::milliseconds{0});
+    ASSERT_TRUE(heap.startBackgroundPurge(std::chrono::milliseconds{5}));
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+    CentralHeap::DecayStats stats = heap.getDecayStats();
+    while ((stats.retained_dirty != 0 || stats.retained_clean == 0) &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+        stats = heap.getDecayStats();
+    }
+    heap.stopBackgroundPurge();
+    EXPECT_EQ(stats.retained_dirty, 0u);
+    EXPECT_GT(stats.retained_clean, 0u);
+
+    ASSERT_TRUE(heap.startBackgroundPurge(std::chrono::milliseconds{5}));
+    heap.stopBackgroundPurge();
+    heap.setDecayTimes(CentralHeap::kDefaultDirtyDecay, CentralHeap::kDefaultMuzzyDecay);
+}
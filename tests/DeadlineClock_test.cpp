@@ -0,0 +1,51 @@
+#include "gtest/gtest.h"
+
+#include "gc_malloc/ThreadHeap/DeadlineClock.hpp"
+
+#include <chrono>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+TEST(DeadlineClockTest, ZeroBudgetIsExpiredImmediately) {
+    DeadlineClock clock(0ns);
+    EXPECT_TRUE(clock.expired());
+}
+
+TEST(DeadlineClockTest, ExpiresAfterBudget) {
+    DeadlineClock clock(2ms);
+    EXPECT_FALSE(clock.expired());
+    std::this_thread::sleep_for(5ms);
+    EXPECT_TRUE(clock.expired());
+    EXPECT_GE(clock.elapsed(), 4ms);
+}
+
+// 标定完成后（无论是否改用 TSC）读数与 steady_clock 一致
+TEST(DeadlineClockTest, ElapsedTracksSteadyClockAfterCalibration) {
+    { DeadlineClock warmup(0ns); }
+    std::this_thread::sleep_for(2ms);
+    { DeadlineClock warmup(0ns); }
+
+    const auto start = std::chrono::steady_clock::now();
+    DeadlineClock clock(1s);
+    std::this_thread::sleep_for(10ms);
+    const auto truth = std::chrono::steady_clock::now() - start;
+    const auto measured = clock.elapsed();
+
+    EXPECT_FALSE(clock.expired());
+    EXPECT_GE(measured, truth * 9 / 10);
+    EXPECT_LE(measured, truth * 11 / 10 + 1ms);
+}
+
+// 预算换算成截止时间时饱和而不回绕：标定前后都不会立即到期
+TEST(DeadlineClockTest, MaximalBudgetNeverExpiresImmediately) {
+    for (int round = 0; round < 2; ++round) {
+        DeadlineClock forever(std::chrono::nanoseconds::max());
+        EXPECT_FALSE(forever.expired()) << "round " << round;
+        DeadlineClock huge(std::chrono::hours(24 * 365 * 100));
+        EXPECT_FALSE(huge.expired()) << "round " << round;
+        // 第二轮时 TSC（若可用）已完成标定
+        std::this_thread::sleep_for(2ms);
+        { DeadlineClock warmup(0ns); }
+    }
+}
@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+#include "gc_malloc/CentralHeap/FormattedPoolCache.hpp"
+
+#include <cstdint>
+
+// 只做记账：用假地址即可，不会真的访问这些内存
+static void* FakePool(std::uintptr_t n) {
+    return reinterpret_cast<void*>(n << 21);
+}
+
+TEST(FormattedPoolCacheTest, InitialStateIsEmpty) {
+    FormattedPoolCache cache;
+    EXPECT_EQ(cache.getCacheCount(), 0u);
+    EXPECT_EQ(cache.acquire(0), nullptr);
+    EXPECT_EQ(cache.deposit(nullptr, 0), nullptr);
+    EXPECT_EQ(cache.getCacheCount(), 0u);
+}
+
+TEST(FormattedPoolCacheTest, AcquireMatchesSizeClassNewestFirst) {
+    FormattedPoolCache cache;
+    EXPECT_EQ(cache.deposit(FakePool(1), 3), nullptr);
+    EXPECT_EQ(cache.deposit(FakePool(2), 5), nullptr);
+    EXPECT_EQ(cache.deposit(FakePool(3), 3), nullptr);
+    EXPECT_EQ(cache.getClassCount(3), 2u);
+
+    EXPECT_EQ(cache.acquire(3), FakePool(3));
+    EXPECT_EQ(cache.acquire(3), FakePool(1));
+    EXPECT_EQ(cache.acquire(3), nullptr);   // 其他 size-class 的子池不会被交出
+    EXPECT_EQ(cache.acquire(5), FakePool(2));
+    EXPECT_EQ(cache.getCacheCount(), 0u);
+}
+
+TEST(FormattedPoolCacheTest, PerClassLimitEvictsOldestOfSameClass) {
+    FormattedPoolCache cache;
+    EXPECT_EQ(cache.deposit(FakePool(1), 7), nullptr);
+    EXPECT_EQ(cache.deposit(FakePool(2), 8), nullptr);
+    for (std::uintptr_t i = 3; i < 2 + FormattedPoolCache::kMaxPerClass; ++i) {
+        EXPECT_EQ(cache.deposit(FakePool(i), 7), nullptr);
+    }
+
+    // 同类已满：挤出同类中最早存入的，其他 size-class 不受影响
+    EXPECT_EQ(cache.deposit(FakePool(100), 7), FakePool(1));
+    EXPECT_EQ(cache.getClassCount(7), FormattedPoolCache::kMaxPerClass);
+    EXPECT_EQ(cache.getClassCount(8), 1u);
+    EXPECT_EQ(cache.acquire(7), FakePool(100));
+}
+
+TEST(FormattedPoolCacheTest, FullCacheEvictsOldestEntry) {
+    FormattedPoolCache cache;
+    for (std::uintptr_t i = 0; i < FormattedPoolCache::kMaxEntries; ++i) {
+        ASSERT_EQ(cache.deposit(FakePool(i + 1), i), nullptr);
+    }
+    EXPECT_EQ(cache.getCacheCount(), FormattedPoolCache::kMaxEntries);
+
+    EXPECT_EQ(cache.deposit(FakePool(50), 40), FakePool(1));
+    EXPECT_EQ(cache.getCacheCount(), FormattedPoolCache::kMaxEntries);
+    EXPECT_EQ(cache.acquire(0), nullptr);
+    EXPECT_EQ(cache.acquire(40), FakePool(50));
+}
+
+static bool RecordPurgeOffset(void* ctx, void* /*base*/, size_t offset, ChunkDecayStage to) noexcept {
+    EXPECT_EQ(to, ChunkDecayStage::kMuzzy);
+    *static_cast<size_t*>(ctx) = offset;
+    return true;
+}
+
+TEST(FormattedPoolCacheTest, AdvancePurgesPastHeaderAndKeepsPoolAcquirable) {
+    FormattedPoolCache cache;
+    ASSERT_EQ(cache.deposit(FakePool(1), 4, 8192, 0), nullptr);
+    EXPECT_EQ(cache.getCount(ChunkDecayStage::kDirty), 1u);
+
+    size_t offset = 0;
+    EXPECT_EQ(cache.advance(50, 100, 100, &RecordPurgeOffset, &offset), 0u);   // 未到期
+    EXPECT_EQ(cache.advance(100, 100, 100, &RecordPurgeOffset, &offset), 1u);
+    EXPECT_EQ(offset, 8192u);
+    EXPECT_EQ(cache.getCount(ChunkDecayStage::kMuzzy), 1u);
+
+    // 降级后仍可按 size-class 取回
+    EXPECT_EQ(cache.acquire(4), FakePool(1));
+}
@@ -0,0 +1,57 @@
+#include "gtest/gtest.h"
+#include "gc_malloc/CentralHeap/LargeChunkCache.hpp"
+
+#include <cstdint>
+
+// 只做记账：用假地址即可，不会真的访问这些内存
+static void* FakeSpan(std::uintptr_t n) {
+    return reinterpret_cast<void*>(n << 21);
+}
+
+constexpr size_t kMB = 1024 * 1024;
+
+TEST(LargeChunkCacheTest, InitialStateIsEmpty) {
+    LargeChunkCache cache;
+    size_t span_size = 0;
+    EXPECT_EQ(cache.getCacheCount(), 0u);
+    EXPECT_EQ(cache.getCachedBytes(), 0u);
+    EXPECT_EQ(cache.acquire(4 * kMB, &span_size), nullptr);
+}
+
+TEST(LargeChunkCacheTest, AcquirePicksBestFit) {
+    LargeChunkCache cache;
+    ASSERT_TRUE(cache.deposit(FakeSpan(1), 16 * kMB));
+    ASSERT_TRUE(cache.deposit(FakeSpan(2), 6 * kMB));
+    ASSERT_TRUE(cache.deposit(FakeSpan(3), 4 * kMB));
+    EXPECT_EQ(cache.getCacheCount(), 3u);
+    EXPECT_EQ(cache.getCachedBytes(), 26 * kMB);
+
+    // 需要 5MB：4MB 不够，6MB 是最小的可用段
+    size_t span_size = 0;
+    EXPECT_EQ(cache.acquire(5 * kMB, &span_size), FakeSpan(2));
+    EXPECT_EQ(span_size, 6 * kMB);
+    EXPECT_EQ(cache.getCachedBytes(), 20 * kMB);
+
+    // 恰好匹配
+    EXPECT_EQ(cache.acquire(4 * kMB, &span_size), FakeSpan(3));
+    EXPECT_EQ(span_size, 4 * kMB);
+
+    // 没有足够大的段
+    EXPECT_EQ(cache.acquire(32 * kMB, &span_size), nullptr);
+    EXPECT_EQ(cache.getCacheCount(), 1u);
+}
+
+TEST(LargeChunkCacheTest, DepositRespectsLimits) {
+    LargeChunkCache cache;
+
+    // 单段超过总字节上限
+    EXPECT_FALSE(cache.deposit(FakeSpan(1), LargeChunkCache::kMaxCachedBytes + 2 * kMB));
+    EXPECT_FALSE(cache.deposit(nullptr, 4 * kMB));
+
+    // 条目数上限
+    for (size_t i = 0; i < LargeChunkCache::kMaxEntries; ++i) {
+        ASSERT_TRUE(cache.deposit(FakeSpan(10 + i), 4 * kMB));
+    }
+    EXPECT_FALSE(cache.deposit(FakeSpan(100), 4 * kMB));
+    EXPECT_EQ(cache.getCacheCount(), LargeChunkCache::kMaxEntries);
+}
@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+#include "gc_malloc/CentralHeap/LockFreeChunkCache.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+class LockFreeChunkCacheTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        for (void* chunk : chunks_) {
+            delete[] static_cast<char*>(chunk);
+        }
+    }
+
+    void* makeChunk() {
+        chunks_.push_back(new char[64]);
+        return chunks_.back();
+    }
+
+    LockFreeChunkCache cache;
+    std::vector<void*> chunks_;
+};
+
+TEST_F(LockFreeChunkCacheTest, InitialStateIsEmpty) {
+    EXPECT_EQ(cache.getCacheCount(), 0u);
+    EXPECT_EQ(cache.acquire(), nullptr);
+}
+
+TEST_F(LockFreeChunkCacheTest, LIFO_OrderIsCorrect) {
+    void* p1 = makeChunk();
+    void* p2 = makeChunk();
+
+    cache.deposit(p1);
+    cache.deposit(p2);
+    cache.deposit(nullptr);   // 忽略
+
+    EXPECT_EQ(cache.getCacheCount(), 2u);
+    EXPECT_EQ(cache.acquire(), p2);
+    EXPECT_EQ(cache.acquire(), p1);
+    EXPECT_EQ(cache.acquire(), nullptr);
+    EXPECT_EQ(cache.getCacheCount(), 0u);
+}
+
+// 同一个 chunk 反复出入栈（ABA 的典型场景），栈结构保持完整
+TEST_F(LockFreeChunkCacheTest, ReusedChunkKeepsStackConsistent) {
+    void* a = makeChunk();
+    void* b = makeChunk();
+    cache.deposit(b);
+    for (int i = 0; i < 1000; ++i) {
+        cache.deposit(a);
+        ASSERT_EQ(cache.acquire(), a);
+    }
+    EXPECT_EQ(cache.acquire(), b);
+    EXPECT_EQ(cache.acquire(), nullptr);
+}
+
+// 多个线程同时存取同一批 chunk：不丢失、不重复
+TEST_F(LockFreeChunkCacheTest, ConcurrentChurnPreservesEveryChunk) {
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 64;
+    constexpr int kRounds = 2000;
+
+    for (int i = 0; i < kThreads * kPerThread; ++i) {
+        cache.deposit(makeChunk());
+    }
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; ++t) {
+        workers.emplace_back([this] {
+            void* held[4];
+            for (int r = 0; r < kRounds; ++r) {
+                int n = 0;
+                for (; n < 4; ++n) {
+                    held[n] = cache.acquire();
+                    if (!held[n]) break;
+                    *static_cast<char*>(held[n]) = 0x5A;   // 模拟使用者改写 chunk 内容
+                }
+                for (int i = 0; i < n; ++i) cache.deposit(held[i]);
+            }
+            cache.waitForReaders();
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    EXPECT_EQ(cache.getCacheCount(), chunks_.size());
+
+    std::vector<void*> drained;
+    while (void* p = cache.acquire()) drained.push_back(p);
+    ASSERT_EQ(drained.size(), chunks_.size());
+
+    std::sort(drained.begin(), drained.end());
+    EXPECT_EQ(std::adjacent_find(drained.begin(), drained.end()), drained.end());
+}
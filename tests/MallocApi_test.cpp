@@ -0,0 +1,176 @@
+#include "gtest/gtest.h"
+
+#include "gc_malloc/Shim/MallocApi.hpp"
+#include "gc_malloc/ThreadHeap/ThreadHeap.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+static bool IsAligned(const void* p, std::size_t a) {
+    return (reinterpret_cast<std::uintptr_t>(p) & (a - 1)) == 0;
+}
+
+// 断言显式 GC 回收数的用例里关闭按债务自动触发的清扫，结束时恢复默认阈值
+struct ManualGcScope {
+    ManualGcScope()  { ThreadHeap::setGcDebtThreshold(0, 0); }
+    ~ManualGcScope() {
+        ThreadHeap::setGcDebtThreshold(ThreadHeap::kDefaultGcDebtBytes, ThreadHeap::kDefaultGcDebtBlocks);
+    }
+};
+
+// 基本分配：16B 对齐，可用尺寸不小于请求，内容可读写
+TEST(MallocApiTest, MallocFreeRoundTrip) {
+    for (std::size_t sz : {0u, 1u, 15u, 16u, 100u, 4000u, 70000u}) {
+        void* p = gc_malloc(sz);
+        ASSERT_NE(p, nullptr) << "sz=" << sz;
+        EXPECT_TRUE(IsAligned(p, 16)) << "sz=" << sz;
+        EXPECT_GE(gc_malloc_usable_size(p), sz);
+        std::memset(p, 0xAB, sz);
+        gc_free(p);
+    }
+    gc_free(nullptr);
+}
+
+// 用户写满整块不能破坏块头：释放后 GC 仍能正常回收
+TEST(MallocApiTest, UserWritesDoNotCorruptBlockHeader) {
+    std::vector<void*> blocks;
+    for (int i = 0; i < 64; ++i) {
+        void* p = gc_malloc(48);
+        ASSERT_NE(p, nullptr);
+        std::memset(p, 0xFF, gc_malloc_usable_size(p));
+        blocks.push_back(p);
+    }
+    // 跨线程释放只登记请求，由本线程 GC 回收
+    std::thread([&blocks] {
+        for (void* p : blocks) gc_free(p);
+    }).join();
+    EXPECT_GE(ThreadHeap::garbageCollect(), blocks.size());
+}
+
+TEST(MallocApiTest, CallocZeroesAndDetectsOverflow) {
+    // 先弄脏一块再释放，增加 calloc 拿到旧内容的机会
+    void* dirty = gc_malloc(256);
+    ASSERT_NE(dirty, nullptr);
+    std::memset(dirty, 0x5A, 256);
+    gc_free(dirty);
+
+    auto* p = static_cast<unsigned char*>(gc_calloc(16, 16));
+    ASSERT_NE(p, nullptr);
+    for (int i = 0; i < 256; ++i) EXPECT_EQ(p[i], 0) << "i=" << i;
+    gc_free(p);
+
+    errno = 0;
+    EXPECT_EQ(gc_calloc(SIZE_MAX / 2, 4), nullptr);
+    EXPECT_EQ(errno, ENOMEM);
+}
+
+TEST(MallocApiTest, ReallocPreservesContents) {
+    EXPECT_EQ(gc_realloc(nullptr, 0) != nullptr, true);  // 等价于 malloc(0)
+
+    auto* p = static_cast<unsigned char*>(gc_malloc(40));
+    ASSERT_NE(p, nullptr);
+    for (int i = 0; i < 40; ++i) p[i] = static_cast<unsigned char>(i);
+
+    // 原块放得下：原地返回
+    EXPECT_EQ(gc_realloc(p, 8), p);
+
+    auto* q = static_cast<unsigned char*>(gc_realloc(p, 5000));
+    ASSERT_NE(q, nullptr);
+    EXPECT_GE(gc_malloc_usable_size(q), 5000u);
+    for (int i = 0; i < 40; ++i) EXPECT_EQ(q[i], i);
+
+    EXPECT_EQ(gc_realloc(q, 0), nullptr);  // 等价于 free
+}
+
+TEST(MallocApiTest, AlignedVariants) {
+    for (std::size_t a : {8u, 16u, 32u, 64u, 256u, 4096u, 65536u}) {
+        void* p = nullptr;
+        ASSERT_EQ(gc_posix_memalign(&p, a, 100), 0) << "a=" << a;
+        EXPECT_TRUE(IsAligned(p, a)) << "a=" << a;
+        EXPECT_GE(gc_malloc_usable_size(p), 100u);
+        std::memset(p, 0, 100);
+        gc_free(p);
+
+        void* q = gc_aligned_alloc(a, 3 * a);
+        ASSERT_NE(q, nullptr);
+        EXPECT_TRUE(IsAligned(q, a));
+        gc_free(q);
+    }
+
+    void* r = gc_memalign(48, 10);  // 非 2 的幂：向上取整为 64
+    ASSERT_NE(r, nullptr);
+    EXPECT_TRUE(IsAligned(r, 64));
+    gc_free(r);
+
+    void* v = gc_valloc(10);
+    ASSERT_NE(v, nullptr);
+    EXPECT_TRUE(IsAligned(v, 4096));
+    gc_free(v);
+
+    void* bad = nullptr;
+    EXPECT_EQ(gc_posix_memalign(&bad, 24, 8), EINVAL);
+    EXPECT_EQ(gc_posix_memalign(&bad, 4, 8), EINVAL);
+    EXPECT_EQ(bad, nullptr);
+}
+
+// 超过小对象上限的请求走大对象路径，尺寸不再受单个 chunk 限制
+TEST(MallocApiTest, LargeAllocation) {
+    ManualGcScope manual_gc;
+    for (std::size_t sz : {1536u * 1024u, 5u * 1024u * 1024u, 64u * 1024u * 1024u}) {
+        auto* p = static_cast<unsigned char*>(gc_malloc(sz));
+        ASSERT_NE(p, nullptr) << "sz=" << sz;
+        EXPECT_GE(gc_malloc_usable_size(p), sz);
+        p[0] = 1;
+        p[sz - 1] = 2;
+        gc_free(p);
+    }
+    // 先收掉这三块：后面第一次小对象分配会在补充子池前自动清扫
+    std::size_t reclaimed = ThreadHeap::garbageCollect();
+
+    auto* q = static_cast<unsigned char*>(gc_realloc(gc_malloc(100), 8u * 1024u * 1024u));
+    ASSERT_NE(q, nullptr);
+    q[8u * 1024u * 1024u - 1] = 3;
+    gc_free(q);
+
+    void* a = nullptr;
+    ASSERT_EQ(gc_posix_memalign(&a, 512 * 1024, 3u * 1024u * 1024u), 0);
+    EXPECT_TRUE(IsAligned(a, 512 * 1024));
+    EXPECT_GE(gc_malloc_usable_size(a), 3u * 1024u * 1024u);
+    gc_free(a);
+
+    reclaimed += ThreadHeap::garbageCollect();
+    EXPECT_GE(reclaimed, 5u);
+}
+
+// PageMap 可以识别外来指针：释放它们被忽略，而不是破坏堆
+TEST(MallocApiTest, ForeignPointersAreRejected) {
+    int on_stack = 0;
+    static int in_data = 0;
+
+    EXPECT_EQ(gc_malloc_usable_size(&on_stack), 0u);
+    EXPECT_EQ(gc_malloc_usable_size(&in_data), 0u);
+    gc_free(&on_stack);
+    gc_free(&in_data);
+
+    void* p = gc_malloc(100);
+    ASSERT_NE(p, nullptr);
+    EXPECT_GE(gc_malloc_usable_size(p), 100u);
+    gc_free(p);
+}
+
+// 对齐不再受单个 chunk 限制：对齐位置可以落在大对象映射的后续 chunk 中
+TEST(MallocApiTest, AlignmentBeyondOneChunk) {
+    ManualGcScope manual_gc;
+    for (std::size_t align : {std::size_t{4} << 20, std::size_t{16} << 20}) {
+        void* p = nullptr;
+        ASSERT_EQ(gc_posix_memalign(&p, align, 4096), 0) << "align=" << align;
+        EXPECT_TRUE(IsAligned(p, align));
+        EXPECT_GE(gc_malloc_usable_size(p), 4096u);
+        static_cast<char*>(p)[4095] = 1;
+        gc_free(p);
+    }
+    EXPECT_GE(ThreadHeap::garbageCollect(), 2u);
+}
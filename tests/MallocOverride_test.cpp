@@ -0,0 +1,132 @@
+#include "gtest/gtest.h"
+
+#include <dlfcn.h>
+#include <malloc.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 本测试程序链接了 libgc_malloc.so：确认 malloc 族确实由它提供
+TEST(MallocOverrideTest, SymbolsResolveToGcMalloc) {
+    for (const char* name : {"malloc", "free", "calloc", "realloc", "reallocarray", "cfree",
+                             "posix_memalign", "aligned_alloc", "memalign", "valloc", "pvalloc",
+                             "malloc_usable_size"}) {
+        void* sym = dlsym(RTLD_DEFAULT, name);
+        ASSERT_NE(sym, nullptr) << name;
+
+        Dl_info info{};
+        ASSERT_NE(dladdr(sym, &info), 0) << name;
+        ASSERT_NE(info.dli_fname, nullptr) << name;
+        EXPECT_NE(std::strstr(info.dli_fname, "libgc_malloc"), nullptr)
+            << name << " resolved to " << info.dli_fname;
+    }
+}
+
+TEST(MallocOverrideTest, MallocFamilyWorks) {
+    void* p = std::malloc(100);
+    ASSERT_NE(p, nullptr);
+    EXPECT_GE(malloc_usable_size(p), 100u);
+
+    p = std::realloc(p, 10000);
+    ASSERT_NE(p, nullptr);
+    EXPECT_GE(malloc_usable_size(p), 10000u);
+    std::free(p);
+
+    auto* z = static_cast<unsigned char*>(std::calloc(64, 8));
+    ASSERT_NE(z, nullptr);
+    for (int i = 0; i < 512; ++i) ASSERT_EQ(z[i], 0);
+    std::free(z);
+
+    void* a = nullptr;
+    ASSERT_EQ(posix_memalign(&a, 128, 1000), 0);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a) % 128, 0u);
+    std::free(a);
+
+    void* v = valloc(1);
+    ASSERT_NE(v, nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(v) % 4096, 0u);
+    std::free(v);
+}
+
+TEST(MallocOverrideTest, ReallocarrayPvallocAndCfree) {
+    auto* a = static_cast<int*>(reallocarray(nullptr, 100, sizeof(int)));
+    ASSERT_NE(a, nullptr);
+    for (int i = 0; i < 100; ++i) a[i] = i;
+    a = static_cast<int*>(reallocarray(a, 5000, sizeof(int)));
+    ASSERT_NE(a, nullptr);
+    EXPECT_GE(malloc_usable_size(a), 5000 * sizeof(int));
+    for (int i = 0; i < 100; ++i) ASSERT_EQ(a[i], i);
+
+    // 乘法溢出：返回空指针、置 ENOMEM，原块不受影响
+    volatile std::size_t huge = SIZE_MAX / 2 + 1;   // 避免编译期折叠出超限常量而告警
+    errno = 0;
+    EXPECT_EQ(reallocarray(a, huge, 2), nullptr);
+    EXPECT_EQ(errno, ENOMEM);
+    EXPECT_EQ(a[99], 99);
+    std::free(a);
+
+    // pvalloc：页对齐，大小向上取整到整页，0 字节也给一页
+    for (std::size_t size : {std::size_t{0}, std::size_t{1}, std::size_t{4097}}) {
+        void* p = pvalloc(size);
+        ASSERT_NE(p, nullptr) << size;
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % 4096, 0u) << size;
+        const std::size_t pages = (size == 0) ? 1 : (size + 4095) / 4096;
+        EXPECT_GE(malloc_usable_size(p), pages * 4096) << size;
+        std::memset(p, 0xab, pages * 4096);
+        std::free(p);
+    }
+    errno = 0;
+    EXPECT_EQ(pvalloc(SIZE_MAX - 100), nullptr);
+    EXPECT_EQ(errno, ENOMEM);
+
+    // cfree 不再由 glibc 头文件声明，经 dlsym 取本库导出的版本
+    using CfreeFn = void (*)(void*);
+    auto cfree_fn = reinterpret_cast<CfreeFn>(dlsym(RTLD_DEFAULT, "cfree"));
+    ASSERT_NE(cfree_fn, nullptr);
+    cfree_fn(std::malloc(64));
+    cfree_fn(nullptr);
+}
+
+struct alignas(256) OverAligned {
+    char bytes[256];
+};
+
+TEST(MallocOverrideTest, GlobalNewDelete) {
+    auto* s = new std::string(1000, 'x');
+    EXPECT_GE(malloc_usable_size(const_cast<char*>(s->data())), 1000u);
+    delete s;
+
+    auto arr = std::make_unique<int[]>(4096);
+    arr[4095] = 7;
+    EXPECT_EQ(arr[4095], 7);
+
+    auto* o = new OverAligned[3];
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(o) % alignof(OverAligned), 0u);
+    delete[] o;
+}
+
+// 线程创建/退出本身会调用 malloc/free，也覆盖了线程退出时 ThreadHeap 的回收路径
+TEST(MallocOverrideTest, ManyShortLivedThreads) {
+    std::atomic<int> ok{0};
+    for (int round = 0; round < 8; ++round) {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&ok] {
+                std::vector<std::unique_ptr<char[]>> v;
+                for (int i = 0; i < 200; ++i) {
+                    v.emplace_back(new char[16 + i * 8]);
+                }
+                ok.fetch_add(1);
+            });
+        }
+        for (auto& th : threads) th.join();
+    }
+    EXPECT_EQ(ok.load(), 64);
+}
@@ -160,3 +160,93 @@ TEST(ManagedListTest, ReclaimHeadAndTailCorrectlyUpdatePointers) {
 
     destroy_blocks(blocks);
 }
+
+// append 只挂链、不改状态：已是 Free 的节点在下一次遍历中仍会被摘除
+TEST(ManagedListTest, AppendKeepsState) {
+    ManagedList ml;
+    auto blocks = make_blocks(2, BlockState::Free);
+
+    ml.appendUsed(blocks[0]);
+    ml.append(blocks[1]);
+    EXPECT_EQ(blocks[0]->loadState(), BlockState::Used);
+    EXPECT_EQ(blocks[1]->loadState(), BlockState::Free);
+    EXPECT_EQ(ml.tail(), blocks[1]);
+
+    ml.resetCursor();
+    EXPECT_EQ(ml.reclaimNextFree(), blocks[1]);
+    EXPECT_EQ(ml.reclaimNextFree(), nullptr);
+    EXPECT_EQ(ml.head(), blocks[0]);
+    EXPECT_EQ(ml.tail(), blocks[0]);
+
+    destroy_blocks(blocks);
+}
+
+TEST(ManagedListTest, SweepCursorResumesAcrossCallsAndWraps) {
+    ManagedList ml;
+    auto blocks = make_blocks(10, BlockState::Free);
+    for (auto* b : blocks) ml.appendUsed(b);
+    blocks[1]->storeFree();
+    blocks[8]->storeFree();
+
+    std::size_t visited = 0;
+    EXPECT_EQ(ml.sweepNextFree(3, &visited), blocks[1]);
+    EXPECT_EQ(visited, 2u);
+    EXPECT_EQ(ml.sweepNextFree(3, &visited), nullptr);   // 预算用完，停在 blocks[5]
+    EXPECT_EQ(visited, 5u);
+    EXPECT_TRUE(ml.passInProgress());
+    EXPECT_EQ(ml.epoch(), 0u);
+
+    // 本轮中途尾插的节点留给下一轮
+    auto extra = make_blocks(1, BlockState::Free);
+    ml.append(extra[0]);
+    EXPECT_EQ(ml.sweepNextFree(10, &visited), blocks[8]);
+    EXPECT_EQ(ml.sweepNextFree(10, &visited), nullptr);   // 走到本轮开始时的表尾：一轮完成
+    EXPECT_EQ(visited, 10u);
+    EXPECT_FALSE(ml.passInProgress());
+    EXPECT_EQ(ml.epoch(), 1u);
+    EXPECT_EQ(ml.passVisited(), 10u);
+    EXPECT_EQ(ml.size(), 9u);
+
+    // 下一次调用回绕到表头，上一轮尾插的节点在这一轮被访问
+    blocks[0]->storeFree();
+    EXPECT_EQ(ml.sweepNextFree(1, &visited), blocks[0]);
+    EXPECT_TRUE(ml.passInProgress());
+    EXPECT_EQ(ml.passSize(), 9u);
+    EXPECT_EQ(ml.head(), blocks[2]);
+    EXPECT_EQ(ml.sweepNextFree(10, &visited), extra[0]);
+
+    destroy_blocks(blocks);
+    destroy_blocks(extra);
+}
+
+TEST(ManagedListTest, SweepOnEmptyListCompletesPass) {
+    ManagedList ml;
+    EXPECT_EQ(ml.sweepNextFree(8), nullptr);
+    EXPECT_EQ(ml.epoch(), 1u);
+    EXPECT_FALSE(ml.passInProgress());
+}
+
+TEST(ManagedListTest, NodesReappendedDuringPassDoNotExtendIt) {
+    ManagedList ml;
+    auto blocks = make_blocks(4, BlockState::Free);
+    for (auto* b : blocks) ml.appendUsed(b);
+
+    // 模拟清扫中仍有在用块的子池：每次摘下后立即被远端释放置回 Free 并挂回表尾
+    blocks[1]->storeFree();
+    std::size_t returned = 0;
+    const uint64_t epoch = ml.epoch();
+    while (ml.epoch() == epoch) {
+        BlockHeader* node = ml.sweepNextFree(SIZE_MAX);
+        if (!node) continue;
+        ++returned;
+        ASSERT_LE(returned, 4u) << "the pass keeps revisiting re-appended nodes";
+        ml.append(node);
+        node->storeFree();
+    }
+    EXPECT_EQ(returned, 1u);
+    EXPECT_EQ(ml.passVisited(), 4u);
+    EXPECT_EQ(ml.size(), 4u);
+    EXPECT_EQ(ml.tail(), blocks[1]);
+
+    destroy_blocks(blocks);
+}
@@ -3,6 +3,7 @@
 #include <vector>
 #include <thread>
 #include <numeric> // for std::iota
+#include <cstring>
 
 // 创建一个测试夹具(Test Fixture)来管理内存池的生命周期
 class MemSubPoolTest : public ::testing::Test {
@@ -44,6 +45,35 @@ TEST_F(MemSubPoolTest, InitialStateIsCorrect) {
     EXPECT_FALSE(pool_->isFull());
 }
 
+// 子池头部记录所属 size-class；未指定时为 kNoSizeClass
+TEST_F(MemSubPoolTest, RecordsSizeClass) {
+    EXPECT_EQ(pool_->getSizeClass(), MemSubPool::kNoSizeClass);
+
+    void* raw = ::operator new(MemSubPool::kPoolTotalSize, std::align_val_t(MemSubPool::kPoolAlignment));
+    auto* classified = new (raw) MemSubPool(block_size_, 7);
+    EXPECT_EQ(classified->getSizeClass(), 7u);
+    classified->~MemSubPool();
+    ::operator delete(raw, std::align_val_t(MemSubPool::kPoolAlignment));
+}
+
+// 批量释放：一次加锁释放多个块
+TEST_F(MemSubPoolTest, ReleaseBatchFreesAllBlocks) {
+    std::vector<void*> blocks;
+    for (int i = 0; i < 10; ++i) {
+        void* b = pool_->allocate();
+        ASSERT_NE(b, nullptr);
+        blocks.push_back(b);
+    }
+
+    pool_->releaseBatch(blocks.data(), 4);
+    EXPECT_FALSE(pool_->isEmpty());
+    pool_->releaseBatch(blocks.data() + 4, blocks.size() - 4);
+    EXPECT_TRUE(pool_->isEmpty());
+
+    // 释放后的块可以被重新分配
+    EXPECT_NE(pool_->allocate(), nullptr);
+}
+
 // 测试基本的分配和释放功能
 TEST_F(MemSubPoolTest, HandlesSingleAllocationAndRelease) {
     ASSERT_TRUE(pool_->isEmpty());
@@ -92,39 +122,244 @@ TEST_F(MemSubPoolTest, HandlesFullAllocation) {
     EXPECT_FALSE(pool_->isFull());
 }
 
-// 一个非常简单的多线程测试，检查是否有数据竞争问题
+// 所属线程分配，其他线程并发释放：非所属线程的 release 转为释放请求，清扫后全部回收
 TEST_F(MemSubPoolTest, IsThreadSafe) {
     const size_t num_threads = 8;
     // 分配数量要足够小，确保池不会被填满
-    const size_t allocations_per_thread = 50; 
-    
-    auto worker_task = [this]() {
-        std::vector<void*> local_blocks;
-        local_blocks.reserve(allocations_per_thread);
-        
-        // 分配阶段
+    const size_t allocations_per_thread = 50;
+
+    std::vector<std::vector<void*>> per_thread(num_threads);
+    for (auto& blocks : per_thread) {
         for (size_t j = 0; j < allocations_per_thread; ++j) {
             void* block = pool_->allocate();
-            if (block) {
-                local_blocks.push_back(block);
-            }
+            ASSERT_NE(block, nullptr);
+            blocks.push_back(block);
         }
-        
+    }
+
+    auto worker_task = [this](const std::vector<void*>& blocks) {
+        // 非所属线程不能从子池分配
+        EXPECT_EQ(pool_->allocate(), nullptr);
+        EXPECT_EQ(pool_->sweepFreeRequested(), 0u);
+
         // 释放阶段
-        for (void* block : local_blocks) {
+        for (void* block : blocks) {
             pool_->release(block);
         }
     };
 
     std::vector<std::thread> threads;
     for (size_t i = 0; i < num_threads; ++i) {
-        threads.emplace_back(worker_task);
+        threads.emplace_back(worker_task, std::cref(per_thread[i]));
     }
     
     for (auto& t : threads) {
         t.join();
     }
 
-    // 所有线程结束后，内存池应该 kembali为空
+    EXPECT_FALSE(pool_->isEmpty());
+    EXPECT_EQ(pool_->sweepFreeRequested(), num_threads * allocations_per_thread);
     EXPECT_TRUE(pool_->isEmpty()) << "Pool should be empty after all threads finished.";
-}
\ No newline at end of file
+}
+
+// 所有权移交：原所属线程停止访问后，新线程接管即可不加锁地分配与清扫
+TEST_F(MemSubPoolTest, AdoptTransfersOwnership) {
+    void* a = pool_->allocate();
+    ASSERT_NE(a, nullptr);
+    EXPECT_TRUE(pool_->isOwnedByCurrentThread());
+
+    std::thread([this, a] {
+        EXPECT_FALSE(pool_->isOwnedByCurrentThread());
+        pool_->adoptByCurrentThread();
+        EXPECT_TRUE(pool_->isOwnedByCurrentThread());
+        EXPECT_NE(pool_->allocate(), nullptr);
+        pool_->release(a);
+    }).join();
+
+    EXPECT_FALSE(pool_->isOwnedByCurrentThread());
+    EXPECT_EQ(pool_->allocate(), nullptr);
+    pool_->adoptByCurrentThread();
+    EXPECT_EQ(pool_->allocate(), a);
+}
+
+// 带外释放请求：只置位不改占用位图，清扫时整字回收；重复请求被拒绝
+TEST_F(MemSubPoolTest, SweepReclaimsFreeRequestedBlocks) {
+    void* a = pool_->allocate();
+    void* b = pool_->allocate();
+    void* c = pool_->allocate();
+    ASSERT_NE(c, nullptr);
+
+    EXPECT_TRUE(pool_->requestFree(a));
+    EXPECT_TRUE(pool_->requestFree(c));
+    EXPECT_FALSE(pool_->requestFree(c));
+    EXPECT_FALSE(pool_->requestFree(static_cast<char*>(b) + 1));
+    EXPECT_TRUE(pool_->isFreeRequested(a));
+    EXPECT_FALSE(pool_->isFreeRequested(b));
+    EXPECT_EQ(pool_->managed_node.loadState(), BlockState::Free);
+
+    EXPECT_EQ(pool_->sweepFreeRequested(), 2u);
+    EXPECT_EQ(pool_->managed_node.loadState(), BlockState::Used);
+    EXPECT_FALSE(pool_->isFreeRequested(a));
+    EXPECT_FALSE(pool_->isEmpty());
+    EXPECT_EQ(pool_->sweepFreeRequested(), 0u);
+
+    void* d = pool_->allocate();
+    ASSERT_NE(d, nullptr);
+
+    EXPECT_TRUE(pool_->requestFree(b));
+    EXPECT_TRUE(pool_->requestFree(d));
+    EXPECT_EQ(pool_->sweepFreeRequested(), 2u);
+    EXPECT_TRUE(pool_->isEmpty());
+}
+
+// 近乎满载时释放的块（无论位置）都能被下一次分配直接找到，且总是取地址最低的空闲块
+TEST_F(MemSubPoolTest, NearlyFullPoolFindsAnyFreedBlock) {
+    std::vector<void*> blocks;
+    while (void* p = pool_->allocate()) blocks.push_back(p);
+    ASSERT_TRUE(pool_->isFull());
+    ASSERT_GT(blocks.size(), 1000u);
+
+    const std::size_t late = blocks.size() - 3;
+    const std::size_t early = 200;
+    pool_->release(blocks[late]);
+    pool_->release(blocks[early]);
+
+    EXPECT_EQ(pool_->allocate(), blocks[early]);
+    EXPECT_EQ(pool_->allocate(), blocks[late]);
+    EXPECT_EQ(pool_->allocate(), nullptr);
+
+    // 清扫路径同样更新摘要
+    ASSERT_TRUE(pool_->requestFree(blocks[0]));
+    EXPECT_EQ(pool_->sweepFreeRequested(), 1u);
+    EXPECT_EQ(pool_->allocate(), blocks[0]);
+
+    for (void* p : blocks) pool_->release(p);
+    EXPECT_TRUE(pool_->isEmpty());
+}
+
+// 批量分配：按地址升序整字领取；批量释放请求：同字合并，清扫后全部回收
+TEST_F(MemSubPoolTest, AllocateBatchAndRequestFreeBatch) {
+    void* first = pool_->allocate();
+    ASSERT_NE(first, nullptr);
+
+    void* batch[100] = {};
+    ASSERT_EQ(pool_->allocateBatch(batch, 100), 100u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(static_cast<char*>(batch[i]), static_cast<char*>(first) + (i + 1) * block_size_);
+    }
+    EXPECT_EQ(pool_->allocateBatch(batch, 0), 0u);
+
+    EXPECT_EQ(pool_->requestFreeBatch(batch, 100), 100u);
+    EXPECT_TRUE(pool_->isFreeRequested(batch[63]));
+    EXPECT_EQ(pool_->managed_node.loadState(), BlockState::Free);
+    EXPECT_EQ(pool_->sweepFreeRequested(), 100u);
+
+    pool_->release(first);
+    EXPECT_TRUE(pool_->isEmpty());
+}
+
+// 新子池处于 bump 模式：顺序切块，已释放的块优先于推进 bump 被复用
+TEST_F(MemSubPoolTest, BumpAllocatesSequentiallyAndReusesFreedFirst) {
+    EXPECT_EQ(pool_->getBumpIndex(), 0u);
+
+    void* blocks[10] = {};
+    for (int i = 0; i < 10; ++i) {
+        blocks[i] = pool_->allocate();
+        ASSERT_NE(blocks[i], nullptr);
+        EXPECT_EQ(static_cast<char*>(blocks[i]), static_cast<char*>(blocks[0]) + i * block_size_);
+    }
+    EXPECT_EQ(pool_->getBumpIndex(), 10u);
+
+    // bump 之上的块从未分配过：释放请求被拒绝
+    void* never = static_cast<char*>(blocks[9]) + block_size_;
+    EXPECT_FALSE(pool_->requestFree(never));
+
+    pool_->release(blocks[4]);
+    EXPECT_EQ(pool_->allocate(), blocks[4]);
+    EXPECT_EQ(pool_->getBumpIndex(), 10u);
+
+    // 批量分配：先取复用的块，再从 bump 处接着切
+    pool_->release(blocks[2]);
+    void* batch[3] = {};
+    ASSERT_EQ(pool_->allocateBatch(batch, 3), 3u);
+    EXPECT_EQ(batch[0], blocks[2]);
+    EXPECT_EQ(batch[1], never);
+    EXPECT_EQ(pool_->getBumpIndex(), 12u);
+
+    for (void* p : batch) pool_->release(p);
+    for (int i = 0; i < 10; ++i) {
+        if (i != 2) pool_->release(blocks[i]);
+    }
+    EXPECT_TRUE(pool_->isEmpty());
+}
+
+// 全部块释放（直接释放或清扫）后子池回到 bump 模式
+TEST_F(MemSubPoolTest, EmptyPoolReturnsToBumpMode) {
+    void* a = pool_->allocate();
+    void* b = pool_->allocate();
+    pool_->release(a);
+    EXPECT_EQ(pool_->getBumpIndex(), 2u);
+    pool_->release(b);
+    EXPECT_EQ(pool_->getBumpIndex(), 0u);
+    EXPECT_EQ(pool_->allocate(), a);
+
+    ASSERT_TRUE(pool_->requestFree(a));
+    EXPECT_EQ(pool_->sweepFreeRequested(), 1u);
+    EXPECT_EQ(pool_->getBumpIndex(), 0u);
+    EXPECT_TRUE(pool_->isEmpty());
+}
+
+// 构造时不清零位图：在写满垃圾的内存上构造的子池行为与全新内存一致
+TEST(MemSubPoolBumpTest, ConstructsOnDirtyMemory) {
+    void* raw = ::operator new(MemSubPool::kPoolTotalSize,
+                               std::align_val_t(MemSubPool::kPoolAlignment));
+    std::memset(raw, 0xFF, MemSubPool::kPoolTotalSize);
+    MemSubPool* pool = new (raw) MemSubPool(64);
+
+    std::vector<void*> blocks;
+    while (void* p = pool->allocate()) blocks.push_back(p);
+    ASSERT_TRUE(pool->isFull());
+    for (std::size_t i = 1; i < blocks.size(); ++i) {
+        ASSERT_EQ(static_cast<char*>(blocks[i]), static_cast<char*>(blocks[0]) + i * 64);
+    }
+    EXPECT_FALSE(pool->isFreeRequested(blocks[0]));
+
+    ASSERT_EQ(pool->requestFreeBatch(blocks.data(), blocks.size()), blocks.size());
+    EXPECT_EQ(pool->sweepFreeRequested(), blocks.size());
+    EXPECT_TRUE(pool->isEmpty());
+
+    pool->~MemSubPool();
+    ::operator delete(raw, std::align_val_t(MemSubPool::kPoolAlignment));
+}
+
+// 远程释放栈：满池上其他线程的释放在所属线程分配耗尽时被一次取回
+TEST_F(MemSubPoolTest, FullPoolDrainsRemoteFreesOnAllocate) {
+    std::vector<void*> blocks;
+    while (void* p = pool_->allocate()) blocks.push_back(p);
+    ASSERT_TRUE(pool_->isFull());
+    EXPECT_FALSE(pool_->hasRemoteFrees());
+
+    std::thread([&] {
+        pool_->release(blocks[5]);
+        pool_->release(blocks[500]);
+        pool_->release(blocks[501]);
+    }).join();
+    EXPECT_TRUE(pool_->hasRemoteFrees());
+    EXPECT_TRUE(pool_->isFull());   // 尚未取回
+
+    void* out[4] = {};
+    EXPECT_EQ(pool_->allocateBatch(out, 4), 3u);
+    EXPECT_FALSE(pool_->hasRemoteFrees());
+    EXPECT_EQ(out[0], blocks[5]);
+    EXPECT_EQ(out[1], blocks[500]);
+    EXPECT_EQ(out[2], blocks[501]);
+
+    // 已取回的字再次被释放时会重新入栈
+    std::thread([&] { pool_->release(blocks[5]); }).join();
+    EXPECT_EQ(pool_->sweepFreeRequested(), 1u);
+    EXPECT_FALSE(pool_->hasRemoteFrees());
+
+    blocks[5] = nullptr;
+    pool_->releaseBatch(blocks.data(), blocks.size());
+    EXPECT_TRUE(pool_->isEmpty());
+}
@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+#include "gc_malloc/CentralHeap/PageMap.hpp"
+
+#include <cstdint>
+
+namespace {
+
+constexpr std::uintptr_t kChunk = std::uintptr_t{1} << PageMap::kChunkShift;
+
+// PageMap 只记账，不访问被登记的地址；用远离真实映射的假地址即可
+void* FakeChunk(std::uintptr_t n) {
+    return reinterpret_cast<void*>((std::uintptr_t{0x7A0000} + n) * kChunk);
+}
+
+ThreadHeap* FakeOwner() {
+    return reinterpret_cast<ThreadHeap*>(std::uintptr_t{0x1000});
+}
+
+} // namespace
+
+TEST(PageMapTest, UnregisteredPointersResolveToNone) {
+    PageMap& map = PageMap::GetInstance();
+
+    int on_stack = 0;
+    EXPECT_EQ(map.lookup(&on_stack).kind, ChunkKind::kNone);
+    EXPECT_EQ(map.lookup(nullptr).kind, ChunkKind::kNone);
+    // 超出 48 位用户地址空间
+    EXPECT_EQ(map.lookup(reinterpret_cast<void*>(~std::uintptr_t{0})).kind, ChunkKind::kNone);
+}
+
+TEST(PageMapTest, SetLookupClear) {
+    PageMap& map = PageMap::GetInstance();
+    char* chunk = static_cast<char*>(FakeChunk(1));
+
+    PageMapEntry entry;
+    entry.kind       = ChunkKind::kSmallPool;
+    entry.size_class = 42;
+    entry.base       = chunk;
+    entry.owner      = FakeOwner();
+    ASSERT_TRUE(map.set(chunk, 1, entry));
+
+    // chunk 内任意位置（含内部指针）都解析到同一表项
+    for (std::uintptr_t off : {std::uintptr_t{0}, std::uintptr_t{12345}, kChunk - 1}) {
+        const PageMapEntry got = map.lookup(chunk + off);
+        EXPECT_EQ(got.kind, ChunkKind::kSmallPool);
+        EXPECT_EQ(got.size_class, 42);
+        EXPECT_EQ(got.base, chunk);
+        EXPECT_EQ(got.owner, FakeOwner());
+    }
+    // 相邻 chunk 不受影响
+    EXPECT_EQ(map.lookup(chunk + kChunk).kind, ChunkKind::kNone);
+
+    map.clear(chunk, 1);
+    EXPECT_EQ(map.lookup(chunk).kind, ChunkKind::kNone);
+    EXPECT_EQ(map.lookup(chunk).owner, nullptr);
+}
+
+TEST(PageMapTest, MultiChunkSpanSharesOneBase) {
+    PageMap& map = PageMap::GetInstance();
+    char* span = static_cast<char*>(FakeChunk(100));
+
+    PageMapEntry entry;
+    entry.kind  = ChunkKind::kLargeObject;
+    entry.base  = span;
+    entry.owner = FakeOwner();
+    ASSERT_TRUE(map.set(span, 5, entry));
+
+    for (std::uintptr_t i = 0; i < 5; ++i) {
+        const PageMapEntry got = map.lookup(span + i * kChunk + 7);
+        EXPECT_EQ(got.kind, ChunkKind::kLargeObject);
+        EXPECT_EQ(got.base, span);
+    }
+    EXPECT_EQ(map.lookup(span + 5 * kChunk).kind, ChunkKind::kNone);
+
+    map.clear(span, 5);
+    for (std::uintptr_t i = 0; i < 5; ++i) {
+        EXPECT_EQ(map.lookup(span + i * kChunk).kind, ChunkKind::kNone);
+    }
+}
+
+// 跨越叶子边界的登记：两个叶子都会按需建立
+TEST(PageMapTest, SpanCrossingLeafBoundary) {
+    PageMap& map = PageMap::GetInstance();
+    const std::uintptr_t leaf_span = std::uintptr_t{1} << PageMap::kLeafBits;
+    char* span = static_cast<char*>(FakeChunk(leaf_span * 3 - 1));
+
+    PageMapEntry entry;
+    entry.kind = ChunkKind::kMediumRun;
+    entry.base = span;
+    ASSERT_TRUE(map.set(span, 2, entry));
+    EXPECT_EQ(map.lookup(span).kind, ChunkKind::kMediumRun);
+    EXPECT_EQ(map.lookup(span + kChunk).kind, ChunkKind::kMediumRun);
+    EXPECT_EQ(map.lookup(span + kChunk).owner, nullptr);
+
+    map.clear(span, 2);
+    EXPECT_EQ(map.lookup(span + kChunk).kind, ChunkKind::kNone);
+}
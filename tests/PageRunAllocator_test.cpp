@@ -0,0 +1,223 @@
+#include "gtest/gtest.h"
+#include "gc_malloc/CentralHeap/PageRunAllocator.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t kPage = PageRunAllocator::kPageSize;
+
+// 用 aligned_alloc 模拟 CentralHeap 提供的 2MB 对齐 chunk，并统计交还次数
+struct FakeCentral {
+    size_t refills = 0;
+    size_t returns = 0;
+
+    static void* refill(void* ctx) noexcept {
+        auto* self = static_cast<FakeCentral*>(ctx);
+        ++self->refills;
+        return std::aligned_alloc(PageRunChunk::kChunkSize, PageRunChunk::kChunkSize);
+    }
+    static void giveBack(void* ctx, void* chunk) noexcept {
+        auto* self = static_cast<FakeCentral*>(ctx);
+        ++self->returns;
+        std::free(chunk);
+    }
+};
+
+class PageRunAllocatorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        alloc_.setRefillCallback(&FakeCentral::refill, &central_);
+        alloc_.setReturnCallback(&FakeCentral::giveBack, &central_);
+    }
+
+    FakeCentral central_;
+    PageRunAllocator alloc_;
+};
+
+} // namespace
+
+TEST_F(PageRunAllocatorTest, AllocateReturnsPageAlignedRun) {
+    char* run = static_cast<char*>(alloc_.allocate(3));
+    ASSERT_NE(run, nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(run) % kPage, 0u);
+
+    EXPECT_EQ(alloc_.getChunkCount(), 1u);
+    EXPECT_EQ(alloc_.getFreePages(), PageRunAllocator::kMaxRunPages - 3);
+
+    EXPECT_EQ(PageRunAllocator::runBytes(run), 3 * kPage);
+    EXPECT_EQ(PageRunAllocator::runOf(run + 2 * kPage + 17), run);
+    EXPECT_EQ(PageRunAllocator::runOf(run + 3 * kPage), nullptr);   // 空闲页不属于任何段
+
+    run[0] = 1;
+    run[3 * kPage - 1] = 2;
+    alloc_.release(run);
+    EXPECT_EQ(alloc_.getFreePages(), PageRunAllocator::kMaxRunPages);
+}
+
+TEST_F(PageRunAllocatorTest, RejectsInvalidRequests) {
+    EXPECT_EQ(alloc_.allocate(0), nullptr);
+    EXPECT_EQ(alloc_.allocate(PageRunAllocator::kMaxRunPages + 1), nullptr);
+    EXPECT_EQ(central_.refills, 0u);
+
+    EXPECT_EQ(PageRunAllocator::runOf(nullptr), nullptr);
+    EXPECT_EQ(PageRunAllocator::runBytes(nullptr), 0u);
+}
+
+TEST_F(PageRunAllocatorTest, BestFitPicksSmallestSufficientHole) {
+    void* a = alloc_.allocate(10);
+    void* s1 = alloc_.allocate(1);
+    void* c = alloc_.allocate(4);
+    void* s2 = alloc_.allocate(1);
+    ASSERT_TRUE(a && s1 && c && s2);
+
+    // 留下 10 页与 4 页两个洞（外加 chunk 尾部的大段）
+    alloc_.release(a);
+    alloc_.release(c);
+
+    void* d = alloc_.allocate(3);
+    EXPECT_EQ(d, c) << "3 pages should come from the 4-page hole";
+    void* e = alloc_.allocate(6);
+    EXPECT_EQ(e, a) << "6 pages should come from the 10-page hole";
+
+    for (void* p : {s1, s2, d, e}) alloc_.release(p);
+    EXPECT_EQ(alloc_.getFreePages(), PageRunAllocator::kMaxRunPages);
+    EXPECT_EQ(alloc_.getChunkCount(), 1u);
+}
+
+TEST_F(PageRunAllocatorTest, FreeRunsCoalesce) {
+    void* a = alloc_.allocate(100);
+    void* b = alloc_.allocate(100);
+    void* c = alloc_.allocate(100);
+    ASSERT_TRUE(a && b && c);
+
+    alloc_.release(a);
+    alloc_.release(c);   // 与尾部空闲段合并
+    alloc_.release(b);   // 与前后两段合并
+
+    // 合并后整个 chunk 又是一个完整空闲段，可以一次性分出最大段
+    void* whole = alloc_.allocate(PageRunAllocator::kMaxRunPages);
+    EXPECT_EQ(whole, a);
+    EXPECT_EQ(alloc_.getChunkCount(), 1u);
+    EXPECT_EQ(central_.refills, 1u);
+    alloc_.release(whole);
+}
+
+TEST_F(PageRunAllocatorTest, SharesChunksAcrossSizes) {
+    // 不同尺寸的段共用同一个 chunk（640KB + 768KB + 576KB）
+    void* a = alloc_.allocate(160);
+    void* b = alloc_.allocate(192);
+    void* c = alloc_.allocate(144);
+    ASSERT_TRUE(a && b && c);
+    EXPECT_EQ(alloc_.getChunkCount(), 1u);
+
+    // 放不下时才申请新 chunk
+    void* d = alloc_.allocate(256);
+    ASSERT_NE(d, nullptr);
+    EXPECT_EQ(alloc_.getChunkCount(), 2u);
+
+    for (void* p : {a, b, c, d}) alloc_.release(p);
+}
+
+TEST_F(PageRunAllocatorTest, ReturnsSurplusEmptyChunks) {
+    void* a = alloc_.allocate(300);
+    void* b = alloc_.allocate(300);
+    void* c = alloc_.allocate(300);
+    ASSERT_TRUE(a && b && c);
+    EXPECT_EQ(alloc_.getChunkCount(), 3u);
+
+    alloc_.release(a);
+    alloc_.release(b);
+    alloc_.release(c);
+
+    // 只保留 kMaxEmptyChunks 个空 chunk，其余交还上游
+    EXPECT_EQ(alloc_.getChunkCount(), PageRunAllocator::kMaxEmptyChunks);
+    EXPECT_EQ(central_.returns, 3u - PageRunAllocator::kMaxEmptyChunks);
+}
+
+// 回调在锁外调用：回调期间其他线程的查询（同样要拿分配器的锁）可以完成
+struct ProbingCentral {
+    PageRunAllocator* alloc = nullptr;
+    size_t refills_unblocked = 0;
+    size_t returns_unblocked = 0;
+
+    bool probe() const {
+        auto fut = std::async(std::launch::async, [a = alloc] { return a->getFreePages(); });
+        const bool done = fut.wait_for(std::chrono::seconds(1)) == std::future_status::ready;
+        return done;   // 未完成时 future 析构会等到锁释放后再返回
+    }
+    static void* refill(void* ctx) noexcept {
+        auto* self = static_cast<ProbingCentral*>(ctx);
+        if (self->probe()) ++self->refills_unblocked;
+        return std::aligned_alloc(PageRunChunk::kChunkSize, PageRunChunk::kChunkSize);
+    }
+    static void giveBack(void* ctx, void* chunk) noexcept {
+        auto* self = static_cast<ProbingCentral*>(ctx);
+        if (self->probe()) ++self->returns_unblocked;
+        std::free(chunk);
+    }
+};
+
+TEST(PageRunAllocatorLockTest, CallbacksRunWithoutHoldingTheLock) {
+    PageRunAllocator alloc;
+    ProbingCentral central;
+    central.alloc = &alloc;
+    alloc.setRefillCallback(&ProbingCentral::refill, &central);
+    alloc.setReturnCallback(&ProbingCentral::giveBack, &central);
+
+    void* a = alloc.allocate(PageRunAllocator::kMaxRunPages);
+    void* b = alloc.allocate(PageRunAllocator::kMaxRunPages);
+    ASSERT_TRUE(a && b);
+    EXPECT_EQ(central.refills_unblocked, 2u);
+
+    alloc.release(a);
+    alloc.release(b);   // 第二个空 chunk 超出保留数，交还上游
+    EXPECT_EQ(central.returns_unblocked, 1u);
+    EXPECT_EQ(alloc.getChunkCount(), PageRunAllocator::kMaxEmptyChunks);
+}
+
+// 多线程并发分配：各自在锁外补充 chunk，多要的空 chunk 被交还，记账保持一致
+TEST(PageRunAllocatorLockTest, ConcurrentRefillsKeepChunkAccounting) {
+    struct CountingCentral {
+        std::atomic<size_t> refills{0};
+        std::atomic<size_t> returns{0};
+        static void* refill(void* ctx) noexcept {
+            static_cast<CountingCentral*>(ctx)->refills.fetch_add(1);
+            return std::aligned_alloc(PageRunChunk::kChunkSize, PageRunChunk::kChunkSize);
+        }
+        static void giveBack(void* ctx, void* chunk) noexcept {
+            static_cast<CountingCentral*>(ctx)->returns.fetch_add(1);
+            std::free(chunk);
+        }
+    } central;
+
+    PageRunAllocator alloc;
+    alloc.setRefillCallback(&CountingCentral::refill, &central);
+    alloc.setReturnCallback(&CountingCentral::giveBack, &central);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&alloc, t] {
+            for (int round = 0; round < 200; ++round) {
+                void* runs[4];
+                for (void*& r : runs) {
+                    r = alloc.allocate(100 + static_cast<size_t>(t) * 50);
+                    ASSERT_NE(r, nullptr);
+                    static_cast<char*>(r)[0] = static_cast<char>(round);
+                }
+                for (void* r : runs) alloc.release(r);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    EXPECT_EQ(alloc.getFreePages(), alloc.getChunkCount() * PageRunAllocator::kMaxRunPages);
+    EXPECT_LE(alloc.getChunkCount(), PageRunAllocator::kMaxEmptyChunks);
+    EXPECT_EQ(central.refills.load() - central.returns.load(), alloc.getChunkCount());
+}
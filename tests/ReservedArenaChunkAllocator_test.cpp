@@ -0,0 +1,177 @@
+#include "gtest/gtest.h"
+#include "gc_malloc/CentralHeap/ReservedArenaChunkAllocator.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+constexpr size_t kChunk = ReservedArenaChunkAllocator::kChunkSize;
+
+// 测试用的小保留区：16 个 chunk，便于覆盖耗尽与复用
+class ReservedArenaChunkAllocatorTest : public ::testing::Test {
+protected:
+    ReservedArenaChunkAllocator arena{16 * kChunk};
+};
+
+} // namespace
+
+TEST_F(ReservedArenaChunkAllocatorTest, ReservesAlignedRegion) {
+    ASSERT_TRUE(arena.isReserved());
+    EXPECT_EQ(arena.getChunkCapacity(), 16u);
+    EXPECT_EQ(arena.getCommittedChunks(), 0u);
+}
+
+TEST_F(ReservedArenaChunkAllocatorTest, AllocateCommitsAlignedChunks) {
+    char* a = static_cast<char*>(arena.allocate(kChunk));
+    char* b = static_cast<char*>(arena.allocate(3 * kChunk));
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % kChunk, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % kChunk, 0u);
+    EXPECT_EQ(arena.getCommittedChunks(), 4u);
+
+    // 提交后的内存可读写，且初始为 0
+    EXPECT_EQ(a[123], 0);
+    a[0] = 1;
+    b[3 * kChunk - 1] = 2;
+
+    EXPECT_EQ(arena.chunkIndexOf(b + kChunk + 5), arena.chunkIndexOf(a) + 2);
+
+    arena.deallocate(a, kChunk);
+    arena.deallocate(b, 3 * kChunk);
+    EXPECT_EQ(arena.getCommittedChunks(), 0u);
+}
+
+TEST_F(ReservedArenaChunkAllocatorTest, OwnsOnlyCommittedChunks) {
+    char* a = static_cast<char*>(arena.allocate(2 * kChunk));
+    ASSERT_NE(a, nullptr);
+
+    EXPECT_TRUE(arena.owns(a));
+    EXPECT_TRUE(arena.owns(a + 2 * kChunk - 1));
+    EXPECT_FALSE(arena.owns(a + 2 * kChunk));   // 区间内但未提交
+
+    int on_stack = 0;
+    EXPECT_FALSE(arena.owns(&on_stack));
+    EXPECT_FALSE(arena.owns(nullptr));
+
+    // 大块可以只归还尾部
+    arena.deallocate(a + kChunk, kChunk);
+    EXPECT_TRUE(arena.owns(a));
+    EXPECT_FALSE(arena.owns(a + kChunk));
+
+    arena.deallocate(a, kChunk);
+    EXPECT_FALSE(arena.owns(a));
+}
+
+TEST_F(ReservedArenaChunkAllocatorTest, ReusesFreedChunksInsideTheArena) {
+    std::vector<void*> chunks;
+    for (size_t i = 0; i < arena.getChunkCapacity(); ++i) {
+        void* c = arena.allocate(kChunk);
+        ASSERT_NE(c, nullptr);
+        EXPECT_TRUE(arena.owns(c));
+        chunks.push_back(c);
+    }
+    EXPECT_FALSE(arena.hasOverflowed());
+
+    // 归还两个相邻 chunk 后，两 chunk 的请求可以落在这个空洞里
+    arena.deallocate(chunks[5], kChunk);
+    arena.deallocate(chunks[6], kChunk);
+    void* pair = arena.allocate(2 * kChunk);
+    EXPECT_EQ(pair, chunks[5]);
+    EXPECT_FALSE(arena.hasOverflowed());
+
+    for (void* c : chunks) {
+        if (c != chunks[5] && c != chunks[6]) arena.deallocate(c, kChunk);
+    }
+    arena.deallocate(pair, 2 * kChunk);
+    EXPECT_EQ(arena.getCommittedChunks(), 0u);
+}
+
+TEST_F(ReservedArenaChunkAllocatorTest, AllocationsPastReservationFallBackToMmap) {
+    std::vector<void*> chunks;
+    for (size_t i = 0; i < arena.getChunkCapacity(); ++i) {
+        void* c = arena.allocate(kChunk);
+        ASSERT_NE(c, nullptr);
+        chunks.push_back(c);
+    }
+
+    // 保留区已满：单 chunk 与多 chunk 请求都改由 mmap 满足，仍按 2MB 对齐且可读写
+    char* single = static_cast<char*>(arena.allocate(kChunk));
+    char* span   = static_cast<char*>(arena.allocate(3 * kChunk));
+    ASSERT_NE(single, nullptr);
+    ASSERT_NE(span, nullptr);
+    EXPECT_TRUE(arena.hasOverflowed());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(single) % kChunk, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(span) % kChunk, 0u);
+    EXPECT_FALSE(arena.owns(single));
+    EXPECT_FALSE(arena.owns(span));
+    EXPECT_EQ(arena.getCommittedChunks(), arena.getChunkCapacity());
+    single[0] = 1;
+    span[3 * kChunk - 1] = 2;
+
+    // 溢出的大块同样可以只归还尾部
+    arena.deallocate(span + 2 * kChunk, kChunk);
+    arena.deallocate(span, 2 * kChunk);
+    arena.deallocate(single, kChunk);
+
+    // 保留区腾出空间后，新的请求重新落回区间内
+    arena.deallocate(chunks.back(), kChunk);
+    chunks.pop_back();
+    void* again = arena.allocate(kChunk);
+    ASSERT_NE(again, nullptr);
+    EXPECT_TRUE(arena.owns(again));
+    chunks.push_back(again);
+
+    for (void* c : chunks) arena.deallocate(c, kChunk);
+    EXPECT_EQ(arena.getCommittedChunks(), 0u);
+}
+
+TEST_F(ReservedArenaChunkAllocatorTest, BatchCommitsOneContiguousRange) {
+    // 空的保留区：整批落在同一段连续区间内，相邻 chunk 首尾相接
+    void* batch[5];
+    ASSERT_EQ(arena.allocateBatch(kChunk, 5, batch), 5u);
+    for (size_t i = 0; i < 5; ++i) {
+        EXPECT_TRUE(arena.owns(batch[i]));
+        if (i > 0) EXPECT_EQ(static_cast<char*>(batch[i]), static_cast<char*>(batch[i - 1]) + kChunk);
+        static_cast<char*>(batch[i])[kChunk - 1] = 1;
+    }
+    EXPECT_EQ(arena.getCommittedChunks(), 5u);
+
+    // 只剩零散空洞时取最长的一段，少给几个；每个 chunk 仍可单独归还
+    std::vector<void*> rest;
+    for (size_t i = 5; i < arena.getChunkCapacity(); ++i) rest.push_back(arena.allocate(kChunk));
+    arena.deallocate(batch[1], kChunk);
+    arena.deallocate(batch[2], kChunk);
+    arena.deallocate(batch[3], kChunk);
+    arena.deallocate(rest[4], kChunk);
+
+    void* partial[8];
+    ASSERT_EQ(arena.allocateBatch(kChunk, 8, partial), 3u);
+    EXPECT_EQ(partial[0], batch[1]);
+    EXPECT_EQ(partial[2], batch[3]);
+    EXPECT_FALSE(arena.hasOverflowed());
+    for (size_t i = 0; i < 3; ++i) arena.deallocate(partial[i], kChunk);
+    arena.deallocate(batch[0], kChunk);
+    arena.deallocate(batch[4], kChunk);
+    for (size_t i = 0; i < rest.size(); ++i) {
+        if (i != 4) arena.deallocate(rest[i], kChunk);
+    }
+    EXPECT_EQ(arena.getCommittedChunks(), 0u);
+}
+
+TEST_F(ReservedArenaChunkAllocatorTest, BatchFallsBackToMmapWhenArenaIsFull) {
+    std::vector<void*> chunks;
+    for (size_t i = 0; i < arena.getChunkCapacity(); ++i) chunks.push_back(arena.allocate(kChunk));
+
+    void* batch[3];
+    ASSERT_EQ(arena.allocateBatch(kChunk, 3, batch), 3u);
+    EXPECT_TRUE(arena.hasOverflowed());
+    for (void* c : batch) {
+        EXPECT_FALSE(arena.owns(c));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(c) % kChunk, 0u);
+        static_cast<char*>(c)[0] = 1;
+        arena.deallocate(c, kChunk);
+    }
+    for (void* c : chunks) arena.deallocate(c, kChunk);
+}
@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+#include "gc_malloc/CentralHeap/RetainedChunkCache.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// 只做记账：用假地址即可，回调只记录降级请求，不会真的访问这些内存
+static void* FakeChunk(std::uintptr_t n) {
+    return reinterpret_cast<void*>(n << 21);
+}
+
+namespace {
+
+struct AdviseLog {
+    std::vector<std::pair<void*, ChunkDecayStage>> calls;
+    bool succeed = true;
+};
+
+bool RecordAdvise(void* ctx, void* base, size_t offset, ChunkDecayStage to) noexcept {
+    auto* log = static_cast<AdviseLog*>(ctx);
+    EXPECT_EQ(offset, 0u);
+    log->calls.emplace_back(base, to);
+    return log->succeed;
+}
+
+} // namespace
+
+TEST(RetainedChunkCacheTest, InitialStateIsEmpty) {
+    RetainedChunkCache cache;
+    EXPECT_EQ(cache.getCacheCount(), 0u);
+    EXPECT_EQ(cache.acquire(), nullptr);
+    EXPECT_FALSE(cache.deposit(nullptr, ChunkDecayStage::kDirty, 0));
+    EXPECT_EQ(cache.getCacheCount(), 0u);
+}
+
+TEST(RetainedChunkCacheTest, AcquirePrefersHotterStageThenNewest) {
+    RetainedChunkCache cache;
+    ASSERT_TRUE(cache.deposit(FakeChunk(1), ChunkDecayStage::kClean, 50));
+    ASSERT_TRUE(cache.deposit(FakeChunk(2), ChunkDecayStage::kDirty, 10));
+    ASSERT_TRUE(cache.deposit(FakeChunk(3), ChunkDecayStage::kMuzzy, 90));
+    ASSERT_TRUE(cache.deposit(FakeChunk(4), ChunkDecayStage::kDirty, 20));
+    EXPECT_EQ(cache.getCount(ChunkDecayStage::kDirty), 2u);
+
+    EXPECT_EQ(cache.acquire(), FakeChunk(4));
+    EXPECT_EQ(cache.acquire(), FakeChunk(2));
+    EXPECT_EQ(cache.acquire(), FakeChunk(3));
+    EXPECT_EQ(cache.acquire(), FakeChunk(1));
+    EXPECT_EQ(cache.acquire(), nullptr);
+}
+
+TEST(RetainedChunkCacheTest, DepositFailsWhenFull) {
+    RetainedChunkCache cache;
+    for (std::uintptr_t i = 0; i < RetainedChunkCache::kMaxEntries; ++i) {
+        ASSERT_TRUE(cache.deposit(FakeChunk(i + 1), ChunkDecayStage::kDirty, 0));
+    }
+    EXPECT_FALSE(cache.deposit(FakeChunk(1000), ChunkDecayStage::kDirty, 0));
+    EXPECT_EQ(cache.getCacheCount(), RetainedChunkCache::kMaxEntries);
+}
+
+TEST(RetainedChunkCacheTest, AdvanceDecaysDirtyToMuzzyToClean) {
+    RetainedChunkCache cache;
+    AdviseLog log;
+    ASSERT_TRUE(cache.deposit(FakeChunk(1), ChunkDecayStage::kDirty, 0));
+    ASSERT_TRUE(cache.deposit(FakeChunk(2), ChunkDecayStage::kDirty, 80));
+
+    // dirty 停留 100 才到期：只有第一个降为 muzzy，并从 now 起重新计时
+    EXPECT_EQ(cache.advance(100, 100, 200, &RecordAdvise, &log), 1u);
+    ASSERT_EQ(log.calls.size(), 1u);
+    EXPECT_EQ(log.calls[0].first, FakeChunk(1));
+    EXPECT_EQ(log.calls[0].second, ChunkDecayStage::kMuzzy);
+    EXPECT_EQ(cache.getCount(ChunkDecayStage::kMuzzy), 1u);
+
+    EXPECT_EQ(cache.advance(250, 100, 200, &RecordAdvise, &log), 1u);   // 第二个 dirty 到期，第一个 muzzy 未到期
+    EXPECT_EQ(cache.advance(300, 100, 200, &RecordAdvise, &log), 1u);   // 第一个 muzzy 到期
+    EXPECT_EQ(cache.getCount(ChunkDecayStage::kClean), 1u);
+    EXPECT_EQ(cache.getCount(ChunkDecayStage::kMuzzy), 1u);
+
+    // clean 是终态
+    EXPECT_EQ(cache.advance(10000, 100, 200, &RecordAdvise, &log), 1u);
+    EXPECT_EQ(cache.advance(20000, 100, 200, &RecordAdvise, &log), 0u);
+    EXPECT_EQ(cache.getCount(ChunkDecayStage::kClean), 2u);
+}
+
+TEST(RetainedChunkCacheTest, ZeroMuzzyTimeSkipsMuzzyAndFailedAdviceKeepsStage) {
+    RetainedChunkCache cache;
+    AdviseLog log;
+    ASSERT_TRUE(cache.deposit(FakeChunk(1), ChunkDecayStage::kDirty, 0));
+
+    log.succeed = false;
+    EXPECT_EQ(cache.advance(100, 10, 0, &RecordAdvise, &log), 0u);
+    EXPECT_EQ(cache.getCount(ChunkDecayStage::kDirty), 1u);
+
+    log.succeed = true;
+    EXPECT_EQ(cache.advance(100, 10, 0, &RecordAdvise, &log), 1u);
+    ASSERT_EQ(log.calls.size(), 2u);
+    EXPECT_EQ(log.calls[1].second, ChunkDecayStage::kClean);
+    EXPECT_EQ(cache.getCount(ChunkDecayStage::kClean), 1u);
+}
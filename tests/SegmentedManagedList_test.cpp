@@ -0,0 +1,283 @@
+// SegmentedManagedList_test.cpp
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "gc_malloc/ThreadHeap/SegmentedManagedList.hpp"
+#include "gc_malloc/ThreadHeap/BlockHeader.hpp"
+
+namespace {
+
+// 段内存来自 aligned_alloc，并统计申请/归还次数；limit 为可申请的段数上限
+struct SegmentSource {
+    std::size_t allocated = 0;
+    std::size_t released  = 0;
+    std::size_t limit     = SIZE_MAX;
+
+    std::size_t live() const { return allocated - released; }
+};
+
+void* allocSegment(void* ctx) noexcept {
+    auto* src = static_cast<SegmentSource*>(ctx);
+    if (src->allocated - src->released >= src->limit) return nullptr;
+    ++src->allocated;
+    return std::aligned_alloc(SegmentedManagedList::kSegmentBytes, SegmentedManagedList::kSegmentBytes);
+}
+
+void freeSegment(void* ctx, void* seg) noexcept {
+    ++static_cast<SegmentSource*>(ctx)->released;
+    std::free(seg);
+}
+
+std::vector<BlockHeader> makeBlocks(std::size_t n) {
+    return std::vector<BlockHeader>(n);
+}
+
+// 走完当前一轮（不限预算），按顺序收集被摘下的空闲节点
+std::vector<BlockHeader*> sweepPass(SegmentedManagedList& list) {
+    std::vector<BlockHeader*> freed;
+    const uint64_t epoch = list.epoch();
+    while (list.epoch() == epoch) {
+        if (BlockHeader* b = list.sweepNextFree(SIZE_MAX)) freed.push_back(b);
+    }
+    return freed;
+}
+
+// 每段可容纳的条目数（与实现中的段布局一致：next、count、freed 之后是条目数组）
+constexpr std::size_t kPerSegment = (SegmentedManagedList::kSegmentBytes - 3 * sizeof(void*)) / sizeof(void*);
+
+} // namespace
+
+TEST(SegmentedManagedListTest, AppendSpillsIntoNewSegments) {
+    SegmentSource src;
+    std::vector<BlockHeader> blocks = makeBlocks(2 * kPerSegment + 1);
+    {
+        SegmentedManagedList list(&allocSegment, &freeSegment, &src);
+        EXPECT_TRUE(list.empty());
+        EXPECT_EQ(list.segmentCount(), 0u);
+
+        for (auto& b : blocks) {
+            b.storeFree();
+            ASSERT_TRUE(list.appendUsed(&b));
+            EXPECT_EQ(b.loadState(), BlockState::Used);
+        }
+        EXPECT_EQ(list.size(), blocks.size());
+        EXPECT_EQ(list.segmentCount(), 3u);
+        EXPECT_EQ(src.live(), 3u);
+        EXPECT_FALSE(list.append(nullptr));
+    }
+    // 析构归还所有段
+    EXPECT_EQ(src.live(), 0u);
+}
+
+TEST(SegmentedManagedListTest, SweepReturnsFreeEntriesInOrderAndCompacts) {
+    SegmentSource src;
+    SegmentedManagedList list(&allocSegment, &freeSegment, &src);
+    std::vector<BlockHeader> blocks = makeBlocks(3 * kPerSegment);
+    for (auto& b : blocks) list.appendUsed(&b);
+
+    std::vector<BlockHeader*> expected;
+    for (std::size_t i = 0; i < blocks.size(); i += 3) {
+        blocks[i].storeFree();
+        expected.push_back(&blocks[i]);
+    }
+
+    EXPECT_EQ(sweepPass(list), expected);
+    EXPECT_EQ(list.size(), blocks.size() - expected.size());
+    EXPECT_EQ(list.epoch(), 1u);
+    EXPECT_FALSE(list.passInProgress());
+
+    // 存活条目压实到前两段，第三段被归还
+    EXPECT_EQ(list.segmentCount(), 2u);
+    EXPECT_EQ(src.live(), 2u);
+
+    // 下一轮按原顺序只看到存活条目：把它们全部置为 Free 后逐个取回
+    std::vector<BlockHeader*> survivors;
+    for (std::size_t i = 0; i < blocks.size(); ++i) {
+        if (i % 3 == 0) continue;
+        blocks[i].storeFree();
+        survivors.push_back(&blocks[i]);
+    }
+    EXPECT_EQ(sweepPass(list), survivors);
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(list.segmentCount(), 0u);
+    EXPECT_EQ(src.live(), 0u);
+
+    // 清空后仍可继续追加
+    EXPECT_TRUE(list.appendUsed(&blocks[0]));
+    EXPECT_EQ(list.segmentCount(), 1u);
+}
+
+TEST(SegmentedManagedListTest, SweepCursorResumesAcrossCallsAndWraps) {
+    SegmentSource src;
+    SegmentedManagedList list(&allocSegment, &freeSegment, &src);
+    std::vector<BlockHeader> blocks = makeBlocks(kPerSegment + 10);
+    for (auto& b : blocks) list.appendUsed(&b);
+    blocks[kPerSegment + 5].storeFree();
+
+    // 每次至多访问 64 个条目：游标跨调用前进，直到跨段找到空闲节点
+    std::size_t visited = 0;
+    BlockHeader* got = nullptr;
+    std::size_t calls = 0;
+    while (!got) {
+        const std::size_t before = visited;
+        got = list.sweepNextFree(64, &visited);
+        EXPECT_LE(visited - before, 64u);
+        ++calls;
+        ASSERT_EQ(list.epoch(), 0u);
+    }
+    EXPECT_EQ(got, &blocks[kPerSegment + 5]);
+    EXPECT_EQ(visited, kPerSegment + 6);
+    EXPECT_EQ(calls, (kPerSegment + 6 + 63) / 64);
+    EXPECT_TRUE(list.passInProgress());
+    EXPECT_EQ(list.passVisited(), kPerSegment + 6);
+    EXPECT_EQ(list.passSize(), blocks.size());
+
+    // 走完剩余条目：本轮结束，下一次调用回绕到表头
+    EXPECT_EQ(list.sweepNextFree(SIZE_MAX), nullptr);
+    EXPECT_EQ(list.epoch(), 1u);
+    EXPECT_FALSE(list.passInProgress());
+
+    blocks[0].storeFree();
+    EXPECT_EQ(list.sweepNextFree(1), &blocks[0]);
+    EXPECT_TRUE(list.passInProgress());
+    EXPECT_EQ(list.size(), blocks.size() - 2);
+}
+
+TEST(SegmentedManagedListTest, EntriesAppendedMidPassWaitForNextPass) {
+    SegmentSource src;
+    SegmentedManagedList list(&allocSegment, &freeSegment, &src);
+    std::vector<BlockHeader> blocks = makeBlocks(kPerSegment + 2);
+
+    // 表尾恰好填满一段，本轮中途追加的条目落在新段里
+    for (std::size_t i = 0; i < kPerSegment; ++i) list.appendUsed(&blocks[i]);
+    blocks[1].storeFree();
+    EXPECT_EQ(list.sweepNextFree(SIZE_MAX), &blocks[1]);
+
+    list.append(&blocks[kPerSegment]);       // 状态为 Free
+    list.appendUsed(&blocks[kPerSegment + 1]);
+    blocks[kPerSegment - 1].storeFree();
+
+    // 本轮只走到开始时的末尾；追加的条目压实到前面腾出的位置，多出的新段被释放
+    std::vector<BlockHeader*> expected{&blocks[kPerSegment - 1]};
+    EXPECT_EQ(sweepPass(list), expected);
+    EXPECT_EQ(list.passVisited(), kPerSegment);
+    EXPECT_EQ(list.size(), kPerSegment);
+    EXPECT_EQ(list.segmentCount(), 1u);
+    EXPECT_EQ(src.live(), 1u);
+
+    expected = {&blocks[kPerSegment]};
+    EXPECT_EQ(sweepPass(list), expected);
+    EXPECT_EQ(list.size(), kPerSegment - 1);
+}
+
+TEST(SegmentedManagedListTest, EntriesReappendedDuringPassDoNotExtendIt) {
+    SegmentSource src;
+    SegmentedManagedList list(&allocSegment, &freeSegment, &src);
+    std::vector<BlockHeader> blocks = makeBlocks(kPerSegment + 4);
+    for (auto& b : blocks) list.appendUsed(&b);
+
+    // 模拟清扫中仍有在用块的子池：每次移出后立即被远端释放置回 Free 并挂回表尾
+    blocks[3].storeFree();
+    std::size_t returned = 0;
+    const uint64_t epoch = list.epoch();
+    while (list.epoch() == epoch) {
+        BlockHeader* node = list.sweepNextFree(SIZE_MAX);
+        if (!node) continue;
+        ++returned;
+        ASSERT_LE(returned, 4u) << "the pass keeps revisiting re-appended entries";
+        ASSERT_TRUE(list.append(node));
+        node->storeFree();
+    }
+    EXPECT_EQ(returned, 1u);
+    EXPECT_EQ(list.passVisited(), blocks.size());
+    EXPECT_EQ(list.size(), blocks.size());
+    EXPECT_EQ(list.segmentCount(), 2u);
+
+    // 下一轮照常访问它
+    std::vector<BlockHeader*> expected{&blocks[3]};
+    EXPECT_EQ(sweepPass(list), expected);
+}
+
+TEST(SegmentedManagedListTest, SweepOnEmptyListCompletesPass) {
+    SegmentSource src;
+    SegmentedManagedList list(&allocSegment, &freeSegment, &src);
+
+    std::size_t visited = 0;
+    EXPECT_EQ(list.sweepNextFree(16, &visited), nullptr);
+    EXPECT_EQ(visited, 0u);
+    EXPECT_EQ(list.epoch(), 1u);
+    EXPECT_FALSE(list.passInProgress());
+}
+
+TEST(SegmentedManagedListTest, AppendFailsWhenSegmentsRunOut) {
+    SegmentSource src;
+    src.limit = 1;
+    SegmentedManagedList list(&allocSegment, &freeSegment, &src);
+    std::vector<BlockHeader> blocks = makeBlocks(kPerSegment + 1);
+
+    for (std::size_t i = 0; i < kPerSegment; ++i) {
+        ASSERT_TRUE(list.appendUsed(&blocks[i]));
+    }
+    EXPECT_FALSE(list.appendUsed(&blocks[kPerSegment]));
+    EXPECT_EQ(list.size(), kPerSegment);
+    EXPECT_EQ(list.segmentCount(), 1u);
+}
+
+TEST(SegmentedManagedListTest, ParallelScanSplitsSegmentsAcrossThreads) {
+    SegmentSource src;
+    SegmentedManagedList list(&allocSegment, &freeSegment, &src);
+    std::vector<BlockHeader> blocks = makeBlocks(4 * kPerSegment + 7);
+    for (auto& b : blocks) list.appendUsed(&b);
+
+    // 先走一段增量清扫，再开始并行判定：未访问的部分并入本轮
+    blocks[2].storeFree();
+    EXPECT_EQ(list.sweepNextFree(SIZE_MAX), &blocks[2]);
+    for (std::size_t i = 0; i < blocks.size(); i += 5) blocks[i].storeFree();
+
+    list.beginParallelScan();
+    std::atomic<std::size_t> scanned{0};
+    std::vector<std::thread> helpers;
+    for (int t = 0; t < 3; ++t) {
+        helpers.emplace_back([&] { scanned += list.scanShared(); });
+    }
+    scanned += list.scanShared();
+    for (auto& t : helpers) t.join();
+    EXPECT_EQ(scanned.load(), blocks.size() - 1);
+
+    // 回调：偶数下标的空闲节点被移出，其余留在表中
+    struct Ctx {
+        BlockHeader* base;
+        std::vector<BlockHeader*> seen;
+    } ctx{blocks.data(), {}};
+    const auto cb = [](void* c, BlockHeader* blk) noexcept {
+        auto* self = static_cast<Ctx*>(c);
+        self->seen.push_back(blk);
+        return (blk - self->base) % 2 != 0;
+    };
+    const std::size_t removed = list.finishParallelScan(cb, &ctx);
+
+    std::size_t expected_removed = 0;
+    std::size_t expected_seen = 0;
+    for (std::size_t i = 0; i < blocks.size(); i += 5) {
+        ++expected_seen;
+        if (i % 2 == 0) ++expected_removed;
+    }
+    EXPECT_EQ(ctx.seen.size(), expected_seen);
+    EXPECT_EQ(removed, expected_removed);
+    EXPECT_EQ(list.size(), blocks.size() - 1 - expected_removed);
+    EXPECT_EQ(list.epoch(), 1u);
+    EXPECT_FALSE(list.passInProgress());
+    EXPECT_EQ(list.segmentCount(), (list.size() + kPerSegment - 1) / kPerSegment);
+
+    // 下一轮按顺序只剩被保留的空闲节点
+    std::vector<BlockHeader*> kept;
+    for (std::size_t i = 0; i < blocks.size(); i += 5) {
+        if (i % 2 != 0) kept.push_back(&blocks[i]);
+    }
+    EXPECT_EQ(sweepPass(list), kept);
+}
@@ -10,6 +10,7 @@
 #include <vector>
 #include <cstdint>
 #include <algorithm>
+#include <thread>
 
 // ============== 测试上下文与回调实现 ==============
 // 测试桩：用对齐的 ::operator new/delete 获取/释放 2MB 原始内存，
@@ -186,3 +187,213 @@ TEST(SizeClassPoolManager, OwnsPointer_BlockSizeMismatch) {
     ctxA.ForceCleanupAll();
     ctxB.ForceCleanupAll();
 }
+
+// ============== 批量释放：同一子池的一组块一次释放 ==============
+// 期望：releaseBlocks 后子池直接回到 empty；块尺寸不符的子池被拒绝。
+TEST(SizeClassPoolManager, ReleaseBlocks_BatchForSamePool) {
+    TestPoolIOCtx ctx;
+    ctx.block_size = 64;
+
+    {
+        SizeClassPoolManager mgr{ctx.block_size};
+        mgr.setRefillCallback(&TestRefillCallback, &ctx);
+        mgr.setReturnCallback(&TestReturnCallback, &ctx);
+
+        std::vector<void*> blocks;
+        for (int i = 0; i < 32; ++i) {
+            void* p = mgr.allocateBlock();
+            ASSERT_NE(p, nullptr);
+            blocks.push_back(p);
+        }
+        EXPECT_EQ(PartialCount(mgr), 1u);
+
+        auto* pool = reinterpret_cast<MemSubPool*>(
+            reinterpret_cast<std::uintptr_t>(blocks[0]) & ~(std::uintptr_t)(MemSubPool::kPoolTotalSize - 1));
+
+        SizeClassPoolManager other{128};
+        EXPECT_FALSE(other.releaseBlocks(pool, blocks.data(), blocks.size()));
+
+        EXPECT_TRUE(mgr.releaseBlocks(pool, blocks.data(), blocks.size()));
+        EXPECT_EQ(PartialCount(mgr), 0u);
+        EXPECT_TRUE(pool->isEmpty());
+        EXPECT_GE(EmptyCount(mgr), 1u);
+    }
+
+    ctx.ForceCleanupAll();
+}
+
+// ============== 批量分配：供线程缓存补货 ==============
+// 期望：一次取出的块地址升序、互不相同；跨越子池边界时自动换下一个子池。
+TEST(SizeClassPoolManager, AllocateBlocks_BatchAcrossPools) {
+    TestPoolIOCtx ctx;
+    ctx.block_size = 64 * 1024;   // 一个子池只有约 31 块，便于跨池
+
+    {
+        SizeClassPoolManager mgr{ctx.block_size};
+        mgr.setRefillCallback(&TestRefillCallback, &ctx);
+        mgr.setReturnCallback(&TestReturnCallback, &ctx);
+
+        void* batch[48] = {};
+        const std::size_t n = mgr.allocateBlocks(batch, 48);
+        ASSERT_EQ(n, 48u);
+        EXPECT_TRUE(std::is_sorted(batch, batch + 31));
+        std::vector<void*> uniq(batch, batch + n);
+        std::sort(uniq.begin(), uniq.end());
+        EXPECT_EQ(std::unique(uniq.begin(), uniq.end()), uniq.end());
+
+        EXPECT_EQ(FullCount(mgr), 1u);
+        EXPECT_EQ(PartialCount(mgr), 1u);
+
+        for (void* p : batch) EXPECT_TRUE(mgr.releaseBlock(p));
+        EXPECT_EQ(FullCount(mgr) + PartialCount(mgr), 0u);
+    }
+
+    ctx.ForceCleanupAll();
+}
+
+// ============== 测试：本地空闲块耗尽时先取回远程释放，再向上游补充 ==============
+TEST(SizeClassPoolManager, DrainsRemoteFreesBeforeRefill) {
+    TestPoolIOCtx ctx;
+    ctx.block_size = 64 * 1024;
+
+    {
+        SizeClassPoolManager mgr{ctx.block_size};
+        mgr.setRefillCallback(&TestRefillCallback, &ctx);
+        mgr.setReturnCallback(&TestReturnCallback, &ctx);
+
+        // 用满补充进来的全部子池
+        std::vector<void*> blocks;
+        while (PartialCount(mgr) + EmptyCount(mgr) > 0 || blocks.empty()) {
+            void* p = mgr.allocateBlock();
+            ASSERT_NE(p, nullptr);
+            blocks.push_back(p);
+        }
+        const std::size_t refills = ctx.refill_calls;
+        ASSERT_EQ(FullCount(mgr), refills);
+
+        // 其他线程释放：只压入子池的远程释放栈
+        std::thread([&] {
+            for (std::size_t i = 0; i < 3; ++i) {
+                auto* pool = reinterpret_cast<MemSubPool*>(
+                    reinterpret_cast<std::uintptr_t>(blocks[i]) & ~(MemSubPool::kPoolAlignment - 1));
+                pool->release(blocks[i]);
+            }
+        }).join();
+
+        for (std::size_t i = 0; i < 3; ++i) {
+            void* p = mgr.allocateBlock();
+            EXPECT_TRUE(std::find(blocks.begin(), blocks.begin() + 3, p) != blocks.begin() + 3);
+        }
+        EXPECT_EQ(ctx.refill_calls, refills);
+
+        // 远程释放用完后才向上游要新子池
+        EXPECT_NE(mgr.allocateBlock(), nullptr);
+        EXPECT_GT(ctx.refill_calls, refills);
+    }
+
+    ctx.ForceCleanupAll();
+}
+
+// ============== 远程释放通知：补货只看收到通知的满子池，看完一个接着看下一个 ==============
+TEST(SizeClassPoolManager, NotifiedFullPoolsAreReclaimedInTurn) {
+    TestPoolIOCtx ctx;
+    ctx.block_size = 512 * 1024;   // 每个子池只有几个块，很快用满多个子池
+
+    {
+        SizeClassPoolManager mgr{ctx.block_size};
+        mgr.setRefillCallback(&TestRefillCallback, &ctx);
+        mgr.setReturnCallback(&TestReturnCallback, &ctx);
+
+        std::vector<void*> blocks;
+        while (FullCount(mgr) < 6 || PartialCount(mgr) + EmptyCount(mgr) > 0) {
+            void* p = mgr.allocateBlock();
+            ASSERT_NE(p, nullptr);
+            blocks.push_back(p);
+        }
+        const std::size_t refills = ctx.refill_calls;
+
+        // 其他线程分别释放最早与最晚用满的子池中的一个块
+        void* const freed[] = {blocks.front(), blocks.back()};
+        std::thread([&] {
+            for (void* b : freed) {
+                auto* pool = reinterpret_cast<MemSubPool*>(
+                    reinterpret_cast<std::uintptr_t>(b) & ~(MemSubPool::kPoolAlignment - 1));
+                pool->release(b);
+            }
+        }).join();
+
+        // 两次分配分别取回这两个块：第一次没用到的通知留给第二次，不向上游补货
+        void* a = mgr.allocateBlock();
+        void* b = mgr.allocateBlock();
+        EXPECT_TRUE((a == freed[0] && b == freed[1]) || (a == freed[1] && b == freed[0]));
+        EXPECT_EQ(ctx.refill_calls, refills);
+        EXPECT_EQ(FullCount(mgr), 6u);
+
+        // 没有新的远程释放：下一次分配直接补货
+        EXPECT_NE(mgr.allocateBlock(), nullptr);
+        EXPECT_GT(ctx.refill_calls, refills);
+    }
+
+    ctx.ForceCleanupAll();
+}
+
+// ============== 线程退出：交出子池，由另一个管理器认领 ==============
+TEST(SizeClassPoolManager, AbandonedPoolsAreAdoptedWithPendingFrees) {
+    TestPoolIOCtx ctx;
+    ctx.block_size = 64 * 1024;
+
+    std::vector<void*>       blocks;
+    std::vector<MemSubPool*> orphans;
+    std::thread([&] {
+        SizeClassPoolManager mgr{ctx.block_size};
+        mgr.setRefillCallback(&TestRefillCallback, &ctx);
+        mgr.setReturnCallback(&TestReturnCallback, &ctx);
+
+        // 用满第一个子池，再从第二个子池取一块；另一个补充进来的空子池在交出时被归还
+        while (FullCount(mgr) == 0) blocks.push_back(mgr.allocateBlock());
+        blocks.push_back(mgr.allocateBlock());
+        ASSERT_EQ(PartialCount(mgr), 1u);
+
+        const std::size_t returns = ctx.return_calls;
+        const std::size_t empties = EmptyCount(mgr);
+        mgr.abandonPools([](void* c, MemSubPool* pool) noexcept {
+            static_cast<std::vector<MemSubPool*>*>(c)->push_back(pool);
+        }, &orphans);
+        EXPECT_EQ(EmptyCount(mgr) + PartialCount(mgr) + FullCount(mgr), 0u);
+        EXPECT_EQ(ctx.return_calls, returns + empties);
+    }).join();
+    ASSERT_EQ(orphans.size(), 2u);
+
+    // 所属线程已退出：释放只能登记为释放请求
+    for (std::size_t i = 0; i < 3; ++i) {
+        auto* pool = reinterpret_cast<MemSubPool*>(
+            reinterpret_cast<std::uintptr_t>(blocks[i]) & ~(MemSubPool::kPoolAlignment - 1));
+        pool->release(blocks[i]);
+    }
+
+    {
+        SizeClassPoolManager mgr{ctx.block_size};
+        mgr.setRefillCallback(&TestRefillCallback, &ctx);
+        mgr.setReturnCallback(&TestReturnCallback, &ctx);
+
+        std::size_t reclaimed = 0;
+        bool emptied = true;
+        for (MemSubPool* pool : orphans) {
+            reclaimed += mgr.adoptPool(pool, &emptied);
+            EXPECT_FALSE(emptied);
+            EXPECT_TRUE(pool->isOwnedByCurrentThread());
+        }
+        EXPECT_EQ(reclaimed, 3u);
+        EXPECT_EQ(PartialCount(mgr), 2u);
+
+        // 认领后的子池直接可用，不需要补充
+        const std::size_t refills = ctx.refill_calls;
+        for (std::size_t i = 0; i < 3; ++i) {
+            void* p = mgr.allocateBlock();
+            EXPECT_TRUE(std::find(blocks.begin(), blocks.begin() + 3, p) != blocks.begin() + 3);
+        }
+        EXPECT_EQ(ctx.refill_calls, refills);
+    }
+
+    ctx.ForceCleanupAll();
+}
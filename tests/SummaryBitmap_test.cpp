@@ -0,0 +1,39 @@
+#include "gtest/gtest.h"
+#include "gc_malloc/ThreadHeap/SummaryBitmap.hpp"
+
+TEST(SummaryBitmapTest, StartsFullAndTracksLeafWords) {
+    SummaryBitmap summary(1024);
+    EXPECT_EQ(summary.leafWords(), 1024u);
+    EXPECT_EQ(summary.findFirstWithFree(), SummaryBitmap::k_not_found);
+
+    summary.markHasFree(700);
+    summary.markHasFree(65);
+    EXPECT_TRUE(summary.hasFree(700));
+    EXPECT_FALSE(summary.hasFree(64));
+    EXPECT_EQ(summary.findFirstWithFree(), 65u);
+
+    summary.markFull(65);
+    EXPECT_EQ(summary.findFirstWithFree(), 700u);
+    summary.markFull(700);
+    EXPECT_EQ(summary.findFirstWithFree(), SummaryBitmap::k_not_found);
+
+    // 越界下标被忽略
+    summary.markHasFree(1024);
+    EXPECT_EQ(summary.findFirstWithFree(), SummaryBitmap::k_not_found);
+}
+
+// update 按叶字内容决定：全 1 视为满，否则视为含空闲位
+TEST(SummaryBitmapTest, UpdateFollowsLeafWordContents) {
+    SummaryBitmap summary(SummaryBitmap::kMaxLeafWords);
+
+    summary.update(4095, 0x7FFFFFFFFFFFFFFFull);
+    summary.update(128, ~0ull);
+    EXPECT_EQ(summary.findFirstWithFree(), 4095u);
+
+    summary.update(128, 0);
+    EXPECT_EQ(summary.findFirstWithFree(), 128u);
+
+    summary.update(128, ~0ull);
+    summary.update(4095, ~0ull);
+    EXPECT_EQ(summary.findFirstWithFree(), SummaryBitmap::k_not_found);
+}
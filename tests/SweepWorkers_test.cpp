@@ -0,0 +1,64 @@
+// SweepWorkers_test.cpp
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include "gc_malloc/ThreadHeap/SweepWorkers.hpp"
+
+namespace {
+
+struct CountingTask {
+    std::atomic<std::size_t> calls{0};
+    std::atomic<std::size_t> items{1000};   // 共享的工作量，各线程自行领取
+    std::atomic<std::size_t> done{0};
+};
+
+void countingTask(void* ctx) noexcept {
+    auto* t = static_cast<CountingTask*>(ctx);
+    ++t->calls;
+    std::size_t left = t->items.load();
+    while (left != 0) {
+        if (t->items.compare_exchange_weak(left, left - 1)) {
+            ++t->done;
+            left = t->items.load();
+        }
+    }
+}
+
+} // namespace
+
+TEST(SweepWorkersTest, RunsTaskOnCallerAndJoinedHelpers) {
+    SweepWorkers& workers = SweepWorkers::GetInstance();
+    EXPECT_EQ(workers.prepare(3), 3u);
+    EXPECT_EQ(workers.prepare(SweepWorkers::kMaxHelpers + 8), SweepWorkers::kMaxHelpers);
+
+    for (int round = 0; round < 50; ++round) {
+        CountingTask task;
+        const std::size_t joined = workers.run(3, &countingTask, &task);
+        EXPECT_LE(joined, 3u);
+        // 返回时所有参与者都已结束
+        EXPECT_EQ(task.calls.load(), joined + 1);
+        EXPECT_EQ(task.done.load(), 1000u);
+    }
+}
+
+TEST(SweepWorkersTest, ConcurrentCallersFallBackToCallingThread) {
+    SweepWorkers& workers = SweepWorkers::GetInstance();
+    workers.prepare(2);
+
+    std::atomic<std::size_t> total{0};
+    std::thread others[4];
+    for (auto& t : others) {
+        t = std::thread([&] {
+            for (int round = 0; round < 20; ++round) {
+                CountingTask task;
+                const std::size_t joined = workers.run(2, &countingTask, &task);
+                EXPECT_EQ(task.calls.load(), joined + 1);
+                total += task.done.load();
+            }
+        });
+    }
+    for (auto& t : others) t.join();
+    EXPECT_EQ(total.load(), 4u * 20u * 1000u);
+}
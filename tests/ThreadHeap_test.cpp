@@ -1,22 +1,51 @@
 #include "gtest/gtest.h"
 
+#include "gc_malloc/CentralHeap/CentralHeap.hpp"
+#include "gc_malloc/CentralHeap/PageMap.hpp"
 #include "gc_malloc/ThreadHeap/ThreadHeap.hpp"
 #include "gc_malloc/ThreadHeap/BlockHeader.hpp"
+#include "gc_malloc/ThreadHeap/MemSubPool.hpp"
 #include "gc_malloc/ThreadHeap/SizeClassConfig.hpp"
 
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 在另一个线程上释放：走“登记释放请求 + 所属线程 GC 回收”的路径
+// （所属线程自己释放的小对象直接回到线程缓存，不经过 GC）
+static void DeallocateFromOtherThread(void* p) {
+    std::thread([p] { ThreadHeap::deallocate(p); }).join();
+}
+
+// 在一个全新的 ThreadHeap 上运行 fn：暂停实例回收，
+// 避免新线程接管其他用例留下的退役实例（其 ManagedList 中带有旧节点）
+template <typename Fn>
+static void RunOnFreshThreadHeap(Fn&& fn) {
+    ThreadHeap::setRetiredHeapLimit(0);
+    std::thread(std::forward<Fn>(fn)).join();
+    ThreadHeap::setRetiredHeapLimit(ThreadHeap::kDefaultRetiredHeapLimit);
+}
+
 // 仅测试小对象路径
 TEST(ThreadHeapTest, AllocateDeallocateSmallObject) {
     constexpr std::size_t req_size = 64; // 小对象
     void* p = ThreadHeap::allocate(req_size);
     ASSERT_NE(p, nullptr) << "Allocate should succeed for small object";
 
-    auto* hdr = static_cast<BlockHeader*>(p);
     // 新分配的块应为 Used
-    EXPECT_EQ(hdr->loadState(), BlockState::Used);
+    EXPECT_EQ(ThreadHeap::blockState(p), BlockState::Used);
 
     // 释放后应标记为 Free（跨线程安全：这里只是标位）
-    ThreadHeap::deallocate(p);
-    EXPECT_EQ(hdr->loadState(), BlockState::Free);
+    DeallocateFromOtherThread(p);
+    EXPECT_EQ(ThreadHeap::blockState(p), BlockState::Free);
 
     // 当前线程执行一次 GC，应回收这一个块
     std::size_t reclaimed = ThreadHeap::garbageCollect();
@@ -33,18 +62,542 @@ TEST(ThreadHeapTest, MultipleSmallAllocations) {
     ASSERT_NE(p2, nullptr);
     ASSERT_NE(p1, p2) << "Two small allocations should yield different blocks";
 
-    auto* h1 = static_cast<BlockHeader*>(p1);
-    auto* h2 = static_cast<BlockHeader*>(p2);
+    EXPECT_EQ(ThreadHeap::blockState(p1), BlockState::Used);
+    EXPECT_EQ(ThreadHeap::blockState(p2), BlockState::Used);
 
-    EXPECT_EQ(h1->loadState(), BlockState::Used);
-    EXPECT_EQ(h2->loadState(), BlockState::Used);
+    DeallocateFromOtherThread(p2);
+    DeallocateFromOtherThread(p1);
 
-    ThreadHeap::deallocate(p2);
-    ThreadHeap::deallocate(p1);
-
-    EXPECT_EQ(h1->loadState(), BlockState::Free);
-    EXPECT_EQ(h2->loadState(), BlockState::Free);
+    EXPECT_EQ(ThreadHeap::blockState(p1), BlockState::Free);
+    EXPECT_EQ(ThreadHeap::blockState(p2), BlockState::Free);
 
     std::size_t reclaimed = ThreadHeap::garbageCollect();
     EXPECT_EQ(reclaimed, 2u);
 }
+
+// 大对象路径：超过单个 chunk 的请求也能完整使用，释放后经 GC 归还
+TEST(ThreadHeapTest, LargeObjectSpansMultipleChunks) {
+    constexpr std::size_t req_size = 5 * 1024 * 1024;
+    void* p = ThreadHeap::allocate(req_size);
+    ASSERT_NE(p, nullptr);
+
+    EXPECT_EQ(ThreadHeap::blockState(p), BlockState::Used);
+    EXPECT_GE(ThreadHeap::usableSize(p), req_size);
+    EXPECT_EQ(ThreadHeap::blockStart(static_cast<char*>(p) + 100), p);
+    // 映射后续 chunk 内的内部指针同样能找回块首
+    EXPECT_EQ(ThreadHeap::blockStart(static_cast<char*>(p) + req_size - 1), p);
+    EXPECT_EQ(ThreadHeap::usableSize(static_cast<char*>(p) + req_size - 1),
+              ThreadHeap::usableSize(p) - (req_size - 1));
+
+    // 写满整个请求范围，确认映射足够长
+    auto* bytes = static_cast<unsigned char*>(p);
+    for (std::size_t off = 0; off < req_size; off += 4096) bytes[off] = 0xA5;
+    bytes[req_size - 1] = 0x5A;
+
+    ThreadHeap::deallocate(p);
+    EXPECT_EQ(ThreadHeap::blockState(p), BlockState::Free);
+    EXPECT_EQ(ThreadHeap::garbageCollect(), 1u);
+
+    // 回收后的映射可被同尺寸请求复用
+    void* q = ThreadHeap::allocate(req_size);
+    ASSERT_NE(q, nullptr);
+    ThreadHeap::deallocate(q);
+    EXPECT_EQ(ThreadHeap::garbageCollect(), 1u);
+}
+
+// 中等对象路径：不同尺寸按页取整后共享同一个 chunk，不再各自独占子池
+TEST(ThreadHeapTest, MediumObjectsShareChunks) {
+    constexpr std::size_t kChunk = SizeClassConfig::kChunkSizeBytes;
+    constexpr std::size_t sizes[] = {640 * 1024, 768 * 1024, 96 * 1024};
+
+    void* ptrs[3] = {};
+    for (int i = 0; i < 3; ++i) {
+        ptrs[i] = ThreadHeap::allocate(sizes[i]);
+        ASSERT_NE(ptrs[i], nullptr);
+        EXPECT_EQ(ThreadHeap::blockState(ptrs[i]), BlockState::Used);
+        EXPECT_GE(ThreadHeap::usableSize(ptrs[i]), sizes[i]);
+        EXPECT_LT(ThreadHeap::usableSize(ptrs[i]), sizes[i] + SizeClassConfig::kPageSize);   // 按页取整
+        EXPECT_EQ(ThreadHeap::blockStart(static_cast<char*>(ptrs[i]) + sizes[i] - 1), ptrs[i]);
+
+        auto* bytes = static_cast<unsigned char*>(ptrs[i]);
+        bytes[0] = 0xA5;
+        bytes[sizes[i] - 1] = 0x5A;
+    }
+
+    const auto base = [](void* p) { return reinterpret_cast<std::uintptr_t>(p) & ~(kChunk - 1); };
+    EXPECT_EQ(base(ptrs[0]), base(ptrs[1]));
+    EXPECT_EQ(base(ptrs[0]), base(ptrs[2]));
+
+    for (void* p : ptrs) ThreadHeap::deallocate(p);
+    EXPECT_EQ(ThreadHeap::garbageCollect(), 3u);
+}
+
+// 多个 size-class、多个子池的块混在一起释放：GC 按子池分组批量归还，全部回收
+TEST(ThreadHeapTest, ReclaimsMixedSizeClassesInBatches) {
+    constexpr std::size_t sizes[] = {32, 48, 256, 1000, 4096, 40000};
+    constexpr int kPerSize = 300;   // 超过一批（kReleaseBatchSize）的总量
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < kPerSize; ++i) {
+        for (std::size_t sz : sizes) {
+            void* p = ThreadHeap::allocate(sz);
+            ASSERT_NE(p, nullptr);
+            ptrs.push_back(p);
+        }
+    }
+
+    std::thread([&ptrs] {
+        for (void* p : ptrs) ThreadHeap::deallocate(p);
+    }).join();
+    EXPECT_EQ(ThreadHeap::garbageCollect(), ptrs.size());
+
+    // 回收后的块可以重新分配
+    for (std::size_t sz : sizes) {
+        void* p = ThreadHeap::allocate(sz);
+        ASSERT_NE(p, nullptr);
+        DeallocateFromOtherThread(p);
+    }
+    EXPECT_EQ(ThreadHeap::garbageCollect(), std::size(sizes));
+}
+
+// 块状态在带外记录：跨线程释放不写用户数据，所属线程 GC 时才真正回收
+TEST(ThreadHeapTest, CrossThreadFreeLeavesUserDataIntact) {
+    constexpr std::size_t sizes[] = {48, 100 * 1024, 3 * 1024 * 1024};
+
+    for (std::size_t sz : sizes) {
+        auto* p = static_cast<unsigned char*>(ThreadHeap::allocate(sz));
+        ASSERT_NE(p, nullptr) << "sz=" << sz;
+        EXPECT_EQ(ThreadHeap::usableSize(p), ThreadHeap::usableSize(p + 1) + 1);
+        std::memset(p, 0xAB, 32);
+
+        std::thread([p] { ThreadHeap::deallocate(p); }).join();
+
+        EXPECT_EQ(ThreadHeap::blockState(p), BlockState::Free) << "sz=" << sz;
+        for (int i = 0; i < 32; ++i) ASSERT_EQ(p[i], 0xAB) << "sz=" << sz << " i=" << i;
+        EXPECT_EQ(ThreadHeap::garbageCollect(), 1u) << "sz=" << sz;
+    }
+}
+
+// 线程缓存：同线程释放的块立即可被同尺寸分配复用，不经过 GC；溢出的部分批量交回子池
+TEST(ThreadHeapTest, SameThreadFreeIsServedFromCache) {
+    constexpr std::size_t req_size = 80;
+
+    void* p = ThreadHeap::allocate(req_size);
+    ASSERT_NE(p, nullptr);
+    ThreadHeap::deallocate(p);
+    EXPECT_EQ(ThreadHeap::blockState(p), BlockState::Free);
+    EXPECT_EQ(ThreadHeap::allocate(req_size), p);
+    EXPECT_EQ(ThreadHeap::blockState(p), BlockState::Used);
+
+    // 远超缓存容量的同线程释放：缓存只留下至多 kMaxCapacity 块，其余批量回吐并由 GC 回收
+    std::vector<void*> ptrs{p};
+    for (int i = 0; i < 1000; ++i) {
+        void* q = ThreadHeap::allocate(req_size);
+        ASSERT_NE(q, nullptr);
+        ptrs.push_back(q);
+    }
+    for (void* q : ptrs) ThreadHeap::deallocate(q);
+    // 溢出的块先存入传输缓存（仍记为占用），放不下的才交回子池
+    const std::size_t transfer = CentralHeap::GetInstance().transferCapacity(SizeClassConfig::SizeToClass(req_size));
+    const std::size_t reclaimed = ThreadHeap::garbageCollect();
+    EXPECT_GE(reclaimed, ptrs.size() - BlockCache::kMaxCapacity - transfer);
+    EXPECT_LE(reclaimed, ptrs.size() + BlockCache::kMaxCapacity);
+}
+
+// 自动 GC：分配债务达到阈值时，allocate 内部做一次增量清扫，无需显式调用 garbageCollect
+TEST(ThreadHeapTest, AllocationDebtTriggersCollection) {
+    // 新线程上的 ThreadHeap 是全新的：ManagedList 中只有本用例登记的节点
+    auto run = [](std::size_t debt_bytes, std::size_t debt_blocks) {
+        std::size_t leftover = 0;
+        RunOnFreshThreadHeap([&] {
+            ThreadHeap::setGcDebtThreshold(debt_bytes, debt_blocks);
+            void* p = ThreadHeap::allocate(3 * 1024 * 1024);
+            ThreadHeap::deallocate(p);
+            void* q = ThreadHeap::allocate(3 * 1024 * 1024);
+            leftover = ThreadHeap::garbageCollect();
+            ThreadHeap::deallocate(q);
+            ThreadHeap::garbageCollect();
+        });
+        ThreadHeap::setGcDebtThreshold(ThreadHeap::kDefaultGcDebtBytes, ThreadHeap::kDefaultGcDebtBlocks);
+        return leftover;
+    };
+
+    EXPECT_EQ(run(0, 0), 1u);                  // 不自动触发：释放的大对象留给显式 GC
+    EXPECT_EQ(run(4 * 1024 * 1024, 0), 0u);    // 按字节：第二次分配使债务超过 4 MiB
+    EXPECT_EQ(run(0, 1), 0u);                  // 按块数：一次未回收的释放即触发
+}
+
+// 自动 GC：即将向 CentralHeap 补充子池前总会先清扫一轮
+TEST(ThreadHeapTest, CollectsBeforeRefillingFromCentralHeap) {
+    std::size_t leftover = SIZE_MAX;
+    RunOnFreshThreadHeap([&] {
+        ThreadHeap::setGcDebtThreshold(0, 0);
+        void* medium = ThreadHeap::allocate(100 * 1024);
+        ASSERT_NE(medium, nullptr);
+        ThreadHeap::deallocate(medium);
+
+        // 本线程第一次小对象分配：该 size-class 还没有子池，补充前的清扫回收了中等对象
+        void* small = ThreadHeap::allocate(64);
+        ASSERT_NE(small, nullptr);
+        leftover = ThreadHeap::garbageCollect();
+        ThreadHeap::deallocate(small);
+    });
+    ThreadHeap::setGcDebtThreshold(ThreadHeap::kDefaultGcDebtBytes, ThreadHeap::kDefaultGcDebtBlocks);
+
+    EXPECT_EQ(leftover, 0u);
+}
+
+// 增量清扫：游标跨调用保留，小预算的多次调用能覆盖整张表，并报告进度
+TEST(ThreadHeapTest, SmallBudgetSweepsResumeAcrossCalls) {
+    RunOnFreshThreadHeap([] {
+        ThreadHeap::setGcDebtThreshold(0, 0);
+
+        // 新线程：ManagedList 中只有这 20 个中等对象，奇数位置的被释放
+        std::vector<void*> objs;
+        for (int i = 0; i < 20; ++i) objs.push_back(ThreadHeap::allocate(100 * 1024));
+        for (int i = 1; i < 20; i += 2) ThreadHeap::deallocate(objs[i]);
+
+        const std::uint64_t epoch0 = ThreadHeap::sweepProgress().epoch;
+        EXPECT_EQ(ThreadHeap::garbageCollect(4), 2u);
+        ThreadHeap::SweepProgress p = ThreadHeap::sweepProgress();
+        EXPECT_EQ(p.epoch, epoch0);
+        EXPECT_EQ(p.visited, 4u);
+        EXPECT_EQ(p.reclaimed, 2u);
+        EXPECT_EQ(p.list_size, 18u);
+        EXPECT_DOUBLE_EQ(p.percent, 20.0);
+
+        std::size_t total = 2;
+        for (int call = 0; call < 4; ++call) total += ThreadHeap::garbageCollect(4);
+        EXPECT_EQ(total, 10u);   // 表尾的块同样被回收，而不是只清扫表头
+
+        EXPECT_EQ(ThreadHeap::garbageCollect(4), 0u);   // 走到表尾，一轮完成
+        p = ThreadHeap::sweepProgress();
+        EXPECT_EQ(p.epoch, epoch0 + 1);
+        EXPECT_EQ(p.reclaimed, 10u);
+        EXPECT_DOUBLE_EQ(p.percent, 100.0);
+
+        for (int i = 0; i < 20; i += 2) ThreadHeap::deallocate(objs[i]);
+        EXPECT_EQ(ThreadHeap::garbageCollect(), 10u);
+    });
+    ThreadHeap::setGcDebtThreshold(ThreadHeap::kDefaultGcDebtBytes, ThreadHeap::kDefaultGcDebtBlocks);
+}
+
+// 限时清扫：预算耗尽即返回部分结果；访问数另有上限；时间充足时走完一轮
+TEST(ThreadHeapTest, GarbageCollectForHonoursDeadlineAndVisitBound) {
+    using namespace std::chrono_literals;
+
+    RunOnFreshThreadHeap([] {
+        ThreadHeap::setGcDebtThreshold(0, 0);
+
+        std::vector<void*> objs;
+        for (int i = 0; i < 12; ++i) objs.push_back(ThreadHeap::allocate(100 * 1024));
+        for (void* p : objs) ThreadHeap::deallocate(p);
+
+        ThreadHeap::GcSlice s = ThreadHeap::garbageCollectFor(0ns);
+        EXPECT_EQ(s.visited, 0u);
+        EXPECT_EQ(s.reclaimed, 0u);
+
+        s = ThreadHeap::garbageCollectFor(1s, 5);
+        EXPECT_EQ(s.visited, 5u);
+        EXPECT_EQ(s.reclaimed, 5u);
+        EXPECT_FALSE(s.pass_completed);
+
+        s = ThreadHeap::garbageCollectFor(1s);
+        EXPECT_EQ(s.visited, 7u);
+        EXPECT_EQ(s.reclaimed, 7u);
+        EXPECT_TRUE(s.pass_completed);
+    });
+    ThreadHeap::setGcDebtThreshold(ThreadHeap::kDefaultGcDebtBytes, ThreadHeap::kDefaultGcDebtBlocks);
+}
+
+TEST(ThreadHeapTest, ParallelCollectMatchesSerialSweep) {
+    RunOnFreshThreadHeap([] {
+        ThreadHeap::setGcDebtThreshold(0, 0);
+
+        // 中等对象每个占一个节点：凑够并行清扫的最小表长
+        const std::size_t n = ThreadHeap::kParallelSweepMinNodes + 500;
+        std::vector<void*> objs;
+        for (std::size_t i = 0; i < n; ++i) objs.push_back(ThreadHeap::allocate(65 * 1024));
+        const std::size_t tracked = ThreadHeap::sweepProgress().list_size;
+        ASSERT_GE(tracked, n);
+
+        // 先走半轮增量清扫：并行清扫应把进行中的一轮并入
+        for (std::size_t i = 0; i < n; i += 3) ThreadHeap::deallocate(objs[i]);
+        const std::size_t freed = (n + 2) / 3;
+        std::size_t reclaimed = ThreadHeap::garbageCollect(n / 2);
+        reclaimed += ThreadHeap::garbageCollectParallel(4);
+        EXPECT_EQ(reclaimed, freed);
+        EXPECT_EQ(ThreadHeap::sweepProgress().list_size, tracked - freed);
+        EXPECT_EQ(ThreadHeap::sweepProgress().percent, 100.0);
+        EXPECT_EQ(ThreadHeap::garbageCollect(), 0u);
+
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i % 3 != 0) ThreadHeap::deallocate(objs[i]);
+        }
+        EXPECT_EQ(ThreadHeap::garbageCollectParallel(4), n - freed);
+        EXPECT_EQ(ThreadHeap::sweepProgress().list_size, tracked - n);
+    });
+    ThreadHeap::setGcDebtThreshold(ThreadHeap::kDefaultGcDebtBytes, ThreadHeap::kDefaultGcDebtBlocks);
+}
+
+// 清扫期间持续有远端释放：重新挂回的子池留给下一轮，一轮的访问数不超过开始时的表长，完整回收总能结束
+TEST(ThreadHeapTest, FullCollectFinishesUnderConcurrentRemoteFrees) {
+    using namespace std::chrono_literals;
+
+    RunOnFreshThreadHeap([] {
+        ThreadHeap::setGcDebtThreshold(SIZE_MAX, SIZE_MAX);
+
+        // 几个 size-class 各占一个子池，远端线程轮流释放，每个子池的节点都不断被置回 Free
+        const std::size_t sizes[] = {16, 48, 96, 160, 256, 512};
+        constexpr std::size_t kPerClass = 3000;
+        std::vector<void*> objs;
+        for (std::size_t i = 0; i < kPerClass; ++i) {
+            for (std::size_t size : sizes) objs.push_back(ThreadHeap::allocate(size));
+        }
+        ASSERT_EQ(ThreadHeap::garbageCollect(), 0u);
+        const std::size_t tracked = ThreadHeap::sweepProgress().list_size;
+
+        std::atomic<bool> started{false};
+        std::atomic<bool> done{false};
+        std::thread producer([&] {
+            for (std::size_t i = 0; i < objs.size() && !done.load(); ++i) {
+                ThreadHeap::deallocate(objs[i]);
+                started.store(true);
+                if (i % 8 == 7) std::this_thread::yield();   // 让释放与清扫交错
+            }
+        });
+        while (!started.load()) std::this_thread::yield();
+
+        for (int round = 0; round < 20; ++round) {
+            const ThreadHeap::GcSlice s = ThreadHeap::garbageCollectFor(1h);
+            EXPECT_TRUE(s.pass_completed);
+            EXPECT_LE(s.visited, tracked);
+            ThreadHeap::garbageCollect();
+        }
+        done.store(true);
+        producer.join();
+
+        ThreadHeap::garbageCollect();
+        ThreadHeap::garbageCollect();   // 上一轮挂回的子池在这一轮被处理
+        EXPECT_EQ(ThreadHeap::garbageCollect(), 0u);
+    });
+    ThreadHeap::setGcDebtThreshold(ThreadHeap::kDefaultGcDebtBytes, ThreadHeap::kDefaultGcDebtBlocks);
+}
+
+TEST(ThreadHeapTest, ExitedThreadPoolsAreAdoptedOnRefill) {
+    ThreadHeap::setRetiredHeapLimit(0);   // 不回收实例：退出线程的子池进入孤儿队列
+    // 一个不常用的 size-class：孤儿队列后进先出，刚退出线程的子池最先被认领
+    const std::size_t size = 27 * 1024;
+    const auto poolBase = [](const void* p) {
+        return reinterpret_cast<std::uintptr_t>(p) & ~(std::uintptr_t{SizeClassConfig::kChunkSizeBytes} - 1);
+    };
+
+    std::vector<void*> live;
+    std::thread([&] {
+        for (int i = 0; i < 8; ++i) live.push_back(ThreadHeap::allocate(size));
+    }).join();
+
+    // 所属线程已退出：子池不再有所属 ThreadHeap，释放只登记为释放请求
+    EXPECT_EQ(PageMap::GetInstance().lookup(live[0]).owner, nullptr);
+    for (std::size_t i = 0; i < 4; ++i) ThreadHeap::deallocate(live[i]);
+
+    std::thread([&] {
+        // 新线程第一次补充该 size-class 时认领孤儿子池，而不是向 CentralHeap 要新 chunk
+        void* p = ThreadHeap::allocate(size);
+        ASSERT_NE(p, nullptr);
+        EXPECT_EQ(poolBase(p), poolBase(live[0]));
+        EXPECT_NE(PageMap::GetInstance().lookup(live[0]).owner, nullptr);
+        ThreadHeap::deallocate(p);
+        for (std::size_t i = 4; i < live.size(); ++i) ThreadHeap::deallocate(live[i]);
+    }).join();
+    ThreadHeap::setRetiredHeapLimit(ThreadHeap::kDefaultRetiredHeapLimit);
+}
+
+TEST(ThreadHeapTest, ExitedThreadLargeObjectsAreAdopted) {
+    ThreadHeap::setRetiredHeapLimit(0);
+    const std::size_t size = 3 * SizeClassConfig::kChunkSizeBytes;
+
+    void* big = nullptr;
+    std::thread([&] { big = ThreadHeap::allocate(size); }).join();
+    ASSERT_NE(big, nullptr);
+    EXPECT_EQ(PageMap::GetInstance().lookup(big).owner, nullptr);
+
+    std::thread([&] {
+        ThreadHeap::setGcDebtThreshold(0, 0);
+        // 首次补充子池前的自动清扫顺带认领孤儿块：仍在用的挂入本线程的表
+        ThreadHeap::deallocate(ThreadHeap::allocate(16));
+        EXPECT_NE(PageMap::GetInstance().lookup(big).owner, nullptr);
+
+        ThreadHeap::deallocate(big);
+        EXPECT_GE(ThreadHeap::garbageCollect(), 1u);
+        EXPECT_EQ(PageMap::GetInstance().lookup(big).kind, ChunkKind::kNone);
+    }).join();
+    ThreadHeap::setGcDebtThreshold(ThreadHeap::kDefaultGcDebtBytes, ThreadHeap::kDefaultGcDebtBlocks);
+    ThreadHeap::setRetiredHeapLimit(ThreadHeap::kDefaultRetiredHeapLimit);
+}
+
+TEST(ThreadHeapTest, ExitedThreadHeapIsTakenOverByNextThread) {
+    const std::size_t size = 29 * 1024;
+
+    void* live = nullptr;
+    ThreadHeap* first_owner = nullptr;
+    std::thread([&] {
+        live = ThreadHeap::allocate(size);
+        first_owner = PageMap::GetInstance().lookup(live).owner;
+    }).join();
+    ASSERT_NE(first_owner, nullptr);
+    // 实例退役而不是析构：子池仍归它所有
+    EXPECT_EQ(PageMap::GetInstance().lookup(live).owner, first_owner);
+
+    std::thread([&] {
+        // 新线程接管同一个实例：第一次分配直接命中热的子池与线程缓存
+        void* p = ThreadHeap::allocate(size);
+        ASSERT_NE(p, nullptr);
+        EXPECT_EQ(PageMap::GetInstance().lookup(p).owner, first_owner);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) >> 21, reinterpret_cast<std::uintptr_t>(live) >> 21);
+
+        // 接管后子池归本线程所有：释放走线程缓存，清扫可以正常进行
+        ThreadHeap::deallocate(p);
+        ThreadHeap::deallocate(live);
+        ThreadHeap::garbageCollect();
+    }).join();
+
+    // 空闲表调为 0：退役实例被析构，子池交回 CentralHeap 或孤儿队列
+    ThreadHeap::setRetiredHeapLimit(0);
+    EXPECT_NE(PageMap::GetInstance().lookup(live).owner, first_owner);
+    ThreadHeap::setRetiredHeapLimit(ThreadHeap::kDefaultRetiredHeapLimit);
+}
+
+// 退役前收尾：已释放的中等对象就地回收，线程缓存里的块交给传输缓存，不随实例一起被扣住
+TEST(ThreadHeapTest, RetiredHeapDoesNotPinFreedMemory) {
+    const std::size_t small = 1800;
+    const std::size_t class_idx = SizeClassConfig::SizeToClass(small);
+    CentralHeap& central = CentralHeap::GetInstance();
+    const std::size_t transfer_before = central.transferBlockCount(class_idx);
+
+    void* medium = nullptr;
+    void* live = nullptr;
+    ThreadHeap* owner = nullptr;
+    std::thread([&] {
+        live = ThreadHeap::allocate(small);
+        owner = PageMap::GetInstance().lookup(live).owner;
+
+        medium = ThreadHeap::allocate(100 * 1024);
+        ASSERT_NE(medium, nullptr);
+        ThreadHeap::deallocate(medium);
+        EXPECT_NE(ThreadHeap::blockStart(medium), nullptr);   // 只是标记为空闲，等待清扫
+
+        ThreadHeap::deallocate(ThreadHeap::allocate(small));  // 留在线程缓存
+    }).join();
+    ASSERT_NE(owner, nullptr);
+
+    // 实例已退役（子池仍归它所有），但中等对象的页段已交还，缓存中的块已进入传输缓存
+    EXPECT_EQ(PageMap::GetInstance().lookup(live).owner, owner);
+    EXPECT_EQ(ThreadHeap::blockStart(medium), nullptr);
+    EXPECT_GT(central.transferBlockCount(class_idx), transfer_before);
+
+    std::thread([&] {
+        ThreadHeap::deallocate(live);
+        ThreadHeap::garbageCollect();
+    }).join();
+}
+
+// 传输缓存：一个线程释放溢出的块，另一个线程补货时整批取走，不必向 CentralHeap 要新 chunk
+TEST(ThreadHeapTest, BlocksSpilledByOneThreadServeAnother) {
+    const std::size_t size = 3000;
+    const std::size_t class_idx = SizeClassConfig::SizeToClass(size);
+    CentralHeap& central = CentralHeap::GetInstance();
+
+    // 本线程释放自己的块：线程缓存溢出的部分进入传输缓存
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 200; ++i) ptrs.push_back(ThreadHeap::allocate(size));
+    ThreadHeap* const owner = PageMap::GetInstance().lookup(ptrs[0]).owner;
+    for (void* p : ptrs) ThreadHeap::deallocate(p);
+    const std::size_t spilled = central.transferBlockCount(class_idx);
+    ASSERT_GT(spilled, 0u);
+    EXPECT_LE(spilled, central.transferCapacity(class_idx));
+
+    RunOnFreshThreadHeap([&] {
+        // 新线程第一次分配该 size-class：取到的是传输缓存里的块，子池仍归原线程所有
+        void* p = ThreadHeap::allocate(size);
+        ASSERT_NE(p, nullptr);
+        EXPECT_EQ(PageMap::GetInstance().lookup(p).owner, owner);
+        EXPECT_LT(central.transferBlockCount(class_idx), spilled);
+        ThreadHeap::deallocate(p);   // 跨线程释放：登记释放请求，由所属线程回收
+    });
+    EXPECT_GE(ThreadHeap::garbageCollect(), 1u);
+}
+
+// 已格式化子池：线程退出时交还的空子池保持构造状态，同 size-class 的下一次补充直接取回
+// 页是否驻留；已解除映射（mincore 失败）也算不驻留
+static bool PageResident(const void* addr) {
+    const std::uintptr_t page = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+    unsigned char vec = 0;
+    void* base = reinterpret_cast<void*>(reinterpret_cast<std::uintptr_t>(addr) & ~(page - 1));
+    return mincore(base, page, &vec) == 0 && (vec & 1) != 0;
+}
+
+TEST(ThreadHeapTest, IdleThreadReleasesEmptyPools) {
+    CentralHeap& central = CentralHeap::GetInstance();
+    const std::size_t size = 48 * 1024;
+
+    RunOnFreshThreadHeap([&] {
+        // 用满几个子池并写入每个块，再由其他线程全部释放、本线程回收：子池全空，留在 empty_ 里
+        std::vector<void*> blocks;
+        for (int i = 0; i < 120; ++i) {
+            void* p = ThreadHeap::allocate(size);
+            ASSERT_NE(p, nullptr);
+            std::memset(p, 0x5a, size);
+            blocks.push_back(p);
+        }
+        std::thread([&] {
+            for (void* p : blocks) ThreadHeap::deallocate(p);
+        }).join();
+        ThreadHeap::garbageCollect();
+
+        std::size_t resident_before = 0;
+        for (void* p : blocks) resident_before += PageResident(p) ? 1 : 0;
+        ASSERT_GT(resident_before, blocks.size() / 2);
+
+        // 之后本线程不再分配：过了 dirty 衰减时间的 GC 把空子池交出，随后的衰减交还物理页
+        central.setDecayTimes(std::chrono::milliseconds{0}, std::chrono::milliseconds{0});
+        for (int round = 0; round < 3; ++round) {
+            ThreadHeap::garbageCollect();
+            central.purgeDecayed();
+        }
+        central.setDecayTimes(CentralHeap::kDefaultDirtyDecay, CentralHeap::kDefaultMuzzyDecay);
+
+        std::size_t resident_after = 0;
+        for (void* p : blocks) resident_after += PageResident(p) ? 1 : 0;
+        EXPECT_LT(resident_after, resident_before / 4);
+    });
+}
+
+TEST(ThreadHeapTest, ReturnedEmptyPoolIsReusedWithoutReformatting) {
+    const std::size_t size = 56 * 1024;
+    const auto poolBase = [](const void* p) {
+        return reinterpret_cast<std::uintptr_t>(p) & ~(std::uintptr_t{SizeClassConfig::kChunkSizeBytes} - 1);
+    };
+
+    // 实例随线程退出析构：全部释放后子池已空，经归还回调交给 CentralHeap 暂存
+    void* pool = nullptr;
+    RunOnFreshThreadHeap([&] {
+        void* p = ThreadHeap::allocate(size);
+        ASSERT_NE(p, nullptr);
+        pool = reinterpret_cast<void*>(poolBase(p));
+        ThreadHeap::deallocate(p);
+    });
+    ASSERT_NE(pool, nullptr);
+    // 仍登记为子池，只是没有所属者
+    EXPECT_EQ(PageMap::GetInstance().lookup(pool).kind, ChunkKind::kSmallPool);
+    EXPECT_EQ(PageMap::GetInstance().lookup(pool).owner, nullptr);
+    EXPECT_TRUE(MemSubPool::isPoolHeader(pool));
+
+    RunOnFreshThreadHeap([&] {
+        void* p = ThreadHeap::allocate(size);
+        ASSERT_NE(p, nullptr);
+        // 补充到的子池之一就是刚才交还的那个，已归本线程所有
+        EXPECT_EQ(PageMap::GetInstance().lookup(pool).owner, PageMap::GetInstance().lookup(p).owner);
+        ThreadHeap::deallocate(p);
+    });
+}
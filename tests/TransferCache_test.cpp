@@ -0,0 +1,106 @@
+#include "gtest/gtest.h"
+#include "gc_malloc/CentralHeap/TransferCache.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// 只保存指针：用假地址即可，不会真的访问这些内存
+static void* FakeBlock(std::uintptr_t n) {
+    return reinterpret_cast<void*>(n << 6);
+}
+
+TEST(TransferCacheTest, InitialStateIsEmpty) {
+    TransferCache cache;
+    void* out[4];
+    EXPECT_EQ(cache.getCount(), 0u);
+    EXPECT_EQ(cache.getCapacity(), 0u);
+    EXPECT_EQ(cache.remove(out, 4), 0u);
+
+    // 未设置容量时不接收任何块
+    void* blocks[] = {FakeBlock(1)};
+    EXPECT_EQ(cache.insert(blocks, 1), 0u);
+}
+
+TEST(TransferCacheTest, InsertAcceptsPrefixUpToCapacity) {
+    TransferCache cache;
+    cache.setCapacity(5);
+
+    void* blocks[4] = {FakeBlock(1), FakeBlock(2), FakeBlock(3), FakeBlock(4)};
+    EXPECT_EQ(cache.insert(blocks, 4), 4u);
+
+    // 只剩一个空位：接收的是前缀
+    void* more[3] = {FakeBlock(5), FakeBlock(6), FakeBlock(7)};
+    EXPECT_EQ(cache.insert(more, 3), 1u);
+    EXPECT_EQ(cache.getCount(), 5u);
+    EXPECT_EQ(cache.insert(more + 1, 2), 0u);
+
+    // 后进先出：最近存入的先被取走
+    void* out[8] = {};
+    ASSERT_EQ(cache.remove(out, 2), 2u);
+    EXPECT_EQ(out[0], FakeBlock(4));
+    EXPECT_EQ(out[1], FakeBlock(5));
+
+    ASSERT_EQ(cache.remove(out, 8), 3u);
+    EXPECT_EQ(out[0], FakeBlock(1));
+    EXPECT_EQ(out[2], FakeBlock(3));
+    EXPECT_EQ(cache.getCount(), 0u);
+}
+
+TEST(TransferCacheTest, CapacityIsClampedToSlotCount) {
+    TransferCache cache;
+    cache.setCapacity(TransferCache::kMaxBlocks * 4);
+    EXPECT_EQ(cache.getCapacity(), TransferCache::kMaxBlocks);
+
+    std::vector<void*> blocks;
+    for (std::uintptr_t i = 1; i <= TransferCache::kMaxBlocks + 10; ++i) blocks.push_back(FakeBlock(i));
+    EXPECT_EQ(cache.insert(blocks.data(), blocks.size()), TransferCache::kMaxBlocks);
+}
+
+// 一端只存、一端只取：块既不丢失也不重复
+TEST(TransferCacheTest, ConcurrentProducerConsumerConservesBlocks) {
+    constexpr std::uintptr_t kBlocks = 20000;
+    constexpr std::size_t kBatch = 16;
+
+    TransferCache cache;
+    cache.setCapacity(64);
+
+    std::atomic<bool> done{false};
+    std::vector<std::uint8_t> seen(kBlocks + 1, 0);
+    std::size_t received = 0;
+
+    std::thread consumer([&] {
+        void* out[kBatch];
+        for (;;) {
+            const bool finished = done.load(std::memory_order_acquire);
+            const std::size_t n = cache.remove(out, kBatch);
+            for (std::size_t i = 0; i < n; ++i) {
+                ++seen[reinterpret_cast<std::uintptr_t>(out[i]) >> 6];
+            }
+            received += n;
+            if (n == 0) {
+                if (finished) break;
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::uintptr_t next = 1;
+    while (next <= kBlocks) {
+        void* batch[kBatch];
+        std::size_t n = 0;
+        while (n < kBatch && next + n <= kBlocks) {
+            batch[n] = FakeBlock(next + n);
+            ++n;
+        }
+        const std::size_t k = cache.insert(batch, n);   // 满了就重试剩下的
+        if (k == 0) std::this_thread::yield();
+        next += k;
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    EXPECT_EQ(received, kBlocks);
+    for (std::uintptr_t i = 1; i <= kBlocks; ++i) ASSERT_EQ(seen[i], 1u) << "block " << i;
+}